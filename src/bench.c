@@ -0,0 +1,682 @@
+/*
+ *    bench.c  --  Modem realtime benchmark
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include <gtk/gtk.h>
+
+#include "trx.h"
+#include "headless.h"
+#include "mac.h"
+#include "cvec.h"
+#include "viterbi.h"
+
+/*
+ * Every benchmark runs the modem transmitter into a buffer, adds
+ * noise from a fixed seed and then times the receiver on that
+ * buffer. The signal is the same on every run and every machine, so
+ * the numbers can be compared against a saved baseline. Each modem
+ * runs in a child process of its own so that the peak RSS reported is
+ * that of the modem alone.
+ *
+ * The Viterbi cases decode 16 streams of the MFSK code, either with 16
+ * decoders or through one bank. There a sample is one symbol pair of
+ * one stream and realtime is in MFSK16 decoders.
+ */
+
+#define	BLOCKLEN	512
+
+#define	BENCH_TEXT	"CQ CQ CQ DE OH2BNS OH2BNS PSE K\r\n" \
+			"THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 0123456789\r\n"
+
+#define	BENCH_SNR	20.0	/* dB, over the full audio bandwidth */
+#define	BENCH_MAXLEN	(8000 * 600)
+
+struct result;
+
+struct bench {
+	const gchar *name;
+	trx_mode_t mode;
+	gint parm1;		/* Olivia tones, MT63 bandwidth or bank */
+	gint parm2;		/* Olivia bandwidth */
+	gint repeat;		/* times to send the text */
+	void (*run) (struct bench *b, struct result *r);
+};
+
+static void run_viterbi(struct bench *b, struct result *r);
+
+static struct bench benches[] = {
+	{ "MFSK16",		MODE_MFSK16,	0, 0, 1 },
+	{ "MFSK8",		MODE_MFSK8,	0, 0, 1 },
+	{ "OLIVIA-8/250",	MODE_OLIVIA,	1, 1, 1 },
+	{ "OLIVIA-16/500",	MODE_OLIVIA,	2, 2, 1 },
+	{ "OLIVIA-32/1000",	MODE_OLIVIA,	3, 3, 1 },
+	{ "OLIVIA-64/2000",	MODE_OLIVIA,	4, 4, 1 },
+	{ "RTTY",		MODE_RTTY,	0, 0, 1 },
+	{ "THROB1",		MODE_THROB1,	0, 0, 1 },
+	{ "THROB2",		MODE_THROB2,	0, 0, 1 },
+	{ "THROB4",		MODE_THROB4,	0, 0, 1 },
+	{ "BPSK31",		MODE_BPSK31,	0, 0, 1 },
+	{ "QPSK31",		MODE_QPSK31,	0, 0, 1 },
+	{ "PSK63",		MODE_PSK63,	0, 0, 1 },
+	{ "MT63-500",		MODE_MT63,	0, 0, 8 },
+	{ "MT63-1000",		MODE_MT63,	1, 0, 8 },
+	{ "MT63-2000",		MODE_MT63,	2, 0, 8 },
+	{ "FELDHELL",		MODE_FELDHELL,	0, 0, 1 },
+	{ "FMHELL",		MODE_FMHELL,	0, 0, 1 },
+	{ "CW",			MODE_CW,	0, 0, 1 },
+	{ "VITERBI",		MODE_MFSK16,	0, 0, 8, run_viterbi },
+	{ "VITERBI-BANK",	MODE_MFSK16,	1, 0, 8, run_viterbi }
+};
+
+#define	NUM_BENCHES	(sizeof(benches) / sizeof(benches[0]))
+
+struct result {
+	gint ok;
+	gdouble audiosecs;	/* length of the test signal */
+	gdouble rxrate;		/* receiver samples per CPU second */
+	gdouble rxfactor;	/* receiver realtime factor */
+	gdouble txfactor;	/* transmitter realtime factor */
+	glong peakrss;		/* kB */
+	glong chars;		/* characters decoded on the first pass */
+};
+
+static gdouble mintime = 2.0;
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Small deterministic gaussian noise source, independent of the libc.
+ */
+static guint32 noise_seed;
+
+static gdouble uniform(void)
+{
+	noise_seed = noise_seed * 1664525 + 1013904223;
+	return (noise_seed + 1.0) / 4294967297.0;
+}
+
+static gdouble gauss(void)
+{
+	gdouble u = uniform();
+	gdouble v = uniform();
+
+	return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static gdouble cputime(void)
+{
+	struct rusage ru;
+
+	getrusage(RUSAGE_SELF, &ru);
+
+	return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 +
+	       ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+}
+
+static glong peakrss(void)
+{
+	struct rusage ru;
+
+	getrusage(RUSAGE_SELF, &ru);
+
+	return ru.ru_maxrss;
+}
+
+/* ---------------------------------------------------------------------- */
+
+static void run_bench(struct bench *b, struct result *r)
+{
+	struct headless h;
+	struct trx t;
+	FILE *fp;
+	GArray *sig;
+	GString *text;
+	gfloat zero[BLOCKLEN];
+	gfloat *buf;
+	gdouble t0, tx, rx, rms, sigma;
+	glong len, pos, done;
+	gint i, n, passes;
+
+	memset(r, 0, sizeof(struct result));
+
+	if (b->mode == MODE_FELDHELL || b->mode == MODE_FMHELL) {
+		/* the Hell modems render their font with GDK */
+		if (!gtk_init_check(NULL, NULL))
+			return;
+	}
+
+	trx_modem_defaults(&t, b->mode);
+
+	switch (b->mode) {
+	case MODE_OLIVIA:
+		t.olivia_tones = b->parm1;
+		t.olivia_bw = b->parm2;
+		break;
+	case MODE_MT63:
+		t.mt63_bandwidth = b->parm1;
+		break;
+	case MODE_FELDHELL:
+	case MODE_FMHELL:
+		t.hell_font = "FeldNarr 14";
+		break;
+	default:
+		break;
+	}
+
+	if ((fp = fopen("/dev/null", "w")) == NULL)
+		return;
+
+	sig = g_array_new(FALSE, FALSE, sizeof(gfloat));
+
+	headless_init(&h, &t, fp, 1.0);
+	headless_set_current(&h);
+
+	if (trx_modem_init(&t) < 0) {
+		headless_set_current(NULL);
+		headless_free(&h);
+		fclose(fp);
+		return;
+	}
+
+	/* half a second of silence on both sides of the transmission */
+	memset(zero, 0, sizeof(zero));
+
+	for (i = 0; i < t.samplerate / 2; i += BLOCKLEN)
+		g_array_append_vals(sig, zero, BLOCKLEN);
+
+	text = g_string_new(NULL);
+
+	for (i = 0; i < b->repeat; i++)
+		g_string_append(text, BENCH_TEXT);
+
+	h.txptr = text->str;
+	h.txbuf = sig;
+
+	t.state = TRX_STATE_TX;
+	t.txinit(&t);
+
+	t0 = cputime();
+
+	while (t.txprocess(&t) >= 0 && sig->len < BENCH_MAXLEN)
+		;
+
+	tx = cputime() - t0;
+
+	h.txptr = NULL;
+	h.txbuf = NULL;
+
+	g_string_free(text, TRUE);
+
+	for (i = 0; i < t.samplerate / 2; i += BLOCKLEN)
+		g_array_append_vals(sig, zero, BLOCKLEN);
+
+	len = sig->len;
+	buf = (gfloat *) sig->data;
+
+	for (rms = 0.0, i = 0; i < len; i++)
+		rms += buf[i] * buf[i];
+
+	rms = sqrt(rms / len);
+	sigma = rms * pow(10.0, -BENCH_SNR / 20.0);
+
+	noise_seed = 1;
+
+	for (i = 0; i < len; i++)
+		buf[i] += sigma * gauss();
+
+	/* now time the receiver, repeating the signal if it is short */
+	t.state = TRX_STATE_RX;
+	t.stopflag = 0;
+	t.rxinit(&t);
+
+	done = 0;
+	passes = 0;
+
+	t0 = cputime();
+
+	do {
+		for (pos = 0; pos < len; pos += n) {
+			n = MIN(BLOCKLEN, len - pos);
+			h.offset = done + pos;
+			t.rxprocess(&t, buf + pos, n);
+		}
+
+		if (passes++ == 0) {
+			headless_flush(&h);
+			r->chars = h.chars;
+		}
+
+		done += len;
+		rx = cputime() - t0;
+	} while (rx < mintime);
+
+	r->ok = 1;
+	r->audiosecs = (gdouble) len / t.samplerate;
+	r->rxrate = rx > 0 ? done / rx : 0.0;
+	r->rxfactor = r->rxrate / t.samplerate;
+	r->txfactor = tx > 0 ? (r->audiosecs - 1.0) / tx : 0.0;
+	r->peakrss = peakrss();
+
+	headless_set_current(NULL);
+	headless_free(&h);
+	fclose(fp);
+
+	t.destructor(&t);
+	g_array_free(sig, TRUE);
+}
+
+/* ---------------------------------------------------------------------- */
+
+#define	VIT_K		7
+#define	VIT_POLY1	0x6d
+#define	VIT_POLY2	0x4f
+#define	VIT_STREAMS	VITERBI_BANK_STREAMS
+#define	VIT_RATE	31.25	/* MFSK16 symbol pairs per second */
+#define	VIT_METSWITCH	100	/* steps between metric on and off */
+
+/*
+ * Step every stream once, asking for the metric or not. Returns the
+ * number of characters decoded.
+ */
+static gint viterbi_step(struct viterbi **v, struct viterbi_bank *bank,
+			 guchar (*sym)[2], gint *out, gint *metric)
+{
+	gint i, n = 0;
+
+	if (bank)
+		viterbi_bank_decode(bank, (1U << VIT_STREAMS) - 1,
+				    sym, out, metric);
+	else
+		for (i = 0; i < VIT_STREAMS; i++)
+			out[i] = viterbi_decode(v[i], sym[i],
+						metric ? &metric[i] : NULL);
+
+	for (i = 0; i < VIT_STREAMS; i++)
+		if (out[i] >= 0)
+			n++;
+
+	return n;
+}
+
+/*
+ * Check the bank against single decoders, switching between asking
+ * for the metric and not on the way.
+ */
+static gboolean viterbi_check(struct viterbi **v, struct viterbi_bank *bank,
+			      guchar (*syms)[VIT_STREAMS][2], glong len)
+{
+	struct viterbi *ref[VIT_STREAMS];
+	gint out[VIT_STREAMS], refout[VIT_STREAMS];
+	gint met[VIT_STREAMS], refmet[VIT_STREAMS];
+	gboolean ok = TRUE;
+	gint *mp;
+	glong i;
+	gint j;
+
+	for (j = 0; j < VIT_STREAMS; j++)
+		ref[j] = viterbi_init(VIT_K, VIT_POLY1, VIT_POLY2);
+
+	for (i = 0; i < len && ok; i++) {
+		mp = ((i / VIT_METSWITCH) & 1) ? met : NULL;
+
+		viterbi_step(v, bank, syms[i], out, mp);
+		viterbi_step(ref, NULL, syms[i], refout, mp ? refmet : NULL);
+
+		for (j = 0; j < VIT_STREAMS; j++) {
+			if (out[j] != refout[j] ||
+			    (mp && out[j] >= 0 && met[j] != refmet[j])) {
+				fprintf(stderr, "viterbi bank: stream %d "
+					"differs at step %ld\n", j, i);
+				ok = FALSE;
+			}
+		}
+	}
+
+	for (j = 0; j < VIT_STREAMS; j++) {
+		viterbi_free(ref[j]);
+		viterbi_bank_reset(bank, j);
+	}
+
+	return ok;
+}
+
+static void run_viterbi(struct bench *b, struct result *r)
+{
+	struct viterbi *v[VIT_STREAMS];
+	struct viterbi_bank *bank = NULL;
+	struct encoder *enc;
+	guchar (*syms)[VIT_STREAMS][2];
+	gint out[VIT_STREAMS], metric[VIT_STREAMS];
+	GString *text;
+	gdouble t0, rx, x;
+	glong len, done, i;
+	gint j, k, c, bit, passes;
+
+	memset(r, 0, sizeof(struct result));
+
+	text = g_string_new(NULL);
+
+	for (i = 0; i < b->repeat; i++)
+		g_string_append(text, BENCH_TEXT);
+
+	len = 8 * text->len;
+	syms = g_malloc(len * sizeof(*syms));
+
+	/* every stream sends the text with noise of its own */
+	noise_seed = 1;
+
+	for (j = 0; j < VIT_STREAMS; j++) {
+		enc = encoder_init(VIT_K, VIT_POLY1, VIT_POLY2);
+
+		for (i = 0; i < len; i++) {
+			bit = (text->str[i / 8] >> (7 - i % 8)) & 1;
+			c = encoder_encode(enc, bit);
+
+			for (k = 0; k < 2; k++) {
+				x = 128.0 + (((c >> k) & 1) ? 80.0 : -80.0) +
+				    60.0 * gauss();
+
+				syms[i][j][k] = CLAMP(x, 0.0, 255.0);
+			}
+		}
+
+		encoder_free(enc);
+	}
+
+	g_string_free(text, TRUE);
+
+	for (j = 0; j < VIT_STREAMS; j++)
+		v[j] = viterbi_init(VIT_K, VIT_POLY1, VIT_POLY2);
+
+	if (b->parm1) {
+		bank = viterbi_bank_init(VIT_K, VIT_POLY1, VIT_POLY2);
+
+		for (j = 0; j < VIT_STREAMS; j++)
+			viterbi_bank_add(bank, v[j]);
+
+		if (!viterbi_check(v, bank, syms, len))
+			goto out;
+	}
+
+	done = 0;
+	passes = 0;
+
+	t0 = cputime();
+
+	do {
+		for (i = 0; i < len; i++) {
+			c = viterbi_step(v, bank, syms[i], out,
+					 ((i / VIT_METSWITCH) & 1) ? metric : NULL);
+
+			if (passes == 0)
+				r->chars += c;
+		}
+
+		for (j = 0; j < VIT_STREAMS; j++) {
+			if (bank)
+				viterbi_bank_reset(bank, j);
+			else
+				viterbi_reset(v[j]);
+		}
+
+		passes++;
+		done += len * VIT_STREAMS;
+		rx = cputime() - t0;
+	} while (rx < mintime);
+
+	r->ok = 1;
+	r->audiosecs = len / VIT_RATE;
+	r->rxrate = rx > 0 ? done / rx : 0.0;
+	r->rxfactor = r->rxrate / VIT_RATE;
+	r->peakrss = peakrss();
+
+out:
+	viterbi_bank_free(bank);
+
+	for (j = 0; j < VIT_STREAMS; j++)
+		viterbi_free(v[j]);
+
+	g_free(syms);
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Run one benchmark in a child process and collect its result.
+ */
+static void fork_bench(struct bench *b, struct result *r)
+{
+	pid_t pid;
+	gint fd[2], status;
+
+	memset(r, 0, sizeof(struct result));
+
+	if (pipe(fd) < 0) {
+		perror("pipe");
+		return;
+	}
+
+	fflush(stdout);
+
+	if ((pid = fork()) < 0) {
+		perror("fork");
+		close(fd[0]);
+		close(fd[1]);
+		return;
+	}
+
+	if (pid == 0) {
+		close(fd[0]);
+		if (b->run)
+			b->run(b, r);
+		else
+			run_bench(b, r);
+		write(fd[1], r, sizeof(struct result));
+		_exit(0);
+	}
+
+	close(fd[1]);
+
+	if (read(fd[0], r, sizeof(struct result)) != sizeof(struct result))
+		r->ok = 0;
+
+	close(fd[0]);
+	waitpid(pid, &status, 0);
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Look up the realtime factor of 'name' in a baseline file written
+ * with -o. Returns 0.0 if it is not there.
+ */
+static gdouble baseline_factor(const gchar *filename, const gchar *name)
+{
+	gchar line[256], bname[64];
+	gdouble rate, factor;
+	FILE *fp;
+
+	if ((fp = fopen(filename, "r")) == NULL)
+		return 0.0;
+
+	while (fgets(line, sizeof(line), fp)) {
+		if (line[0] == '#')
+			continue;
+
+		if (sscanf(line, "%63s %lf %lf", bname, &rate, &factor) != 3)
+			continue;
+
+		if (strcmp(bname, name) == 0) {
+			fclose(fp);
+			return factor;
+		}
+	}
+
+	fclose(fp);
+
+	return 0.0;
+}
+
+static void usage(const gchar *prog)
+{
+	guint i;
+
+	fprintf(stderr,
+		"Usage: %s [options] [modem...]\n"
+		"\n"
+		"  -t secs     minimum receiver CPU time per modem (default 2)\n"
+		"  -o file     save the results as a baseline\n"
+		"  -c file     compare against a saved baseline\n"
+		"  -p percent  slowdown counted as a regression (default 10)\n"
+		"\n"
+		"Modems:",
+		prog);
+
+	for (i = 0; i < NUM_BENCHES; i++)
+		fprintf(stderr, " %s", benches[i].name);
+
+	fprintf(stderr, "\n");
+
+	exit(1);
+}
+
+int main(int argc, char **argv)
+{
+	struct result r;
+	gchar *outfile = NULL;
+	gchar *basefile = NULL;
+	gdouble percent = 10.0;
+	gdouble base;
+	FILE *out = NULL;
+	guint i;
+	gint c, k, regressions = 0;
+
+	while ((c = getopt(argc, argv, "t:o:c:p:h")) != -1) {
+		switch (c) {
+		case 't':
+			mintime = atof(optarg);
+			break;
+		case 'o':
+			outfile = optarg;
+			break;
+		case 'c':
+			basefile = optarg;
+			break;
+		case 'p':
+			percent = atof(optarg);
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	for (k = optind; k < argc; k++) {
+		for (i = 0; i < NUM_BENCHES; i++)
+			if (g_ascii_strcasecmp(argv[k], benches[i].name) == 0)
+				break;
+
+		if (i == NUM_BENCHES) {
+			fprintf(stderr, "Unknown modem: %s\n", argv[k]);
+			usage(argv[0]);
+		}
+	}
+
+	if (outfile && (out = fopen(outfile, "w")) == NULL) {
+		perror(outfile);
+		return 1;
+	}
+
+	if (out)
+		fprintf(out, "# gmfsk-bench %s, %s mac, %s cvec\n"
+			"# modem samples/s realtime txrealtime peakrss_kb chars\n",
+			VERSION, mac_name(), cvec_name());
+
+	printf("Using the %s mac and %s cvec kernels\n\n",
+	       mac_name(), cvec_name());
+
+	printf("%-16s %12s %10s %10s %10s %6s\n",
+	       "modem", "samples/s", "realtime", "tx", "peak RSS", "chars");
+
+	for (i = 0; i < NUM_BENCHES; i++) {
+		if (optind < argc) {
+			for (k = optind; k < argc; k++)
+				if (g_ascii_strcasecmp(argv[k], benches[i].name) == 0)
+					break;
+
+			if (k == argc)
+				continue;
+		}
+
+		fork_bench(&benches[i], &r);
+
+		if (!r.ok) {
+			printf("%-16s %12s\n", benches[i].name, "skipped");
+			continue;
+		}
+
+		printf("%-16s %12.0f %9.1fx %9.1fx %7ld kB %6ld",
+		       benches[i].name, r.rxrate, r.rxfactor, r.txfactor,
+		       r.peakrss, r.chars);
+
+		if (basefile) {
+			base = baseline_factor(basefile, benches[i].name);
+
+			if (base > 0.0) {
+				printf("  %+.1f%%", 100.0 * (r.rxfactor / base - 1.0));
+
+				if (r.rxfactor < base * (1.0 - percent / 100.0)) {
+					printf("  REGRESSION");
+					regressions++;
+				}
+			}
+		}
+
+		printf("\n");
+
+		if (out)
+			fprintf(out, "%s %.0f %.2f %.2f %ld %ld\n",
+				benches[i].name, r.rxrate, r.rxfactor,
+				r.txfactor, r.peakrss, r.chars);
+	}
+
+	if (out)
+		fclose(out);
+
+	return regressions ? 1 : 0;
+}
+
+/* ---------------------------------------------------------------------- */
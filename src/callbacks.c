@@ -40,6 +40,7 @@
 #include "log.h"
 #include "qsodata.h"
 #include "hamlib.h"
+#include "stats.h"
 
 /* ---------------------------------------------------------------------- */
 
@@ -136,6 +137,99 @@ on_clear_rx_window1_activate           (GtkMenuItem     *menuitem,
 	}
 }
 
+void
+on_add_channel1_activate               (GtkMenuItem     *menuitem,
+                                        gpointer         user_data)
+{
+	add_rx_channel();
+}
+
+void
+on_remove_channels1_activate           (GtkMenuItem     *menuitem,
+                                        gpointer         user_data)
+{
+	clear_rx_channels();
+}
+
+
+#define	STATS_RESPONSE_RESET	1
+#define	STATS_RESPONSE_SAVE	2
+
+static void on_stats_collect_toggled(GtkToggleButton *button, gpointer data)
+{
+	stats_enable(gtk_toggle_button_get_active(button));
+}
+
+void
+on_dsp_statistics1_activate            (GtkMenuItem     *menuitem,
+                                        gpointer         user_data)
+{
+	GtkWidget *dialog, *label, *check;
+	gchar *str, *report, *markup, *filename;
+	gint fill, highwater, overruns;
+	gint response;
+
+	dialog = gtk_dialog_new_with_buttons(_("gMFSK - DSP statistics"),
+					     GTK_WINDOW(appwindow),
+					     GTK_DIALOG_DESTROY_WITH_PARENT,
+					     _("_Reset"), STATS_RESPONSE_RESET,
+					     _("Save _trace"), STATS_RESPONSE_SAVE,
+					     GTK_STOCK_CLOSE, GTK_RESPONSE_CLOSE,
+					     NULL);
+
+	label = gtk_label_new(NULL);
+	gtk_misc_set_padding(GTK_MISC(label), 8, 8);
+	gtk_widget_show(label);
+	gtk_box_pack_start(GTK_BOX(GTK_DIALOG(dialog)->vbox), label,
+			   TRUE, TRUE, 0);
+
+	/* collecting costs clock calls in the DSP threads, so it is off */
+	check = gtk_check_button_new_with_mnemonic(_("_Collect statistics"));
+	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(check), stats_enabled());
+	g_signal_connect(G_OBJECT(check), "toggled",
+			 G_CALLBACK(on_stats_collect_toggled), NULL);
+	gtk_widget_show(check);
+	gtk_box_pack_start(GTK_BOX(GTK_DIALOG(dialog)->vbox), check,
+			   FALSE, FALSE, 0);
+
+	filename = g_build_filename(g_get_home_dir(), "gmfsk-trace.json", NULL);
+
+	do {
+		trx_get_capture_stats(&fill, &highwater, &overruns);
+
+		str = stats_report(FALSE);
+		report = g_strdup_printf("%s\ncapture ring: %d samples, "
+					 "high water %d, %d overruns",
+					 str, fill, highwater, overruns);
+		g_free(str);
+
+		str = g_markup_escape_text(report, -1);
+		markup = g_strdup_printf("<tt>%s</tt>", str);
+		gtk_label_set_markup(GTK_LABEL(label), markup);
+		g_free(markup);
+		g_free(report);
+		g_free(str);
+
+		response = gtk_dialog_run(GTK_DIALOG(dialog));
+
+		switch (response) {
+		case STATS_RESPONSE_RESET:
+			stats_reset();
+			break;
+		case STATS_RESPONSE_SAVE:
+			if (stats_write_trace(filename) < 0)
+				errmsg(_("Unable to write %s"), filename);
+			else
+				statusbar_set_main(_("DSP trace saved"));
+			break;
+		}
+	} while (response == STATS_RESPONSE_RESET ||
+		 response == STATS_RESPONSE_SAVE);
+
+	g_free(filename);
+	gtk_widget_destroy(dialog);
+}
+
 
 void
 on_exit1_activate                      (GtkMenuItem     *menuitem,
@@ -185,13 +279,7 @@ on_mfsk1_activate                      (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_MFSK16) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_MFSK16);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_MFSK16);
 
 		set_sens(TRUE, TRUE, TRUE, TRUE);
 		set_scope_mode(MINISCOPE_MODE_SCOPE);
@@ -221,13 +309,7 @@ on_mfsk2_activate                      (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_MFSK8) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_MFSK8);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_MFSK8);
 
 		set_sens(TRUE, TRUE, TRUE, TRUE);
 		set_scope_mode(MINISCOPE_MODE_SCOPE);
@@ -257,13 +339,7 @@ on_olivia1_activate                    (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_OLIVIA) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_OLIVIA);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_OLIVIA);
 
 		waterfall_set_samplerate(waterfall, trx_get_samplerate());
 		waterfall_set_bandwidth(waterfall, trx_get_bandwidth());
@@ -294,13 +370,7 @@ on_rtty1_activate                      (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_RTTY) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_RTTY);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_RTTY);
 
 		set_sens(TRUE, FALSE, TRUE, TRUE);
 		set_scope_mode(MINISCOPE_MODE_SCOPE);
@@ -330,13 +400,7 @@ on_throb1_activate                     (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_THROB1) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_THROB1);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_THROB1);
 
 		set_sens(TRUE, FALSE, TRUE, TRUE);
 		set_scope_mode(MINISCOPE_MODE_SCOPE);
@@ -366,13 +430,7 @@ on_throb2_activate                     (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_THROB2) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_THROB2);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_THROB2);
 
 		set_sens(TRUE, FALSE, TRUE, TRUE);
 		set_scope_mode(MINISCOPE_MODE_SCOPE);
@@ -402,13 +460,7 @@ on_throb4_activate                     (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_THROB4) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_THROB4);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_THROB4);
 
 		set_sens(TRUE, FALSE, TRUE, TRUE);
 		set_scope_mode(MINISCOPE_MODE_SCOPE);
@@ -438,13 +490,7 @@ on_bpsk31_activate                     (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_BPSK31) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_BPSK31);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_BPSK31);
 
 		set_sens(TRUE, TRUE, TRUE, TRUE);
 		set_scope_mode(MINISCOPE_MODE_PHASE);
@@ -474,13 +520,7 @@ on_qpsk31_activate                     (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_QPSK31) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_QPSK31);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_QPSK31);
 
 		set_sens(TRUE, TRUE, TRUE, TRUE);
 		set_scope_mode(MINISCOPE_MODE_PHASE);
@@ -510,13 +550,7 @@ on_psk63_activate                      (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_PSK63) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_PSK63);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_PSK63);
 
 		waterfall_set_samplerate(waterfall, trx_get_samplerate());
 		waterfall_set_bandwidth(waterfall, trx_get_bandwidth());
@@ -547,13 +581,7 @@ on_mt63_activate                       (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_MT63) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_MT63);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_MT63);
 
 		waterfall_set_samplerate(waterfall, trx_get_samplerate());
 		waterfall_set_bandwidth(waterfall, trx_get_bandwidth());
@@ -584,13 +612,7 @@ on_feldhell1_activate                  (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_FELDHELL) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_FELDHELL);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_FELDHELL);
 
 		waterfall_set_samplerate(waterfall, trx_get_samplerate());
 		waterfall_set_bandwidth(waterfall, trx_get_bandwidth());
@@ -621,13 +643,7 @@ on_cw1_activate                        (GtkMenuItem     *menuitem,
 	GtkWidget *w;
 
 	if (item->active) {
-		if (trx_get_mode() != MODE_CW) {
-			gint state = trx_get_state();
-
-			trx_set_state_wait(TRX_STATE_ABORT);
-			trx_set_mode(MODE_CW);
-			trx_set_state_wait(state);
-		}
+		trx_switch_mode(MODE_CW);
 
 		waterfall_set_samplerate(waterfall, trx_get_samplerate());
 		waterfall_set_bandwidth(waterfall, trx_get_bandwidth());
@@ -930,6 +946,9 @@ on_txtext_delete_from_cursor           (GtkTextView     *textview,
 
 	textbuffer = gtk_text_view_get_buffer(textview);
 
+	/* the TX mark has to be past everything sent */
+	sync_tx_text();
+
 	/* get the iterator at TX mark */
 	mark1 = gtk_text_buffer_get_mark(textbuffer, "editablemark");
 	gtk_text_buffer_get_iter_at_mark(textbuffer, &iter1, mark1);
@@ -943,9 +962,10 @@ on_txtext_delete_from_cursor           (GtkTextView     *textview,
 		return;
 
 	/*
-	 * User hit backspace at the TX mark, queue a BS character
-	 * and delete the previous char. It should be non-editable
-	 * so the default handler won't delete it.
+	 * User hit backspace at the TX mark, the previous char is on
+	 * air already. Send a BS ahead of the queued text and delete
+	 * the char. It is non-editable so the default handler won't
+	 * delete it.
 	 */
 	trx_queue_backspace();
 	gtk_text_iter_backward_char(&iter1);
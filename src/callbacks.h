@@ -54,6 +54,18 @@ void
 on_clear_rx_window1_activate           (GtkMenuItem     *menuitem,
                                         gpointer         user_data);
 
+void
+on_add_channel1_activate               (GtkMenuItem     *menuitem,
+                                        gpointer         user_data);
+
+void
+on_remove_channels1_activate           (GtkMenuItem     *menuitem,
+                                        gpointer         user_data);
+
+void
+on_dsp_statistics1_activate            (GtkMenuItem     *menuitem,
+                                        gpointer         user_data);
+
 void
 on_exit1_activate                      (GtkMenuItem     *menuitem,
                                         gpointer         user_data);
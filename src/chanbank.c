@@ -0,0 +1,415 @@
+/*
+ *    chanbank.c  --  Multi-channel receive
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <gnome.h>
+
+#include <unistd.h>
+#include <pthread.h>
+
+#include "trx.h"
+#include "chanbank.h"
+#include "ringbuf.h"
+
+#define	CHANBANK_DEBUG	0
+
+#define	CHANBANK_RING_SIZE	1024
+
+/* ---------------------------------------------------------------------- */
+
+struct channel {
+	gint id;
+	struct trx trx;
+	struct ringbuf *rx_ring;
+};
+
+/*
+ * The bank mutex protects the channel table. It is held for the whole
+ * duration of chanbank_process() so channels can not disappear under
+ * the workers.
+ */
+static pthread_mutex_t bank_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct channel *channels[CHANBANK_MAX_CHANNELS];
+static gint nchannels = 0;
+
+/*
+ * The pool mutex protects the job list handed to the workers.
+ */
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+
+static pthread_t workers[CHANBANK_MAX_WORKERS];
+static gint nworkers = 0;
+static gboolean pool_running = FALSE;
+static gboolean pool_quit = FALSE;
+
+static struct channel *jobs[CHANBANK_MAX_CHANNELS];
+static gint job_count = 0;
+static gint job_next = 0;
+static gint job_pending = 0;
+static gfloat *job_buf = NULL;
+static gint job_len = 0;
+
+/*
+ * Thread specific pointer to the channel being processed.
+ */
+static pthread_key_t current_key;
+static pthread_once_t current_once = PTHREAD_ONCE_INIT;
+
+/* ---------------------------------------------------------------------- */
+
+static void current_key_init(void)
+{
+	pthread_key_create(&current_key, NULL);
+}
+
+static struct channel *get_current(void)
+{
+	pthread_once(&current_once, current_key_init);
+
+	return (struct channel *) pthread_getspecific(current_key);
+}
+
+struct trx *chanbank_get_current(void)
+{
+	struct channel *ch = get_current();
+
+	return ch ? &ch->trx : NULL;
+}
+
+/*
+ * Only the worker currently running the channel writes into its ring
+ * so the single producer rule holds.
+ */
+gboolean chanbank_put_rx_char(guint c)
+{
+	struct channel *ch = get_current();
+
+	if (ch == NULL)
+		return FALSE;
+
+	ringbuf_write(ch->rx_ring, &c, 1);
+	return TRUE;
+}
+
+/* ---------------------------------------------------------------------- */
+
+static void run_jobs(void)
+{
+	struct channel *ch;
+
+	for (;;) {
+		pthread_mutex_lock(&pool_mutex);
+
+		if (job_next >= job_count) {
+			pthread_mutex_unlock(&pool_mutex);
+			break;
+		}
+
+		ch = jobs[job_next++];
+
+		pthread_mutex_unlock(&pool_mutex);
+
+		pthread_setspecific(current_key, ch);
+		ch->trx.rxprocess(&ch->trx, job_buf, job_len);
+		pthread_setspecific(current_key, NULL);
+
+		pthread_mutex_lock(&pool_mutex);
+
+		if (--job_pending == 0)
+			pthread_cond_signal(&done_cond);
+
+		pthread_mutex_unlock(&pool_mutex);
+	}
+}
+
+static void *worker_loop(void *unused)
+{
+	pthread_mutex_lock(&pool_mutex);
+
+	for (;;) {
+		while (!pool_quit && job_next >= job_count)
+			pthread_cond_wait(&work_cond, &pool_mutex);
+
+		if (pool_quit)
+			break;
+
+		pthread_mutex_unlock(&pool_mutex);
+		run_jobs();
+		pthread_mutex_lock(&pool_mutex);
+	}
+
+	pthread_mutex_unlock(&pool_mutex);
+
+	return NULL;
+}
+
+/*
+ * The thread calling chanbank_process() works on the jobs too,
+ * so one worker less than there are CPUs is needed.
+ */
+static void pool_start(void)
+{
+	gint i, n;
+
+	if (pool_running)
+		return;
+
+	n = sysconf(_SC_NPROCESSORS_ONLN) - 1;
+	n = CLAMP(n, 0, CHANBANK_MAX_WORKERS);
+
+	pool_quit = FALSE;
+	nworkers = 0;
+
+	for (i = 0; i < n; i++) {
+		if (pthread_create(&workers[i], NULL, worker_loop, NULL) != 0) {
+			g_warning(_("chanbank: pthread_create: %m"));
+			break;
+		}
+		nworkers++;
+	}
+
+#if CHANBANK_DEBUG
+	fprintf(stderr, "chanbank: started %d workers\n", nworkers);
+#endif
+
+	pool_running = TRUE;
+}
+
+static void pool_stop(void)
+{
+	gint i;
+
+	if (!pool_running)
+		return;
+
+	pthread_mutex_lock(&pool_mutex);
+	pool_quit = TRUE;
+	pthread_cond_broadcast(&work_cond);
+	pthread_mutex_unlock(&pool_mutex);
+
+	for (i = 0; i < nworkers; i++)
+		pthread_join(workers[i], NULL);
+
+	nworkers = 0;
+	pool_running = FALSE;
+}
+
+/* ---------------------------------------------------------------------- */
+
+static void channel_free(struct channel *ch)
+{
+	if (ch->trx.destructor)
+		ch->trx.destructor(&ch->trx);
+
+	ringbuf_free(ch->rx_ring);
+
+	g_free(ch);
+}
+
+gint chanbank_add(trx_mode_t mode, gfloat freq)
+{
+	struct channel *ch;
+	gint i;
+
+	pthread_once(&current_once, current_key_init);
+
+	ch = g_new0(struct channel, 1);
+
+	trx_copy_parms(&ch->trx);
+	ch->trx.mode = mode;
+
+	if (trx_modem_init(&ch->trx) < 0) {
+		g_warning(_("chanbank: %s modem initialization failed"),
+			  trx_mode_names[mode]);
+		g_free(ch);
+		return -1;
+	}
+
+	if (ch->trx.samplerate != trx_get_samplerate()) {
+		g_warning(_("chanbank: %s needs samplerate %d (have %d)"),
+			  trx_mode_names[mode],
+			  ch->trx.samplerate,
+			  trx_get_samplerate());
+		ch->trx.destructor(&ch->trx);
+		g_free(ch);
+		return -1;
+	}
+
+	ch->rx_ring = ringbuf_new(sizeof(guint), CHANBANK_RING_SIZE);
+
+	ch->trx.frequency = freq;
+	ch->trx.state = TRX_STATE_RX;
+	ch->trx.rxinit(&ch->trx);
+
+	pthread_mutex_lock(&bank_mutex);
+
+	for (i = 0; i < CHANBANK_MAX_CHANNELS; i++)
+		if (channels[i] == NULL)
+			break;
+
+	if (i == CHANBANK_MAX_CHANNELS) {
+		pthread_mutex_unlock(&bank_mutex);
+		g_warning(_("chanbank: too many channels"));
+		channel_free(ch);
+		return -1;
+	}
+
+	ch->id = i;
+	channels[i] = ch;
+	nchannels++;
+
+	pool_start();
+
+	pthread_mutex_unlock(&bank_mutex);
+
+#if CHANBANK_DEBUG
+	fprintf(stderr, "chanbank: added %s at %.1f Hz as channel %d\n",
+		trx_mode_names[mode], freq, i);
+#endif
+
+	return i;
+}
+
+static void channel_remove(gint id)
+{
+	struct channel *ch;
+
+	g_return_if_fail(id >= 0 && id < CHANBANK_MAX_CHANNELS);
+
+	pthread_mutex_lock(&bank_mutex);
+
+	if ((ch = channels[id]) != NULL) {
+		channels[id] = NULL;
+		nchannels--;
+	}
+
+	pthread_mutex_unlock(&bank_mutex);
+
+	if (ch)
+		channel_free(ch);
+}
+
+/*
+ * Remove all channels. The workers stay, idle, for the next ones.
+ */
+void chanbank_clear(void)
+{
+	gint i;
+
+	for (i = 0; i < CHANBANK_MAX_CHANNELS; i++)
+		channel_remove(i);
+}
+
+/*
+ * Remove all channels and stop and join the workers.
+ */
+void chanbank_shutdown(void)
+{
+	chanbank_clear();
+
+	pthread_mutex_lock(&bank_mutex);
+	pool_stop();
+	pthread_mutex_unlock(&bank_mutex);
+}
+
+gint chanbank_get_count(void)
+{
+	gint n;
+
+	pthread_mutex_lock(&bank_mutex);
+	n = nchannels;
+	pthread_mutex_unlock(&bank_mutex);
+
+	return n;
+}
+
+/* ---------------------------------------------------------------------- */
+
+gint chanbank_get_rx_chars(gint id, guint *buf, gint len)
+{
+	gint n = 0;
+
+	g_return_val_if_fail(id >= 0 && id < CHANBANK_MAX_CHANNELS, 0);
+
+	pthread_mutex_lock(&bank_mutex);
+
+	if (channels[id])
+		n = ringbuf_read(channels[id]->rx_ring, buf, len);
+
+	pthread_mutex_unlock(&bank_mutex);
+
+	return n;
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Feed one block of audio to all channels. Returns when every channel
+ * has consumed the block so the caller is free to reuse the buffer.
+ */
+void chanbank_process(gfloat *buf, gint len)
+{
+	gint i;
+
+	pthread_mutex_lock(&bank_mutex);
+
+	if (nchannels == 0) {
+		pthread_mutex_unlock(&bank_mutex);
+		return;
+	}
+
+	pthread_mutex_lock(&pool_mutex);
+
+	job_count = 0;
+
+	for (i = 0; i < CHANBANK_MAX_CHANNELS; i++)
+		if (channels[i])
+			jobs[job_count++] = channels[i];
+
+	job_buf = buf;
+	job_len = len;
+	job_next = 0;
+	job_pending = job_count;
+
+	pthread_cond_broadcast(&work_cond);
+	pthread_mutex_unlock(&pool_mutex);
+
+	run_jobs();
+
+	pthread_mutex_lock(&pool_mutex);
+
+	while (job_pending > 0)
+		pthread_cond_wait(&done_cond, &pool_mutex);
+
+	pthread_mutex_unlock(&pool_mutex);
+
+	pthread_mutex_unlock(&bank_mutex);
+}
+
+/* ---------------------------------------------------------------------- */
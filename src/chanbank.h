@@ -0,0 +1,68 @@
+/*
+ *    chanbank.h  --  Multi-channel receive
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _CHANBANK_H
+#define _CHANBANK_H
+
+#include <glib.h>
+
+#include "trx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif 
+
+/* ---------------------------------------------------------------------- */
+
+#define	CHANBANK_MAX_CHANNELS	64
+#define	CHANBANK_MAX_WORKERS	16
+
+/*
+ * The channel bank runs any number of receive-only modem instances
+ * on the same audio stream as the main trx. Each channel has its own
+ * modem state and its own received character queue. The audio blocks
+ * are spread across a pool of worker threads, one per CPU.
+ */
+
+extern gint chanbank_add(trx_mode_t mode, gfloat freq);
+extern void chanbank_clear(void);
+extern void chanbank_shutdown(void);
+
+extern gint chanbank_get_count(void);
+
+extern gint chanbank_get_rx_chars(gint id, guint *buf, gint len);
+
+extern void chanbank_process(gfloat *buf, gint len);
+
+/* for the trx engine: non-NULL only in a channel worker */
+extern struct trx *chanbank_get_current(void);
+extern gboolean chanbank_put_rx_char(guint c);
+
+/* ---------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif 
+
+#endif
@@ -136,6 +136,7 @@ static struct conf_default conf_defs[] = {
 	{ "misc/picrxdir",   D_STRING, { .s = "~/gMFSK/" } },
 	{ "misc/pictxdir",   D_STRING, { .s = "~/gMFSK/" } },
 	{ "misc/fftwwisdom", D_STRING, { .s = "" } },
+	{ "misc/filtertuning", D_STRING, { .s = "" } },
 	{ "hell/font",       D_STRING, { .s = "FeldNarr 14" } },
 	{ "hamlib/conf",     D_STRING, { .s = ""     } },
 	{ "hamlib/port",     D_STRING, { .s = ""     } },
@@ -33,7 +33,7 @@
 #include "trx.h"
 #include "cw.h"
 #include "morse.h"
-#include "fftfilt.h"
+#include "firfilt.h"
 
 static void cw_txinit(struct trx *trx)
 {
@@ -44,7 +44,7 @@ static void cw_txinit(struct trx *trx)
 static void cw_free(struct cw *s)
 {
 	if (s) {
-		fftfilt_free(s->fftfilt);
+		firfilt_free(s->filt);
 		g_free(s);
 	}
 }
@@ -56,7 +56,9 @@ static void cw_rxinit(struct trx *trx)
 	c->s_ctr = 0;			// reset audio sample counter
 	c->cw_rr_current = 0;		// reset decoding pointer
 	c->agc_peak = 0;		// reset agc
-	c->dec_ctr = 0;			// reset decimation counter
+	c->space_sent = TRUE;		// no word space pending
+	c->last_element = 0;		// no previous dot/dash
+	nco_init(&c->rxnco, 0.0);	// restart the rx mixer
 }
 
 static void cw_destructor(struct trx *trx)
@@ -106,7 +108,7 @@ void cw_init(struct trx *trx)
 
 	lp = trx->cw_bandwidth / 2.0 / SampleRate;
 
-	if ((s->fftfilt = fftfilt_init(0, lp, 1024)) == NULL) {
+	if ((s->filt = firfilt_init(0, lp, 513, DEC_RATIO)) == NULL) {
 		cw_free(s);
 		return;
 	}
@@ -30,6 +30,7 @@
 #define _CW_H
 
 #include "cmplx.h"
+#include "nco.h"
 #include "trx.h"
 
 #define	SampleRate	8000
@@ -78,17 +79,17 @@ struct cw {
 	 * Common stuff
 	 */
 	int symbollen;		/* length of a dot in sound samples (tx) */
-	double phaseacc;	/* used by NCO for rx/tx tones */
+	double phaseacc;	/* used by NCO for tx tones */
+	struct nco rxnco;	/* rx mixer */
 
 	/*
 	 * RX related stuff
 	 */
 	unsigned int s_ctr;	/* sample counter for timing cw rx */
-	unsigned int dec_ctr;	/* decimation counter for rx */
 
 	double agc_peak;	/* threshold for tone detection */
 
-	struct fftfilt *fftfilt;
+	struct firfilt *filt;
 
 	enum {
 		RS_IDLE = 0,
@@ -150,6 +151,9 @@ struct cw {
 	unsigned int cw_rr_start_timestamp;	/* Tone start timestamp */
 	unsigned int cw_rr_end_timestamp;	/* Tone end timestamp */
 
+	int space_sent;			/* for word space logic */
+	int last_element;		/* length of last dot/dash */
+
 	/*
 	 * variable which is automatically maintained from the Morse input
 	 * stream, rather than being settable by the user.
@@ -35,7 +35,8 @@
 #include "cw.h"
 #include "morse.h"
 #include "filter.h"
-#include "fftfilt.h"
+#include "firfilt.h"
+#include "cvec.h"
 #include "misc.h"
 
 static int cw_process(struct trx *trx, int cw_event, unsigned char **c);
@@ -73,49 +74,50 @@ static void update_syncscope(struct cw *s)
 int cw_rxprocess(struct trx *trx, float *buf, int len)
 {
 	struct cw *s = (struct cw *) trx->modem;
-	complex z, *zp;
-	int n, i;
-	double delta;
+	complex zbuf[FILTER_BLOCKLEN], *zp;
+	double re[FILTER_BLOCKLEN], im[FILTER_BLOCKLEN];
+	double mag[FILTER_BLOCKLEN];
+	int num, n, i;
 	double value;
 	unsigned char *c;
 
 	/* check if user changed filter bandwidth */
 	if (trx->bandwidth != trx->cw_bandwidth) {
-		fftfilt_set_freqs(s->fftfilt, 0, trx->cw_bandwidth / 2.0 / SampleRate);
+		firfilt_set_freqs(s->filt, 0, trx->cw_bandwidth / 2.0 / SampleRate);
 		trx->bandwidth = trx->cw_bandwidth;
 	}
 
-	/* compute phase increment expected at our specific rx tone freq */
-	delta = 2.0 * M_PI * trx->frequency / SampleRate;
+	/* tune the NCO to our specific rx tone freq */
+	nco_set_freq(&s->rxnco, trx->frequency / SampleRate);
+
+	while (len > 0) {
+		num = MIN(len, FILTER_BLOCKLEN);
 
-	while (len-- > 0) {
 		/* Mix with the internal NCO */
-		c_re(z) = *buf * cos(s->phaseacc);
-		c_im(z) = *buf * sin(s->phaseacc);
-		buf++;
+		nco_mix_real(&s->rxnco, buf, zbuf, num);
+
+		buf += num;
+		len -= num;
 
-		s->phaseacc += delta;
+		/* filter and downsample by 8 */
+		n = firfilt_run_block(s->filt, zbuf, num, &zp);
 
-		if (s->phaseacc > M_PI)
-			s->phaseacc -= 2.0 * M_PI;
+		for (i = 0; i < n; i++) {
+			re[i] = c_re(zp[i]);
+			im[i] = c_im(zp[i]);
+		}
 
-		n = fftfilt_run(s->fftfilt, z, &zp);
+		/* demodulate */
+		cvec_mag(re, im, mag, n);
 
 		for (i = 0; i < n; i++) {
 			/* 
 			 * update the basic sample counter used for 
 			 * morse timing 
 			 */
-			s->s_ctr++;
+			s->s_ctr += DEC_RATIO;
 
-			/* downsample by 8 */
-			if (++s->dec_ctr < DEC_RATIO)
-				continue;
-			else
-				s->dec_ctr = 0;
-
-			/* demodulate */
-			value = cmod(zp[i]);
+			value = mag[i];
 
 			/* 
 			 * Compute a variable threshold value for tone 
@@ -157,7 +159,6 @@ int cw_rxprocess(struct trx *trx, float *buf, int len)
 				while (*c)
 					trx_put_rx_char(*c++);
 		}
-
 	}
 	return 0;
 }
@@ -246,8 +247,6 @@ cw_process()
 static int cw_process(struct trx *trx, int cw_event, unsigned char **c)
 {
 	struct cw *s = (struct cw *) trx->modem;
-	static int space_sent = TRUE;	// for word space logic
-	static int last_element = 0;	// length of last dot/dash
 	int element_usec;		// Time difference in usecs
 
 	switch (cw_event) {
@@ -317,19 +316,19 @@ static int cw_process(struct trx *trx, int cw_event, unsigned char **c)
 		// quite variable, but with most faster cw sent with 
 		// electronic keyers, this is one relationship that is 
 		// quite reliable.
-		if (last_element > 0) {
+		if (s->last_element > 0) {
 			// check for dot dash sequence (current should be 3 x last)
-			if ((element_usec > 2 * last_element) &&
-			    (element_usec < 4 * last_element)) {
-				cw_update_tracking(trx, last_element, element_usec);
+			if ((element_usec > 2 * s->last_element) &&
+			    (element_usec < 4 * s->last_element)) {
+				cw_update_tracking(trx, s->last_element, element_usec);
 			}
 			// check for dash dot sequence (last should be 3 x current)
-			if ((last_element > 2 * element_usec) &&
-			    (last_element < 4 * element_usec)) {
-				cw_update_tracking(trx, element_usec, last_element);
+			if ((s->last_element > 2 * element_usec) &&
+			    (s->last_element < 4 * element_usec)) {
+				cw_update_tracking(trx, element_usec, s->last_element);
 			}
 		}
-		last_element = element_usec;
+		s->last_element = element_usec;
 
 		// ok... do we have a dit or a dah?
 		// a dot is anything shorter than 2 dot times
@@ -398,14 +397,14 @@ static int cw_process(struct trx *trx, int cw_event, unsigned char **c)
 
 			s->cw_receive_state = RS_IDLE;
 			s->cw_rr_current = 0;	// reset decoding pointer
-			space_sent = FALSE;
+			s->space_sent = FALSE;
 			return CW_SUCCESS;
 		}
 
 		// LONG time since keyup... check for a word space
-		if ((element_usec > (4 * s->cw_receive_dot_length)) && !space_sent) {
+		if ((element_usec > (4 * s->cw_receive_dot_length)) && !s->space_sent) {
 			*c = " ";
-			space_sent = TRUE;
+			s->space_sent = TRUE;
 			return CW_SUCCESS;
 		}
 		// should never get here... catch all
@@ -155,6 +155,12 @@ static cw_table_entry *cw_rx_lookup_table[MorseTableSize];
  */
 static unsigned long cw_tx_lookup_table[MorseTableSize];
 
+/*
+ * Single character strings returned by cw_rx_lookup(). These are never
+ * modified after init so several receivers can share them.
+ */
+static unsigned char cw_rx_single_table[MorseTableSize][2];
+
 /* ---------------------------------------------------------------------- */
 
 /**
@@ -230,6 +236,12 @@ int cw_tables_init(void)
 			return FALSE;
 	}
 
+	/* Build the single character table */
+	for (i = 0; i < MorseTableSize; i++) {
+		cw_rx_single_table[i][0] = i;
+		cw_rx_single_table[i][1] = 0;
+	}
+
 	/* Clear the TX table */
 	for (i = 0; i < MorseTableSize; i++)
 		cw_tx_lookup_table[i] = 0x04;
@@ -272,7 +284,6 @@ int cw_tables_init(void)
 
 const unsigned char *cw_rx_lookup(const char *r)
 {
-	static unsigned char chr[2];	/* FIXME */
 	unsigned char token;
 	cw_table_entry *cw;		/* Pointer to table entry */
 
@@ -285,10 +296,7 @@ const unsigned char *cw_rx_lookup(const char *r)
 	if (cw->type == CW_ENTRY_EXTENDED)
 		return cw->chr;
 
-	chr[0] = cw->chr[0];
-	chr[1] = 0;
-
-	return chr;
+	return cw_rx_single_table[cw->chr[0]];
 }
 
 unsigned long cw_tx_lookup(unsigned char c)
@@ -0,0 +1,858 @@
+/*
+ *    decode.c  --  Offline decoding of recorded audio files
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <pthread.h>
+
+#include <glib.h>
+
+#include "trx.h"
+#include "headless.h"
+#include "samplerate.h"
+#include "stats.h"
+
+#define	BLOCKLEN	512
+
+/* ---------------------------------------------------------------------- */
+
+struct audiofile {
+	guchar *map;
+	gsize maplen;
+
+	const guchar *data;
+	glong nsamples;
+
+	gint rate;
+	gint channels;
+	gint bits;
+};
+
+static inline guint get_le16(const guchar *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static inline guint get_le32(const guchar *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+}
+
+/*
+ * Find the format and the sample data of a RIFF/WAVE file. Only
+ * 8 and 16 bit PCM is understood.
+ */
+static gint parse_wav(struct audiofile *af)
+{
+	const guchar *p = af->map;
+	const guchar *end = af->map + af->maplen;
+	guint len;
+
+	if (af->maplen < 12 || memcmp(p, "RIFF", 4) || memcmp(p + 8, "WAVE", 4))
+		return -1;
+
+	p += 12;
+	af->bits = 0;
+
+	while (p + 8 <= end) {
+		len = get_le32(p + 4);
+
+		if (!memcmp(p, "fmt ", 4) && len >= 16 && p + 8 + 16 <= end) {
+			if (get_le16(p + 8) != 1) {
+				fprintf(stderr, "Only PCM WAV files are supported\n");
+				return -1;
+			}
+
+			af->channels = get_le16(p + 10);
+			af->rate = get_le32(p + 12);
+			af->bits = get_le16(p + 22);
+
+			/* the data chunk is sized by these */
+			if ((af->bits != 8 && af->bits != 16) ||
+			    af->channels < 1) {
+				fprintf(stderr, "Unsupported format (%d bits, %d channels)\n",
+					af->bits, af->channels);
+				return -1;
+			}
+		}
+
+		if (!memcmp(p, "data", 4)) {
+			if (af->bits == 0)
+				return -1;
+
+			af->data = p + 8;
+			len = MIN(len, end - af->data);
+			af->nsamples = len / (af->channels * af->bits / 8);
+
+			return 0;
+		}
+
+		/* a chunk running past the end has nothing after it */
+		if (len >= (gsize) (end - p) - 8)
+			break;
+
+		p += 8 + len + (len & 1);
+	}
+
+	return -1;
+}
+
+static gint audiofile_open(struct audiofile *af, const gchar *filename,
+			   gint rawrate, gint rawbits)
+{
+	struct stat st;
+	gint fd;
+
+	memset(af, 0, sizeof(struct audiofile));
+
+	if ((fd = open(filename, O_RDONLY)) < 0) {
+		perror(filename);
+		return -1;
+	}
+
+	if (fstat(fd, &st) < 0 || st.st_size == 0) {
+		fprintf(stderr, "%s: empty or unreadable file\n", filename);
+		close(fd);
+		return -1;
+	}
+
+	af->maplen = st.st_size;
+	af->map = mmap(NULL, af->maplen, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	close(fd);
+
+	if (af->map == MAP_FAILED) {
+		perror(filename);
+		return -1;
+	}
+
+	madvise(af->map, af->maplen, MADV_SEQUENTIAL);
+
+	if (rawrate > 0) {
+		af->data = af->map;
+		af->rate = rawrate;
+		af->channels = 1;
+		af->bits = rawbits;
+		af->nsamples = af->maplen / (rawbits / 8);
+	} else if (parse_wav(af) < 0) {
+		fprintf(stderr, "%s: not a PCM WAV file\n", filename);
+		munmap(af->map, af->maplen);
+		return -1;
+	}
+
+	if ((af->bits != 8 && af->bits != 16) || af->channels < 1) {
+		fprintf(stderr, "%s: unsupported format (%d bits, %d channels)\n",
+			filename, af->bits, af->channels);
+		munmap(af->map, af->maplen);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void audiofile_close(struct audiofile *af)
+{
+	if (af->map)
+		munmap(af->map, af->maplen);
+
+	af->map = NULL;
+}
+
+/*
+ * Convert 'len' samples of the first channel starting at 'pos'.
+ */
+static void audiofile_read(struct audiofile *af, glong pos, gfloat *buf, gint len)
+{
+	gint i, step = af->channels * af->bits / 8;
+	const guchar *p = af->data + pos * step;
+
+	if (af->bits == 8) {
+		for (i = 0; i < len; i++, p += step)
+			buf[i] = (p[0] - 128) / 128.0;
+	} else {
+		for (i = 0; i < len; i++, p += step)
+			buf[i] = (gint16) get_le16(p) / 32768.0;
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Run the whole file through the modem in 't'. The modem is fed in
+ * blocks of BLOCKLEN samples, just like the receive loop of gmfsk
+ * does, but as fast as the CPU allows. Returns the number of
+ * characters decoded or -1.
+ */
+static glong decode_file(struct audiofile *af, struct trx *t, FILE *fp)
+{
+	struct headless h;
+	SRC_STATE *src = NULL;
+	SRC_DATA data;
+	gfloat inbuf[BLOCKLEN];
+	gfloat *outbuf, *out;
+	glong pos, done;
+	gint n, len, outlen, err;
+	gdouble ratio;
+	guint64 t0;
+
+	ratio = (gdouble) t->samplerate / af->rate;
+	outlen = ratio * BLOCKLEN + 64;
+	outbuf = g_new(gfloat, outlen);
+
+	if (af->rate != t->samplerate) {
+		if ((src = src_new(SRC_SINC_FASTEST, 1, &err)) == NULL) {
+			fprintf(stderr, "src_new: %s\n", src_strerror(err));
+			g_free(outbuf);
+			return -1;
+		}
+
+		data.src_ratio = ratio;
+	}
+
+	headless_init(&h, t, fp, 1.0 / ratio);
+	headless_set_current(&h);
+
+	t->state = TRX_STATE_RX;
+	t->rxinit(t);
+
+	pos = 0;
+	done = 0;
+
+	while (pos < af->nsamples) {
+		n = MIN(BLOCKLEN, af->nsamples - pos);
+
+		audiofile_read(af, pos, inbuf, n);
+
+		if (src) {
+			data.data_in = inbuf;
+			data.input_frames = n;
+			data.data_out = outbuf;
+			data.output_frames = outlen;
+			data.end_of_input = (pos + n >= af->nsamples);
+
+			t0 = stats_time();
+
+			if ((err = src_process(src, &data)) != 0) {
+				fprintf(stderr, "src_process: %s\n", src_strerror(err));
+				break;
+			}
+
+			stats_add(STATS_RESAMPLE, t0, data.input_frames_used,
+				  af->rate);
+
+			/* not all input may fit the output in one go */
+			if (data.input_frames_used == 0 && data.output_frames_gen == 0)
+				break;
+
+			pos += data.input_frames_used;
+			out = outbuf;
+			len = data.output_frames_gen;
+		} else {
+			pos += n;
+			out = inbuf;
+			len = n;
+		}
+
+		while (len > 0) {
+			n = MIN(BLOCKLEN, len);
+
+			h.offset = done;
+
+			t0 = stats_time();
+			t->rxprocess(t, out, n);
+			stats_add(STATS_RXPROCESS, t0, n, t->samplerate);
+
+			out += n;
+			len -= n;
+			done += n;
+		}
+	}
+
+	headless_flush(&h);
+	headless_set_current(NULL);
+	headless_free(&h);
+
+	if (src)
+		src_delete(src);
+
+	g_free(outbuf);
+
+	return h.chars;
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * A mode as given on the command line. Olivia can be followed by the
+ * number of tones and the bandwidth, eg. "OLIVIA:16/500".
+ */
+struct modespec {
+	gchar *name;
+	gint mode;
+	gint olivia_tones;
+	gint olivia_bw;
+};
+
+static gint log2_index(gint val, gint first, gint count)
+{
+	gint i;
+
+	for (i = 0; i < count; i++)
+		if (val == (first << i))
+			return i;
+
+	return -1;
+}
+
+static gint parse_modespec(const gchar *str, struct modespec *m)
+{
+	gchar **v;
+	gint tones, bw;
+
+	v = g_strsplit(str, ":", 2);
+
+	m->mode = trx_mode_from_name(v[0]);
+	m->olivia_tones = -1;
+	m->olivia_bw = -1;
+
+	if (m->mode < 0) {
+		fprintf(stderr, "Unknown mode: %s\n", v[0]);
+		g_strfreev(v);
+		return -1;
+	}
+
+	/* the Hell modems draw with GDK, they need the GUI */
+	if (m->mode == MODE_FELDHELL || m->mode == MODE_FMHELL) {
+		fprintf(stderr, "%s can not be decoded to text\n", v[0]);
+		g_strfreev(v);
+		return -1;
+	}
+
+	if (v[1]) {
+		if (m->mode != MODE_OLIVIA || sscanf(v[1], "%d/%d", &tones, &bw) != 2) {
+			fprintf(stderr, "Bad mode parameters: %s\n", str);
+			g_strfreev(v);
+			return -1;
+		}
+
+		m->olivia_tones = log2_index(tones, 4, 7);
+		m->olivia_bw = log2_index(bw, 125, 5);
+
+		if (m->olivia_tones < 0 || m->olivia_bw < 0) {
+			fprintf(stderr, "Bad Olivia tones/bandwidth: %s\n", v[1]);
+			g_strfreev(v);
+			return -1;
+		}
+	}
+
+	/* this ends up in file names */
+	m->name = g_strdelimit(g_strdup(str), ":/", '-');
+
+	g_strfreev(v);
+
+	return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * One (file, mode) pair to decode.
+ */
+struct job {
+	const gchar *filename;
+	struct modespec *spec;
+	gchar *outname;		/* NULL means stdout */
+
+	gdouble audiosecs;
+	gdouble secs;
+	glong chars;
+	gint ret;
+};
+
+static gint rawrate = 0;
+static gint rawbits = 16;
+static gboolean afc = FALSE;
+static gboolean squelch = TRUE;
+static gfloat freq = 1000.0;
+
+/*
+ * Some of the modem constructors fill in shared tables, so only one
+ * modem is built or torn down at a time.
+ */
+static pthread_mutex_t init_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void run_job(struct job *j)
+{
+	struct audiofile af;
+	struct trx t;
+	GTimer *timer;
+	FILE *fp;
+	gint ret;
+
+	j->ret = -1;
+
+	if (audiofile_open(&af, j->filename, rawrate, rawbits) < 0)
+		return;
+
+	trx_modem_defaults(&t, j->spec->mode);
+	t.afcon = afc;
+	t.squelchon = squelch;
+
+	if (j->spec->olivia_tones >= 0) {
+		t.olivia_tones = j->spec->olivia_tones;
+		t.olivia_bw = j->spec->olivia_bw;
+	}
+
+	pthread_mutex_lock(&init_mutex);
+	ret = trx_modem_init(&t);
+	pthread_mutex_unlock(&init_mutex);
+
+	if (ret < 0) {
+		fprintf(stderr, "%s: %s modem initialization failed\n",
+			j->filename, j->spec->name);
+		audiofile_close(&af);
+		return;
+	}
+
+	/* after init, MT63 sets its own default frequency */
+	t.frequency = freq;
+
+	if (j->outname == NULL)
+		fp = stdout;
+	else if ((fp = fopen(j->outname, "w")) == NULL) {
+		perror(j->outname);
+		goto out;
+	}
+
+	timer = g_timer_new();
+	j->chars = decode_file(&af, &t, fp);
+	g_timer_stop(timer);
+
+	j->secs = g_timer_elapsed(timer, NULL);
+	j->audiosecs = (gdouble) af.nsamples / af.rate;
+	j->ret = (j->chars < 0) ? -1 : 0;
+
+	g_timer_destroy(timer);
+
+	if (fp == stdout)
+		fflush(fp);
+	else
+		fclose(fp);
+
+out:
+	pthread_mutex_lock(&init_mutex);
+	t.destructor(&t);
+	pthread_mutex_unlock(&init_mutex);
+
+	audiofile_close(&af);
+}
+
+/* ---------------------------------------------------------------------- */
+
+static struct job *jobs = NULL;
+static gint njobs = 0;
+static gint nextjob = 0;
+static pthread_mutex_t job_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void *worker(void *args)
+{
+	struct job *j;
+
+	for (;;) {
+		pthread_mutex_lock(&job_mutex);
+		j = (nextjob < njobs) ? &jobs[nextjob++] : NULL;
+		pthread_mutex_unlock(&job_mutex);
+
+		if (j == NULL)
+			break;
+
+		run_job(j);
+	}
+
+	return NULL;
+}
+
+static void run_jobs(gint nthreads)
+{
+	pthread_t *threads;
+	gint i;
+
+	nthreads = CLAMP(nthreads, 1, njobs);
+	threads = g_new(pthread_t, nthreads);
+
+	for (i = 0; i < nthreads; i++) {
+		if (pthread_create(&threads[i], NULL, worker, NULL) != 0) {
+			fprintf(stderr, "pthread_create failed\n");
+			break;
+		}
+	}
+
+	/* if no thread could be started at all, do the work here */
+	if (i == 0)
+		worker(NULL);
+
+	while (i-- > 0)
+		pthread_join(threads[i], NULL);
+
+	g_free(threads);
+}
+
+/* ---------------------------------------------------------------------- */
+
+static gint compare_names(gconstpointer a, gconstpointer b)
+{
+	return strcmp(*(const gchar **) a, *(const gchar **) b);
+}
+
+/*
+ * Add 'path' to the list of input files. A directory adds all the
+ * regular files in it, in sorted order.
+ */
+static void add_input(GPtrArray *files, const gchar *path)
+{
+	GPtrArray *dirfiles;
+	const gchar *name;
+	gchar *full;
+	GDir *dir;
+	guint i;
+
+	if (!g_file_test(path, G_FILE_TEST_IS_DIR)) {
+		g_ptr_array_add(files, g_strdup(path));
+		return;
+	}
+
+	if ((dir = g_dir_open(path, 0, NULL)) == NULL) {
+		fprintf(stderr, "%s: can not open directory\n", path);
+		return;
+	}
+
+	dirfiles = g_ptr_array_new();
+
+	while ((name = g_dir_read_name(dir)) != NULL) {
+		if (name[0] == '.')
+			continue;
+
+		full = g_build_filename(path, name, NULL);
+
+		if (g_file_test(full, G_FILE_TEST_IS_REGULAR))
+			g_ptr_array_add(dirfiles, full);
+		else
+			g_free(full);
+	}
+
+	g_dir_close(dir);
+
+	g_ptr_array_sort(dirfiles, compare_names);
+
+	for (i = 0; i < dirfiles->len; i++)
+		g_ptr_array_add(files, g_ptr_array_index(dirfiles, i));
+
+	g_ptr_array_free(dirfiles, TRUE);
+}
+
+/*
+ * Read input file names, one per line, from 'listname' ("-" is stdin).
+ */
+static void add_list(GPtrArray *files, const gchar *listname)
+{
+	gchar buf[4096];
+	FILE *fp;
+
+	if (strcmp(listname, "-") == 0)
+		fp = stdin;
+	else if ((fp = fopen(listname, "r")) == NULL) {
+		perror(listname);
+		return;
+	}
+
+	while (fgets(buf, sizeof(buf), fp)) {
+		g_strstrip(buf);
+
+		if (buf[0] != 0 && buf[0] != '#')
+			add_input(files, buf);
+	}
+
+	if (fp != stdin)
+		fclose(fp);
+}
+
+static gchar *make_outname(const gchar *outdir, const gchar *filename,
+			   const gchar *modename)
+{
+	gchar *base, *p, *name, *full;
+
+	base = g_path_get_basename(filename);
+
+	if ((p = strrchr(base, '.')) != NULL && p != base)
+		*p = 0;
+
+	name = g_strdup_printf("%s.%s.txt", base, modename);
+	full = g_build_filename(outdir, name, NULL);
+
+	g_free(base);
+	g_free(name);
+
+	return full;
+}
+
+static void print_summary(gdouble wallsecs, gint nthreads)
+{
+	gdouble audio = 0.0, cpu = 0.0;
+	gint i, failed = 0;
+
+	printf("%-40s %-14s %10s %9s %8s %9s\n",
+	       "file", "mode", "audio [s]", "cpu [s]", "chars", "realtime");
+
+	for (i = 0; i < njobs; i++) {
+		struct job *j = &jobs[i];
+
+		if (j->ret < 0) {
+			printf("%-40s %-14s %10s\n",
+			       j->filename, j->spec->name, "FAILED");
+			failed++;
+			continue;
+		}
+
+		printf("%-40s %-14s %10.1f %9.2f %8ld %8.1fx\n",
+		       j->filename,
+		       j->spec->name,
+		       j->audiosecs,
+		       j->secs,
+		       j->chars,
+		       j->secs > 0 ? j->audiosecs / j->secs : 0.0);
+
+		audio += j->audiosecs;
+		cpu += j->secs;
+	}
+
+	printf("\n%d jobs (%d failed) on %d threads: "
+	       "%.1f s of audio in %.1f s, %.1fx realtime (%.1fx per thread)\n",
+	       njobs, failed, nthreads,
+	       audio, wallsecs,
+	       wallsecs > 0 ? audio / wallsecs : 0.0,
+	       cpu > 0 ? audio / cpu : 0.0);
+}
+
+/* ---------------------------------------------------------------------- */
+
+static void usage(const gchar *prog)
+{
+	gint i;
+
+	fprintf(stderr,
+		"Usage: %s [options] file|directory...\n"
+		"\n"
+		"  -m mode     modem to use (default MFSK16), may be repeated\n"
+		"              or comma separated; Olivia takes tones/bandwidth\n"
+		"              as in OLIVIA:16/500\n"
+		"  -f freq     audio center frequency in Hz (default 1000)\n"
+		"  -r rate     input is raw signed 16 bit PCM at this rate\n"
+		"  -8          raw input is unsigned 8 bit PCM\n"
+		"  -a          enable AFC\n"
+		"  -n          disable squelch\n"
+		"  -l list     read input file names from 'list' (- for stdin)\n"
+		"  -o dir      batch mode: one result file per file and mode\n"
+		"              in 'dir' and a throughput summary on stdout\n"
+		"  -j jobs     number of parallel jobs in batch mode\n"
+		"              (default: one per CPU)\n"
+		"  -v          report the decoding speed and per stage\n"
+		"              timing statistics on stderr\n"
+		"  -T file     save a Chrome trace of the DSP stages\n"
+		"\n"
+		"Modes:",
+		prog);
+
+	for (i = 0; i <= MODE_CW; i++)
+		if (i != MODE_FELDHELL && i != MODE_FMHELL)
+			fprintf(stderr, " %s", trx_mode_names[i]);
+
+	fprintf(stderr, "\n");
+
+	exit(1);
+}
+
+int main(int argc, char **argv)
+{
+	GPtrArray *files, *specs;
+	struct modespec *spec;
+	gchar *outdir = NULL;
+	gchar *tracefile = NULL;
+	gchar **v;
+	gboolean verbose = FALSE;
+	gint c, i, k, nthreads = 0;
+	GTimer *timer;
+	gdouble secs;
+	gint ret = 0;
+
+	files = g_ptr_array_new();
+	specs = g_ptr_array_new();
+
+	while ((c = getopt(argc, argv, "m:f:r:8anl:o:j:T:vh")) != -1) {
+		switch (c) {
+		case 'm':
+			v = g_strsplit(optarg, ",", 0);
+			for (i = 0; v[i]; i++) {
+				spec = g_new0(struct modespec, 1);
+				if (parse_modespec(v[i], spec) < 0)
+					usage(argv[0]);
+				g_ptr_array_add(specs, spec);
+			}
+			g_strfreev(v);
+			break;
+		case 'f':
+			freq = atof(optarg);
+			break;
+		case 'r':
+			rawrate = atoi(optarg);
+			break;
+		case '8':
+			rawbits = 8;
+			break;
+		case 'a':
+			afc = TRUE;
+			break;
+		case 'n':
+			squelch = FALSE;
+			break;
+		case 'l':
+			add_list(files, optarg);
+			break;
+		case 'o':
+			outdir = optarg;
+			break;
+		case 'j':
+			nthreads = atoi(optarg);
+			break;
+		case 'T':
+			tracefile = optarg;
+			break;
+		case 'v':
+			verbose = TRUE;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	for (; optind < argc; optind++)
+		add_input(files, argv[optind]);
+
+	if (files->len == 0)
+		usage(argv[0]);
+
+	stats_enable(verbose || tracefile);
+
+	if (specs->len == 0) {
+		spec = g_new0(struct modespec, 1);
+		parse_modespec("MFSK16", spec);
+		g_ptr_array_add(specs, spec);
+	}
+
+	njobs = files->len * specs->len;
+	jobs = g_new0(struct job, njobs);
+
+	for (i = 0; i < files->len; i++) {
+		for (k = 0; k < specs->len; k++) {
+			struct job *j = &jobs[i * specs->len + k];
+
+			j->filename = g_ptr_array_index(files, i);
+			j->spec = g_ptr_array_index(specs, k);
+
+			if (outdir)
+				j->outname = make_outname(outdir,
+							  j->filename,
+							  j->spec->name);
+		}
+	}
+
+	timer = g_timer_new();
+
+	if (outdir) {
+		if (nthreads <= 0)
+			nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+
+		run_jobs(nthreads);
+	} else {
+		/* everything goes to stdout, one job after another */
+		nthreads = 1;
+
+		for (i = 0; i < njobs; i++) {
+			if (njobs > 1 || verbose)
+				printf("==> %s (%s) <==\n",
+				       jobs[i].filename,
+				       jobs[i].spec->name);
+
+			run_job(&jobs[i]);
+
+			if (verbose && jobs[i].ret == 0)
+				fprintf(stderr, "%s: %.1f s of audio in %.2f s (%.1fx realtime)\n",
+					jobs[i].filename,
+					jobs[i].audiosecs,
+					jobs[i].secs,
+					jobs[i].secs > 0 ? jobs[i].audiosecs / jobs[i].secs : 0.0);
+		}
+	}
+
+	g_timer_stop(timer);
+	secs = g_timer_elapsed(timer, NULL);
+	g_timer_destroy(timer);
+
+	if (outdir)
+		print_summary(secs, CLAMP(nthreads, 1, njobs));
+
+	if (verbose) {
+		gchar *report = stats_report(TRUE);
+
+		fprintf(stderr, "\n%s", report);
+		g_free(report);
+	}
+
+	if (tracefile && stats_write_trace(tracefile) < 0) {
+		fprintf(stderr, "%s: can not write trace\n", tracefile);
+		ret = 1;
+	}
+
+	for (i = 0; i < njobs; i++) {
+		if (jobs[i].ret < 0)
+			ret = 1;
+
+		g_free(jobs[i].outname);
+	}
+
+	g_free(jobs);
+
+	return ret;
+}
+
+/* ---------------------------------------------------------------------- */
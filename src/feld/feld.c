@@ -28,7 +28,8 @@
 #include "trx.h"
 #include "feld.h"
 #include "filter.h"
-#include "fftfilt.h"
+#include "hilbert.h"
+#include "firfilt.h"
 
 static void feld_txinit(struct trx *trx)
 {
@@ -46,6 +47,8 @@ static void feld_rxinit(struct trx *trx)
 
 	s->rxcounter = 0.0;
 	s->agc = 0.0;
+
+	nco_init(&s->rxnco, 0.0);
 	return;
 }
 
@@ -54,8 +57,8 @@ static void feld_rxinit(struct trx *trx)
 static void feld_free(struct feld *s)
 {
         if (s) {
-                filter_free(s->hilbert);
-		fftfilt_free(s->fftfilt);
+                hilbert_free(s->hilbert);
+		firfilt_free(s->filt);
 
 		unref(s->pixmap);
 		unref(s->gc_white);
@@ -92,7 +95,7 @@ void feld_init(struct trx *trx)
 
 	s = g_new0(struct feld, 1);
 
-	if ((s->hilbert = filter_init_hilbert(37, 1)) == NULL) {
+	if ((s->hilbert = hilbert_init(37)) == NULL) {
 		feld_free(s);
 		return;
 	}
@@ -106,7 +109,7 @@ void feld_init(struct trx *trx)
 
 	lp = trx->hell_bandwidth / 2.0 / SampleRate;
 
-	if ((s->fftfilt = fftfilt_init(0, lp, 1024)) == NULL) {
+	if ((s->filt = firfilt_init(0, lp, 513, 1)) == NULL) {
 		feld_free(s);
 		return;
 	}
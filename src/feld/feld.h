@@ -28,6 +28,7 @@
 #include <gnome.h>
 
 #include "cmplx.h"
+#include "nco.h"
 #include "trx.h"
 
 #define	SampleRate	8000
@@ -43,6 +44,8 @@
 #define	DownSampleInc	((double)(RxPixRate)/(SampleRate))
 #define	UpSampleInc	((double)(TxPixRate)/(SampleRate))
 
+#define	RxPixBufLen	64
+
 #define	PIXMAP_W	14
 #define	PIXMAP_H	(TxColumnLen)
 
@@ -54,14 +57,17 @@ struct feld {
 	/*
 	 * RX related stuff
 	 */
-	double rxphacc;
+	struct nco rxnco;
 	double rxcounter;
 
-	struct filter *hilbert;
-	struct fftfilt *fftfilt;
+	struct hilbert *hilbert;
+	struct firfilt *filt;
 
 	double agc;
 
+	guchar rxpixbuf[RxPixBufLen];
+	int rxpixptr;
+
 	/*
 	 * TX related stuff
 	 */
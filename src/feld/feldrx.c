@@ -25,7 +25,8 @@
 #include "trx.h"
 #include "feld.h"
 #include "filter.h"
-#include "fftfilt.h"
+#include "hilbert.h"
+#include "firfilt.h"
 #include "misc.h"
 
 #undef  MAX
@@ -33,26 +34,6 @@
 #undef  CLAMP
 #define CLAMP(x,low,high)	(((x)>(high))?(high):(((x)<(low))?(low):(x)))
 
-static inline complex mixer(struct trx *trx, complex in)
-{
-	struct feld *s = (struct feld *) trx->modem;
-	complex z;
-
-	c_re(z) = cos(s->rxphacc);
-	c_im(z) = sin(s->rxphacc);
-
-	z = cmul(z, in);
-
-	s->rxphacc -= 2.0 * M_PI * trx->frequency / SampleRate;
-
-	if (s->rxphacc > M_PI)
-		s->rxphacc -= 2.0 * M_PI;
-	else if (s->rxphacc < M_PI)
-		s->rxphacc += 2.0 * M_PI;
-
-	return z;
-}
-
 static void feld_rx(struct trx *trx, complex z)
 {
 	struct feld *s = (struct feld *) trx->modem;
@@ -73,7 +54,13 @@ static void feld_rx(struct trx *trx, complex z)
 		s->agc *= (1 - 0.02 / RxColumnLen);
 
 	x = 255 * CLAMP(1.0 - x / s->agc, 0.0, 1.0);
-	trx_put_rx_data((int) x);
+
+	s->rxpixbuf[s->rxpixptr++] = (int) x;
+
+	if (s->rxpixptr == RxPixBufLen) {
+		trx_put_rx_data_block(s->rxpixbuf, s->rxpixptr);
+		s->rxpixptr = 0;
+	}
 
 	trx->metric = s->agc / 10.0;
 }
@@ -81,31 +68,41 @@ static void feld_rx(struct trx *trx, complex z)
 int feld_rxprocess(struct trx *trx, float *buf, int len)
 {
 	struct feld *s = (struct feld *) trx->modem;
-	complex z, *zp;
-	int i, n;
+	complex zbuf[FILTER_BLOCKLEN], *zp;
+	int num, i, n;
 
 	if (trx->bandwidth != trx->hell_bandwidth) {
 		float lp = trx->hell_bandwidth / 2.0 / SampleRate;
 
-		fftfilt_set_freqs(s->fftfilt, 0, lp);
+		firfilt_set_freqs(s->filt, 0, lp);
 
 		trx->bandwidth = trx->hell_bandwidth;
 	}
 
-	while (len-- > 0) {
+	while (len > 0) {
+		num = MIN(len, FILTER_BLOCKLEN);
+
 		/* create analytic signal... */
-		c_re(z) = c_im(z) = *buf++;
+		hilbert_run(s->hilbert, buf, num, zbuf);
 
-		filter_run(s->hilbert, z, &z);
+		buf += num;
+		len -= num;
 
 		/* ...so it can be shifted in frequency */
-		z = mixer(trx, z);
+		nco_set_freq(&s->rxnco, -trx->frequency / SampleRate);
+		nco_mix(&s->rxnco, zbuf, zbuf, num);
 
-		n = fftfilt_run(s->fftfilt, z, &zp);
+		n = firfilt_run_block(s->filt, zbuf, num, &zp);
 
 		for (i = 0; i < n; i++)
 			feld_rx(trx, zp[i]);
 	}
 
+	/* publish the pixels of this block in one go */
+	if (s->rxpixptr > 0) {
+		trx_put_rx_data_block(s->rxpixbuf, s->rxpixptr);
+		s->rxpixptr = 0;
+	}
+
 	return 0;
 }
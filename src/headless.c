@@ -0,0 +1,304 @@
+/*
+ *    headless.c  --  GUI-free trx hooks for the offline decoder
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+
+#include "headless.h"
+#include "main.h"
+#include "conf.h"
+#include "snd.h"
+#include "picture.h"
+#include "ascii.h"
+
+/*
+ * Several files may be decoded at the same time by different threads
+ * so the decoder being run is a thread specific pointer.
+ */
+static pthread_key_t current_key;
+static pthread_once_t current_once = PTHREAD_ONCE_INIT;
+
+static void current_key_init(void)
+{
+	pthread_key_create(&current_key, NULL);
+}
+
+static inline struct headless *get_current(void)
+{
+	pthread_once(&current_once, current_key_init);
+	return pthread_getspecific(current_key);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void headless_init(struct headless *h, struct trx *trx, FILE *fp, gdouble ratio)
+{
+	h->trx = trx;
+	h->fp = fp;
+	h->ratio = ratio;
+	h->offset = 0;
+	h->line = g_string_new(NULL);
+	h->linestart = 0;
+	h->crflag = FALSE;
+	h->chars = 0;
+	h->txptr = NULL;
+	h->txbuf = NULL;
+}
+
+void headless_free(struct headless *h)
+{
+	if (h->line)
+		g_string_free(h->line, TRUE);
+
+	h->line = NULL;
+}
+
+void headless_set_current(struct headless *h)
+{
+	pthread_once(&current_once, current_key_init);
+	pthread_setspecific(current_key, h);
+}
+
+/*
+ * Print out the current line prefixed by the input sample offset
+ * of the block where it started.
+ */
+void headless_flush(struct headless *h)
+{
+	if (h->line->len == 0)
+		return;
+
+	fprintf(h->fp, "%10ld  %s\n",
+		(glong) (h->linestart * h->ratio),
+		h->line->str);
+
+	g_string_truncate(h->line, 0);
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Same rules as the receive window in main.c.
+ */
+void trx_put_rx_char(guint c)
+{
+	struct headless *h = get_current();
+
+	g_return_if_fail(h);
+
+	if (c == 0)
+		return;
+
+	/* CR-LF reduced to a single LF */
+	if (h->crflag && c == 10) {
+		h->crflag = FALSE;
+		return;
+	} else if (c == 13)
+		h->crflag = TRUE;
+
+	h->chars++;
+
+	if (c == 10 || c == 13) {
+		headless_flush(h);
+		return;
+	}
+
+	if (h->line->len == 0)
+		h->linestart = h->offset;
+
+	/* backspace is a special case */
+	if (c == 8) {
+		if (h->line->len > 0)
+			g_string_truncate(h->line, h->line->len - 1);
+		return;
+	}
+
+	if (c < 32)
+		g_string_append(h->line, ascii[c]);
+	else
+		g_string_append_c(h->line, c);
+}
+
+void trx_put_echo_char(guint c)
+{
+}
+
+void trx_put_rx_data(guint c)
+{
+}
+
+void trx_put_rx_data_block(const guchar *data, gint len)
+{
+}
+
+void trx_put_rx_picdata(guint c)
+{
+}
+
+void trx_put_rx_picdata_block(const guint *data, gint len)
+{
+}
+
+void trx_set_freq(gfloat freq)
+{
+	struct headless *h = get_current();
+
+	if (h)
+		h->trx->frequency = freq;
+}
+
+void trx_set_metric(gfloat metric)
+{
+	struct headless *h = get_current();
+
+	if (h)
+		h->trx->metric = metric;
+}
+
+void trx_set_scope(gfloat *data, gint len, gboolean autoscale)
+{
+}
+
+void trx_set_phase(gfloat phase, gboolean highlight)
+{
+}
+
+void trx_set_highlight(gboolean highlight)
+{
+}
+
+gint trx_get_samplerate(void)
+{
+	struct headless *h = get_current();
+
+	return h ? h->trx->samplerate : 8000;
+}
+
+/*
+ * The decoder only receives. The benchmark also transmits: it sets
+ * 'txptr' to the text to send and collects the samples in 'txbuf'.
+ */
+gunichar trx_get_tx_char(void)
+{
+	struct headless *h = get_current();
+
+	if (h == NULL || h->txptr == NULL)
+		return TRX_RX_CMD;
+
+	if (*h->txptr)
+		return (guchar) *h->txptr++;
+
+	/* all sent, let the modem flush and stop */
+	h->trx->stopflag = 1;
+
+	return -1;
+}
+
+gpointer trx_get_tx_picture(void)
+{
+	return NULL;
+}
+
+gint sound_write(gfloat *buf, gint count)
+{
+	struct headless *h = get_current();
+
+	if (h && h->txbuf)
+		g_array_append_vals(h->txbuf, buf, count);
+
+	return count;
+}
+
+void statusbar_set_main(const gchar *message)
+{
+}
+
+gchar *conf_get_string(const gchar *key)
+{
+	return "";
+}
+
+/* ---------------------------------------------------------------------- */
+
+gboolean picture_check_header(gchar *str, gint *w, gint *h, gboolean *color)
+{
+	gchar *p;
+
+	*w = 0;
+	*h = 0;
+	*color = FALSE;
+
+	if ((p = strstr(str, "Pic:")) == NULL)
+		return FALSE;
+
+	p += 4;
+
+	while (isdigit(*p))
+		*w = (*w * 10) + (*p++ - '0');
+
+	if (*p++ != 'x')
+		return FALSE;
+
+	while (isdigit(*p))
+		*h = (*h * 10) + (*p++ - '0');
+
+	if (*p == 'C') {
+		*color = TRUE;
+		p++;
+	}
+
+	if (*p != ';')
+		return FALSE;
+
+	if (*w == 0 || *h == 0 || *w > 4095 || *h > 4095)
+		return FALSE;
+
+	return TRUE;
+}
+
+gchar *picbuf_make_header(Picbuf *picbuf)
+{
+	return NULL;
+}
+
+gboolean picbuf_get_data(Picbuf *picbuf, guchar *data, gint *len)
+{
+	return FALSE;
+}
+
+gdouble picbuf_get_percentage(Picbuf *picbuf)
+{
+	return 0.0;
+}
+
+void picbuf_free(Picbuf *picbuf)
+{
+}
+
+/* ---------------------------------------------------------------------- */
@@ -0,0 +1,65 @@
+/*
+ *    headless.h  --  GUI-free trx hooks for the offline decoder
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _HEADLESS_H
+#define _HEADLESS_H
+
+#include <stdio.h>
+#include <glib.h>
+
+#include "trx.h"
+
+/*
+ * The modems talk to the rest of gmfsk through trx_put_rx_char(),
+ * trx_set_freq() and friends. The offline decoder links headless.c
+ * instead of trx.c and the GUI so the same modem code runs without
+ * a display or a sound card.
+ */
+struct headless {
+	struct trx *trx;
+	FILE *fp;
+
+	gdouble ratio;		/* input samples per modem sample */
+	glong offset;		/* modem sample offset of the current block */
+
+	GString *line;
+	glong linestart;
+	gboolean crflag;
+
+	glong chars;
+
+	/* when transmitting: text still to send and the samples sent */
+	const gchar *txptr;
+	GArray *txbuf;
+};
+
+extern void headless_init(struct headless *h, struct trx *trx,
+			  FILE *fp, gdouble ratio);
+extern void headless_free(struct headless *h);
+
+extern void headless_set_current(struct headless *h);
+
+extern void headless_flush(struct headless *h);
+
+#endif
@@ -61,6 +61,27 @@ static GnomeUIInfo file1_menu_uiinfo[] =
     GNOME_APP_PIXMAP_NONE, NULL,
     0, (GdkModifierType) 0, NULL
   },
+  {
+    GNOME_APP_UI_ITEM, N_("Add receive _channel"),
+    NULL,
+    (gpointer) on_add_channel1_activate, NULL, NULL,
+    GNOME_APP_PIXMAP_NONE, NULL,
+    0, (GdkModifierType) 0, NULL
+  },
+  {
+    GNOME_APP_UI_ITEM, N_("Re_move receive channels"),
+    NULL,
+    (gpointer) on_remove_channels1_activate, NULL, NULL,
+    GNOME_APP_PIXMAP_NONE, NULL,
+    0, (GdkModifierType) 0, NULL
+  },
+  {
+    GNOME_APP_UI_ITEM, N_("DSP _statistics..."),
+    NULL,
+    (gpointer) on_dsp_statistics1_activate, NULL, NULL,
+    GNOME_APP_PIXMAP_NONE, NULL,
+    0, (GdkModifierType) 0, NULL
+  },
   GNOMEUIINFO_SEPARATOR,
   GNOMEUIINFO_MENU_EXIT_ITEM (on_exit1_activate, NULL),
   GNOMEUIINFO_END
@@ -1129,8 +1150,11 @@ create_appwindow (void)
   GLADE_HOOKUP_OBJECT (appwindow, file1_menu_uiinfo[3].widget, "separator4");
   GLADE_HOOKUP_OBJECT (appwindow, file1_menu_uiinfo[4].widget, "clear_tx_window1");
   GLADE_HOOKUP_OBJECT (appwindow, file1_menu_uiinfo[5].widget, "clear_rx_window1");
-  GLADE_HOOKUP_OBJECT (appwindow, file1_menu_uiinfo[6].widget, "separator3");
-  GLADE_HOOKUP_OBJECT (appwindow, file1_menu_uiinfo[7].widget, "exit1");
+  GLADE_HOOKUP_OBJECT (appwindow, file1_menu_uiinfo[6].widget, "add_channel1");
+  GLADE_HOOKUP_OBJECT (appwindow, file1_menu_uiinfo[7].widget, "remove_channels1");
+  GLADE_HOOKUP_OBJECT (appwindow, file1_menu_uiinfo[8].widget, "dsp_statistics1");
+  GLADE_HOOKUP_OBJECT (appwindow, file1_menu_uiinfo[9].widget, "separator3");
+  GLADE_HOOKUP_OBJECT (appwindow, file1_menu_uiinfo[10].widget, "exit1");
   GLADE_HOOKUP_OBJECT (appwindow, menubar1_uiinfo[1].widget, "mode1");
   GLADE_HOOKUP_OBJECT (appwindow, mfsk1_uiinfo[0].widget, "mfsk1");
   GLADE_HOOKUP_OBJECT (appwindow, mfsk1_uiinfo[1].widget, "mfsk2");
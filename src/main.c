@@ -46,10 +46,13 @@
 #include "ptt.h"
 #include "picture.h"
 #include "fft.h"
+#include "firfilt.h"
 #include "hamlib.h"
 #include "cwirc.h"
 #include "snd.h"
 #include "qsodata.h"
+#include "stats.h"
+#include "chanbank.h"
 
 GtkWidget *appwindow;
 GtkWidget *WFPopupMenu;
@@ -294,10 +297,180 @@ void send_string(const gchar *str)
 	}
 }
 
+/*
+ * The GUI side of the TX queue. The first 'tx_queued' characters from
+ * the TX mark on (from the start of the Hell entry) have been handed
+ * to the trx, 'tx_sent' is the trx count the mark has been moved for.
+ * Characters are only locked when the modem has taken them, until then
+ * an edit takes them back from the trx.
+ */
+static guint tx_epoch = 0;
+static guint tx_sent = 0;
+static gint tx_queued = 0;
+static gboolean tx_locking = FALSE;
+
+static gboolean tx_hell_mode(void)
+{
+	gint mode = trx_get_mode();
+
+	return mode == MODE_FELDHELL || mode == MODE_FMHELL;
+}
+
+static gint tx_mark_offset(void)
+{
+	GtkTextMark *mark;
+	GtkTextIter iter;
+
+	mark = gtk_text_buffer_get_mark(txbuffer, "editablemark");
+	gtk_text_buffer_get_iter_at_mark(txbuffer, &iter, mark);
+
+	return gtk_text_iter_get_offset(&iter);
+}
+
+/*
+ * Lock the text the modem has taken since the last call: move the TX
+ * mark past it, or in Hell mode delete it from the entry.
+ */
+void sync_tx_text(void)
+{
+	GtkEditable *editable;
+	GtkTextIter iter1, iter2;
+	GtkTextMark *mark;
+	guint s;
+	gint n, pos;
+
+	s = trx_tx_state();
+
+	n = TRX_TX_SENT(TRX_TX_SENT(s) - tx_sent);
+	tx_sent = TRX_TX_SENT(s);
+
+	/* the trx took back the rest when it stopped */
+	if (TRX_TX_EPOCH(s) != tx_epoch) {
+		tx_epoch = TRX_TX_EPOCH(s);
+		tx_queued = n;
+	}
+
+	n = MIN(n, tx_queued);
+	tx_queued -= n;
+
+	if (n == 0)
+		return;
+
+	tx_locking = TRUE;
+
+	if (tx_hell_mode()) {
+		editable = GTK_EDITABLE(lookup_widget(appwindow, "txentry"));
+		pos = gtk_editable_get_position(editable);
+		gtk_editable_delete_text(editable, 0, n);
+		gtk_editable_set_position(editable, MAX(pos - n, 0));
+	} else {
+		mark = gtk_text_buffer_get_mark(txbuffer, "editablemark");
+		gtk_text_buffer_get_iter_at_mark(txbuffer, &iter1, mark);
+		gtk_text_iter_forward_chars(&iter1, n);
+
+		gtk_text_buffer_get_start_iter(txbuffer, &iter2);
+		gtk_text_buffer_apply_tag_by_name(txbuffer, "editabletag",
+						  &iter2, &iter1);
+		gtk_text_buffer_move_mark(txbuffer, mark, &iter1);
+	}
+
+	tx_locking = FALSE;
+}
+
+/*
+ * An edit of the characters from 'start' to 'end' is about to happen,
+ * 'lock' is where the editable text begins. If it touches queued text
+ * take that back from the trx. Returns FALSE if the edit hits text the
+ * modem has taken meanwhile, it has to be refused then.
+ */
+static gboolean tx_edit(gint lock, gint start, gint end, gboolean insert)
+{
+	guint s;
+	gint n;
+
+	if (tx_locking || tx_queued == 0)
+		return TRUE;
+
+	if (end <= lock || start >= lock + tx_queued)
+		return TRUE;
+
+	s = trx_tx_retract();
+	n = TRX_TX_SENT(TRX_TX_SENT(s) - tx_sent);
+	tx_epoch = TRX_TX_EPOCH(s);
+
+	/* clearing the window takes the sent text along */
+	if (!insert && start <= lock && end >= lock + n) {
+		tx_sent = TRX_TX_SENT(s);
+		tx_queued = 0;
+		return TRUE;
+	}
+
+	tx_queued = n;
+
+	return start >= lock + n;
+}
+
+static void tx_buffer_insert(GtkTextBuffer *buffer, GtkTextIter *iter,
+			     gchar *text, gint len, gpointer data)
+{
+	gint pos = gtk_text_iter_get_offset(iter);
+
+	if (tx_hell_mode())
+		return;
+
+	if (!tx_edit(tx_mark_offset(), pos, pos + 1, TRUE))
+		g_signal_stop_emission_by_name(buffer, "insert-text");
+}
+
+static void tx_buffer_delete(GtkTextBuffer *buffer, GtkTextIter *start,
+			     GtkTextIter *end, gpointer data)
+{
+	if (tx_hell_mode())
+		return;
+
+	if (!tx_edit(tx_mark_offset(), gtk_text_iter_get_offset(start),
+		     gtk_text_iter_get_offset(end), FALSE))
+		g_signal_stop_emission_by_name(buffer, "delete-range");
+}
+
+static void tx_entry_insert(GtkEditable *editable, gchar *text, gint len,
+			    gint *pos, gpointer data)
+{
+	if (!tx_hell_mode())
+		return;
+
+	if (!tx_edit(0, *pos, *pos + 1, TRUE))
+		g_signal_stop_emission_by_name(editable, "insert-text");
+}
+
+static void tx_entry_delete(GtkEditable *editable, gint start, gint end,
+			    gpointer data)
+{
+	if (!tx_hell_mode())
+		return;
+
+	if (!tx_edit(0, start, (end < 0) ? G_MAXINT : end, FALSE))
+		g_signal_stop_emission_by_name(editable, "delete-text");
+}
+
+/*
+ * Only the sent text is cleared, what was not sent yet stays for the
+ * next transmission.
+ */
 static gboolean clear_tx_text_idle_func(gpointer data)
 {
+	GtkTextIter iter1, iter2;
+	GtkTextMark *mark;
+
 	gdk_threads_enter();
-	gtk_text_buffer_set_text(txbuffer, "", -1);
+
+	sync_tx_text();
+
+	gtk_text_buffer_get_start_iter(txbuffer, &iter1);
+	mark = gtk_text_buffer_get_mark(txbuffer, "editablemark");
+	gtk_text_buffer_get_iter_at_mark(txbuffer, &iter2, mark);
+	gtk_text_buffer_delete(txbuffer, &iter1, &iter2);
+
 	gdk_threads_leave();
 
 	return FALSE;
@@ -308,6 +481,114 @@ void clear_tx_text(void)
 	g_idle_add(clear_tx_text_idle_func, NULL);
 }
 
+/*
+ * Check if 'str' contains any space characters or the RX_CMD character.
+ */
+static gboolean check_for_spaces(gchar *str)
+{
+	gunichar chr;
+
+	while (*str) {
+		chr = g_utf8_get_char(str);
+
+		if (g_unichar_isspace(chr) || chr == TRX_RX_CMD)
+			return TRUE;
+
+		str = g_utf8_next_char(str);
+	}
+
+	return FALSE;
+}
+
+/*
+ * Hand the next characters of the Hell TX entry to the trx. While
+ * transmitting only whole words are sent.
+ */
+static void tx_hell(gint count)
+{
+	GtkEditable *editable;
+	gunichar chr;
+	gchar *str;
+	gboolean spc;
+
+	editable = GTK_EDITABLE(lookup_widget(appwindow, "txentry"));
+
+	while (count-- > 0) {
+		str = gtk_editable_get_chars(editable, tx_queued, -1);
+
+		chr = g_utf8_get_char(str);
+		spc = check_for_spaces(str);
+
+		g_free(str);
+
+		if (chr == 0)
+			break;
+
+		if (spc == FALSE && trx_get_state() == TRX_STATE_TX)
+			break;
+
+		trx_put_tx_char(chr, tx_epoch);
+		tx_queued++;
+
+		if (chr == TRX_RX_CMD)
+			break;
+	}
+
+	str = gtk_editable_get_chars(editable, tx_queued, -1);
+	trx_tx_set_backlog(g_utf8_strlen(str, -1));
+	g_free(str);
+}
+
+/*
+ * Hand the text between the queued part and the cursor to the trx.
+ */
+static void tx_text(gint count)
+{
+	GtkTextIter iter1, iter2;
+	GtkTextMark *mark;
+	gunichar chr;
+
+	/* get the iterator at the end of the queued text */
+	mark = gtk_text_buffer_get_mark(txbuffer, "editablemark");
+	gtk_text_buffer_get_iter_at_mark(txbuffer, &iter1, mark);
+	gtk_text_iter_forward_chars(&iter1, tx_queued);
+
+	/* get the iterator at the insert mark */
+	mark = gtk_text_buffer_get_insert(txbuffer);
+	gtk_text_buffer_get_iter_at_mark(txbuffer, &iter2, mark);
+
+	while (count-- > 0 && gtk_text_iter_compare(&iter1, &iter2) < 0) {
+		chr = gtk_text_iter_get_char(&iter1);
+
+		if (chr == 0)
+			break;
+
+		trx_put_tx_char(chr, tx_epoch);
+		gtk_text_iter_forward_char(&iter1);
+		tx_queued++;
+
+		if (chr == TRX_RX_CMD)
+			break;
+	}
+
+	trx_tx_set_backlog(MAX(gtk_text_iter_get_offset(&iter2) -
+			       gtk_text_iter_get_offset(&iter1), 0));
+}
+
+static void tx_fill(void)
+{
+	gint count;
+
+	sync_tx_text();
+
+	count = trx_tx_wanted();
+
+	if (tx_hell_mode())
+		tx_hell(count);
+	else
+		tx_text(count);
+}
+
 /* ---------------------------------------------------------------------- */
 
 void insert_rx_text(gchar *tag, gchar *str, int len)
@@ -335,48 +616,48 @@ void insert_rx_text(gchar *tag, gchar *str, int len)
 	g_free(str);
 }
 
-static gboolean main_loop(gpointer unused)
+#define	RX_CHUNK	256
+
+static void rx_picture(void)
 {
-	static gboolean crflag = FALSE;
-	static guchar databuf[30];
-	static gint dataptr = 0;
-	gboolean textflag = FALSE;
-	gchar *p, *tag;
-	gint c;
+	guint buf[RX_CHUNK];
+	gint i, n, c;
 
-	gdk_threads_enter();
+	while ((n = trx_get_rx_picdata_block(buf, RX_CHUNK)) > 0) {
+		for (i = 0; i < n; i++) {
+			c = buf[i];
 
-	/*
-	 * Check for received picture data.
-	 */
-	while ((c = trx_get_rx_picdata()) >= 0) {
-		if ((c & 0xFF000000) > 0) {
-			gint width, height, color;
+			if ((c & 0xFF000000) > 0) {
+				gint width, height, color;
 
-			color  = (c & 0xFF000000) >> 24;
-			width  = (c & 0x00FFF000) >> 12;
-			height = (c & 0x00000FFF);
+				color  = (c & 0xFF000000) >> 24;
+				width  = (c & 0x00FFF000) >> 12;
+				height = (c & 0x00000FFF);
 
-			if (color == 'C')
-				color = 1;
-			else
-				color = 0;
+				if (color == 'C')
+					color = 1;
+				else
+					color = 0;
 
-			picture_start(width, height, color);
+				picture_start(width, height, color);
 
-			continue;
-		}
+				continue;
+			}
 
-		picture_write(c & 0xFF);
+			picture_write(c & 0xFF);
+		}
 	}
+}
 
-	/*
-	 * Check for received papertape data.
-	 */
-	while ((c = trx_get_rx_data()) >= 0) {
-		Papertape *t1, *t2;
+static void rx_papertape(void)
+{
+	static guchar databuf[30];
+	static gint dataptr = 0;
+	Papertape *t1, *t2;
+	gint c;
 
-		databuf[dataptr++] = c;
+	while ((c = trx_get_rx_data_block(databuf + dataptr, 30 - dataptr)) > 0) {
+		dataptr += c;
 
 		if (dataptr < 30)
 			continue;
@@ -403,81 +684,364 @@ static gboolean main_loop(gpointer unused)
 
 		dataptr = 0;
 	}
+}
+
+static gboolean rx_text(void)
+{
+	static gboolean crflag = FALSE;
+	gboolean textflag = FALSE;
+	guint buf[RX_CHUNK];
+	gchar *p, *tag;
+	gint i, n, c;
 
 	/*
-	 * Check for received characters.
+	 * Received characters.
 	 */
-	while ((c = trx_get_rx_char()) >= 0) {
-		if (c == 0)
-			continue;
+	while ((n = trx_get_rx_chars(buf, RX_CHUNK)) > 0) {
+		for (i = 0; i < n; i++) {
+			c = buf[i];
+
+			if (c == 0)
+				continue;
+
+			/* CR-LF reduced to a single LF */
+			if (crflag && c == 10) {
+				crflag = FALSE;
+				continue;
+			} else if (c == 13)
+				crflag = TRUE;
+
+			/* backspace is a special case */
+			if (c == 8) {
+				textbuffer_delete_end(rxbuffer, 1);
+				log_to_file(LOG_RX, "<BS>");
+				continue;
+			}
+
+			if (c < 32) {
+				p = g_strdup(ascii[c]);
+				tag = "hltag";
+			} else {
+				p = g_strdup_printf("%c", c);
+				tag = "rxtag";
+			}
+
+			insert_rx_text(tag, p, -1);
+			log_to_file(LOG_RX, p);
+			g_free(p);
+
+			textflag = TRUE;
+		}
+	}
 
-		/* CR-LF reduced to a single LF */
-		if (crflag && c == 10) {
-			crflag = FALSE;
-			continue;
-		} else if (c == 13)
-			crflag = TRUE;
+	/*
+	 * Transmitted characters.
+	 */
+	while ((n = trx_get_echo_chars(buf, RX_CHUNK)) > 0) {
+		for (i = 0; i < n; i++) {
+			c = buf[i];
+
+			if (c == 0)
+				continue;
+
+			/* backspace is a special case */
+			if (c == 8) {
+				textbuffer_delete_end(rxbuffer, 1);
+				log_to_file(LOG_TX, "<BS>");
+				continue;
+			}
+
+			if (c < 32)
+				p = g_strdup(ascii[c]);
+			else
+				p = g_strdup_printf("%c", c);
 
-		/* backspace is a special case */
-		if (c == 8) {
-			textbuffer_delete_end(rxbuffer, 1);
-			log_to_file(LOG_RX, "<BS>");
-			continue;
+			insert_rx_text("txtag", p, -1);
+			log_to_file(LOG_TX, p);
+			g_free(p);
+
+			textflag = TRUE;
 		}
+	}
 
-		if (c < 32) {
-			p = g_strdup(ascii[c]);
-			tag = "hltag";
-		} else {
-			p = g_strdup_printf("%c", c);
-			tag = "rxtag";
+	return textflag;
+}
+
+/*
+ * Text from the extra receive channels goes into the RX window a line
+ * at a time, prefixed with the channel mode and frequency. A line is
+ * put out at a newline, when it gets long, or when the channel has
+ * been quiet for a while.
+ */
+#define	CHAN_LINE_MAX		64
+#define	CHAN_LINE_IDLE		30	/* main_loop() ticks */
+
+struct rx_channel {
+	gint id;
+	gchar *name;
+	GString *line;
+	gint idle;
+};
+
+static struct rx_channel rx_channels[CHANBANK_MAX_CHANNELS];
+static gint rx_nchannels = 0;
+
+static gboolean rx_channel_flush(struct rx_channel *ch)
+{
+	GtkTextIter end;
+
+	if (ch->line->len == 0)
+		return FALSE;
+
+	/* start on a line of its own */
+	gtk_text_buffer_get_end_iter(rxbuffer, &end);
+	if (!gtk_text_iter_starts_line(&end))
+		insert_rx_text("rxtag", "\n", -1);
+
+	insert_rx_text("hltag", ch->name, -1);
+	insert_rx_text("rxtag", ch->line->str, -1);
+	insert_rx_text("rxtag", "\n", -1);
+
+	g_string_truncate(ch->line, 0);
+	ch->idle = 0;
+
+	return TRUE;
+}
+
+static gboolean rx_channel_text(void)
+{
+	struct rx_channel *ch;
+	gboolean textflag = FALSE;
+	guint buf[RX_CHUNK];
+	gint i, j, n, c;
+
+	for (i = 0; i < rx_nchannels; i++) {
+		ch = &rx_channels[i];
+
+		while ((n = chanbank_get_rx_chars(ch->id, buf, RX_CHUNK)) > 0) {
+			ch->idle = 0;
+
+			for (j = 0; j < n; j++) {
+				c = buf[j];
+
+				if (c == 8) {
+					if (ch->line->len > 0)
+						g_string_truncate(ch->line,
+								  ch->line->len - 1);
+					continue;
+				}
+
+				if (c == 10 || c == 13) {
+					textflag |= rx_channel_flush(ch);
+					continue;
+				}
+
+				if (c < 32)
+					continue;
+
+				g_string_append_c(ch->line, c);
+
+				if (ch->line->len >= CHAN_LINE_MAX)
+					textflag |= rx_channel_flush(ch);
+			}
 		}
+	}
+
+	return textflag;
+}
 
-		insert_rx_text(tag, p, -1);
-		log_to_file(LOG_RX, p);
-		g_free(p);
+static gboolean rx_channel_idle(void)
+{
+	struct rx_channel *ch;
+	gboolean textflag = FALSE;
+	gint i;
 
-		textflag = TRUE;
+	for (i = 0; i < rx_nchannels; i++) {
+		ch = &rx_channels[i];
+
+		if (ch->line->len > 0 && ++ch->idle >= CHAN_LINE_IDLE)
+			textflag |= rx_channel_flush(ch);
 	}
 
-	/*
-	 * Check for transmitted characters.
-	 */
-	while ((c = trx_get_echo_char()) >= 0) {
-		if (c == 0)
+	return textflag;
+}
+
+static void rx_channel_status(void)
+{
+	gchar *str;
+
+	str = g_strdup_printf(_("%d extra receive channels"),
+			      chanbank_get_count());
+	statusbar_set_main(str);
+	g_free(str);
+}
+
+static void rx_channel_add(trx_mode_t mode, gfloat freq)
+{
+	struct rx_channel *ch;
+	gint id;
+
+	if ((id = chanbank_add(mode, freq)) < 0)
+		return;
+
+	ch = &rx_channels[rx_nchannels++];
+	ch->id = id;
+	ch->name = g_strdup_printf("[%s %.0f] ", trx_mode_names[mode], freq);
+	ch->line = g_string_new(NULL);
+	ch->idle = 0;
+}
+
+/*
+ * Start the extra receive channels given as a comma separated list
+ * of MODE:FREQ pairs, e.g. "RTTY:1500,BPSK31:1000".
+ */
+static void rx_channel_init(const gchar *list)
+{
+	gchar **v, **p, *s;
+	gint mode;
+
+	v = g_strsplit(list, ",", 0);
+
+	for (p = v; *p; p++) {
+		if ((s = strchr(*p, ':')) == NULL) {
+			g_warning(_("Invalid channel '%s'\n"), *p);
 			continue;
+		}
+
+		*s++ = 0;
+		g_strstrip(*p);
 
-		/* backspace is a special case */
-		if (c == 8) {
-			textbuffer_delete_end(rxbuffer, 1);
-			log_to_file(LOG_TX, "<BS>");
+		if ((mode = trx_mode_from_name(*p)) < 0) {
+			g_warning(_("Invalid channel mode '%s'\n"), *p);
 			continue;
 		}
 
-		if (c < 32)
-			p = g_strdup(ascii[c]);
-		else
-			p = g_strdup_printf("%c", c);
+		rx_channel_add(mode, g_ascii_strtod(s, NULL));
+	}
+
+	g_strfreev(v);
+}
+
+/*
+ * Receive the current mode at the current frequency on an extra
+ * channel too.
+ */
+void add_rx_channel(void)
+{
+	rx_channel_add(trx_get_mode(), trx_get_freq());
+	rx_channel_status();
+}
+
+/*
+ * Remove the extra channels, what they had received so far is put out
+ * first.
+ */
+void clear_rx_channels(void)
+{
+	struct rx_channel *ch;
+	gint i;
 
-		insert_rx_text("txtag", p, -1);
-		log_to_file(LOG_TX, p);
-		g_free(p);
+	rx_channel_text();
 
-		textflag = TRUE;
+	for (i = 0; i < rx_nchannels; i++) {
+		ch = &rx_channels[i];
+
+		rx_channel_flush(ch);
+
+		g_free(ch->name);
+		g_string_free(ch->line, TRUE);
 	}
 
-	if (textflag == TRUE)
+	rx_nchannels = 0;
+	chanbank_clear();
+
+	textview_scroll_end(rxtextview);
+	rx_channel_status();
+}
+
+/*
+ * The trx thread wakes up the main loop whenever it has published
+ * something in the receive rings or wants more text to transmit. This
+ * source then drains the receive rings and refills the transmit one.
+ */
+static gboolean rx_source_prepare(GSource *source, gint *timeout)
+{
+	*timeout = -1;
+	return trx_rx_pending() || trx_tx_pending();
+}
+
+static gboolean rx_source_check(GSource *source)
+{
+	return trx_rx_pending() || trx_tx_pending();
+}
+
+static gboolean rx_source_dispatch(GSource *source,
+				   GSourceFunc callback,
+				   gpointer data)
+{
+	gboolean textflag;
+
+	/* acknowledge first so that anything arriving later wakes us again */
+	trx_rx_ack();
+	trx_tx_ack();
+
+	gdk_threads_enter();
+
+	tx_fill();
+
+	rx_picture();
+	rx_papertape();
+
+	textflag = rx_text();
+	textflag |= rx_channel_text();
+
+	if (textflag)
 		textview_scroll_end(rxtextview);
 
+	gdk_threads_leave();
+
+	return TRUE;
+}
+
+static GSourceFuncs rx_source_funcs = {
+	rx_source_prepare,
+	rx_source_check,
+	rx_source_dispatch,
+	NULL
+};
+
+static void rx_source_init(void)
+{
+	GSource *source;
+
+	source = g_source_new(&rx_source_funcs, sizeof(GSource));
+	g_source_attach(source, NULL);
+	g_source_unref(source);
+}
+
+/*
+ * The metric dial and the frequency display are still polled.
+ */
+static gboolean main_loop(gpointer unused)
+{
+	guint64 t = stats_time();
+
+	gdk_threads_enter();
+
 	gtk_dial_set_value(metricdial, trx_get_metric());
 
 	if (!GTK_WIDGET_HAS_FOCUS(freqspinbutton))
 		gtk_spin_button_set_value(freqspinbutton, trx_get_freq());
 
+	if (rx_channel_idle())
+		textview_scroll_end(rxtextview);
+
 	gdk_threads_leave();
 
 	waterfall_set_bandwidth(waterfall, trx_get_bandwidth());
 
+	stats_add(STATS_MAIN_LOOP, t, 0, 0);
+
 	return TRUE;
 }
 
@@ -532,6 +1096,7 @@ static gint rundruid = 0;
 static gint cwircshmid = 0;
 static gchar *testmode = "none";
 static gint modem = -1;
+static gchar *channels = NULL;
 
 static const struct poptOption options[] =
 {
@@ -541,6 +1106,9 @@ static const struct poptOption options[] =
 	{ "run-druid", '\0', POPT_ARG_NONE, &rundruid, 1,
 	  N_("Run first-time configuration druid"), NULL },
 
+	{ "channels", '\0', POPT_ARG_STRING, &channels, 1,
+	  N_("Also receive on the given channels"), N_("MODE:FREQ,...") },
+
 	{ "cwirc", '\0', POPT_ARG_INT, &cwircshmid, 1,
 	  N_("Enable CWirc slave mode"), N_("SHMID") },
 
@@ -568,13 +1136,61 @@ GtkWidget *find_menu_item(const gchar *path)
 	return w2;
 }
 
+/*
+ * FFTW lengths used by the modems: MFSK8/MFSK16 symbol FFTs and the
+ * fast convolution filters of MFSK, CW, Feld Hell, RTTY and Throb.
+ */
+static const gint fft_lengths[] = { 256, 512, 1024, 2048, 8192 };
+
+/*
+ * The (length, decimation) pairs of those filters, for firfilt to
+ * pick the faster engine for.
+ */
+static const gint filter_sizes[] = {
+	129, 1,			/* MFSK */
+	513, 8,			/* CW */
+	513, 1,			/* Feld Hell */
+	1025, 1,		/* RTTY */
+	4097, 32		/* Throb */
+};
+
+static void save_wisdom(void)
+{
+	gchar *wisdom;
+
+	wisdom = fft_get_wisdom();
+	conf_set_string("misc/fftwwisdom", wisdom);
+	fftw_free(wisdom);
+}
+
+static gboolean save_wisdom_idle(gpointer unused)
+{
+	if (fft_wisdom_changed())
+		save_wisdom();
+
+	return FALSE;
+}
+
+/*
+ * Called on the planner thread. The filter engines are timed only now
+ * so that FFTW_MEASURE and the timings do not compete for the CPUs and
+ * skew each other, the tuning picked is kept in the config.
+ */
+static void preplan_done(void)
+{
+	g_idle_add(save_wisdom_idle, NULL);
+
+	/* time the filter engines not timed on earlier runs */
+	firfilt_pretune(filter_sizes, G_N_ELEMENTS(filter_sizes) / 2);
+}
+
 int main(int argc, char *argv[])
 {
 	GtkStatusbar *statusbar;
 	GnomeUIInfo *uiinfo;
 	GtkTextIter iter;
 	GtkTextTag *tag;
-	gchar *wisdom;
+	gchar *wisdom, *tuning;
 
 #ifdef ENABLE_NLS
 	bindtextdomain(GETTEXT_PACKAGE, PACKAGE_LOCALE_DIR);
@@ -609,6 +1225,14 @@ int main(int argc, char *argv[])
 		g_warning(_("FFTW wisdom not found. This is normal if you are running gMFSK for the first time."));
 	g_free(wisdom);
 
+	/* filter engines timed on earlier runs */
+	tuning = conf_get_string("misc/filtertuning");
+	firfilt_set_tuning(tuning);
+	g_free(tuning);
+
+	/* plan the modem FFTs while the GUI comes up */
+	fft_preplan(fft_lengths, G_N_ELEMENTS(fft_lengths), preplan_done);
+
 	/* create main window */
 	appwindow = create_appwindow();
 
@@ -676,6 +1300,16 @@ int main(int argc, char *argv[])
 	gtk_text_buffer_get_start_iter(txbuffer, &iter);
 	gtk_text_buffer_create_mark(txbuffer, "editablemark", &iter, TRUE);
 
+	/* edits of text queued for TX take it back from the trx */
+	g_signal_connect(G_OBJECT(txbuffer), "insert-text",
+			 G_CALLBACK(tx_buffer_insert), NULL);
+	g_signal_connect(G_OBJECT(txbuffer), "delete-range",
+			 G_CALLBACK(tx_buffer_delete), NULL);
+	g_signal_connect(G_OBJECT(lookup_widget(appwindow, "txentry")),
+			 "insert-text", G_CALLBACK(tx_entry_insert), NULL);
+	g_signal_connect(G_OBJECT(lookup_widget(appwindow, "txentry")),
+			 "delete-text", G_CALLBACK(tx_entry_delete), NULL);
+
 	/* load config files and configure things */
 	conf_load();
 	macroconfig_load();
@@ -710,6 +1344,7 @@ int main(int argc, char *argv[])
 
 	/* initialize the trx queues */
 	trx_init_queues();
+	rx_source_init();
 
 	/* start the trx thread */
 	trx_set_state(TRX_STATE_RX);
@@ -718,6 +1353,10 @@ int main(int argc, char *argv[])
 	waterfall_set_center_frequency(waterfall, 1500.0);
 	waterfall_set_bandwidth(waterfall, trx_get_bandwidth());
 
+	/* the extra receive channels */
+	if (channels)
+		rx_channel_init(channels);
+
 	if (cwirc_extension_mode) {
 		GtkWidget *w;
 
@@ -792,15 +1431,21 @@ int main(int argc, char *argv[])
 	gdk_threads_leave();
 
 	ptt_close();
+	chanbank_shutdown();
 
 #if WANT_HAMLIB
 	hamlib_close();
 #endif
 	log_to_file_activate(FALSE);
 
-	wisdom = fft_get_wisdom();
-	conf_set_string("misc/fftwwisdom", wisdom);
-	fftw_free(wisdom);
+	if (fft_wisdom_changed())
+		save_wisdom();
+
+	if (firfilt_tuning_changed()) {
+		tuning = firfilt_get_tuning();
+		conf_set_string("misc/filtertuning", tuning);
+		g_free(tuning);
+	}
 
 	conf_set_int("misc/lastmode", trx_get_mode());
 
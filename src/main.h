@@ -59,6 +59,10 @@ extern void send_char(gunichar c);
 extern void send_string(const gchar *str);
 
 extern void clear_tx_text(void);
+extern void sync_tx_text(void);
+
+extern void add_rx_channel(void);
+extern void clear_rx_channels(void);
 
 extern void textview_insert_pixbuf(gchar *name, GdkPixbuf *pixbuf);
 
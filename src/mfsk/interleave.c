@@ -37,6 +37,9 @@ struct interleave *interleave_init(int size, int dir)
 {
 	struct interleave *s;
 
+	if (size < 1 || size > INTERLEAVE_MAXSIZE)
+		return NULL;
+
 	s = g_new0(struct interleave, 1);
 
 	s->table = g_new0(unsigned char, 10 * size * size);
@@ -55,43 +58,73 @@ void interleave_free(struct interleave *s)
 	}
 }
 
-static inline unsigned char *tab(struct interleave *s, int i, int j, int k)
+/*
+ * Each of the 10 stages is a size x size table whose columns form a
+ * ring: 'ptr' is the physical column of the oldest symbol and the
+ * newest one goes in the column just before it. Adding a symbol
+ * overwrites the oldest column instead of shifting the whole table.
+ */
+static inline unsigned char *row(struct interleave *s, int k, int i)
 {
-	return &s->table[(s->size * s->size * i) + (s->size * j) + k];
+	return &s->table[(s->size * s->size * k) + (s->size * i)];
 }
 
-void interleave_syms(struct interleave *s, unsigned char *syms)
+static inline void interleave_one(struct interleave *s, unsigned char *syms)
 {
-	int i, j, k;
+	unsigned char col[INTERLEAVE_MAXSIZE];
+	unsigned char *r;
+	int i, k, w, c;
+
+	w = s->ptr;
+	s->ptr = (s->ptr + 1) % s->size;
+
+	/*
+	 * The forward direction reads the anti-diagonal, the reverse
+	 * one the diagonal, both relative to the oldest column.
+	 */
+	for (i = 0; i < s->size; i++) {
+		if (s->direction == INTERLEAVE_FWD)
+			c = s->ptr + s->size - i - 1;
+		else
+			c = s->ptr + i;
+
+		col[i] = (c >= s->size) ? c - s->size : c;
+	}
 
 	for (k = 0; k < 10; k++) {
-		for (i = 0; i < s->size; i++)
-			for (j = 0; j < s->size - 1; j++)
-				*tab(s, k, i, j) = *tab(s, k, i, j + 1);
-
-		for (i = 0; i < s->size; i++)
-			*tab(s, k, i, s->size - 1) = syms[i];
-
 		for (i = 0; i < s->size; i++) {
-			if (s->direction == INTERLEAVE_FWD)
-				syms[i] = *tab(s, k, i, s->size - i - 1);
-			else
-				syms[i] = *tab(s, k, i, i);
+			r = row(s, k, i);
+			r[w] = syms[i];
+			syms[i] = r[col[i]];
 		}
 	}
 }
 
+void interleave_syms(struct interleave *s, unsigned char *syms)
+{
+	interleave_one(s, syms);
+}
+
+/*
+ * Interleave 'nsyms' consecutive symbols of 'size' bits each.
+ */
+void interleave_block(struct interleave *s, unsigned char *syms, int nsyms)
+{
+	int n;
+
+	for (n = 0; n < nsyms; n++, syms += s->size)
+		interleave_one(s, syms);
+}
+
 void interleave_bits(struct interleave *s, unsigned int *bits)
 {
-	unsigned char *syms;
+	unsigned char syms[INTERLEAVE_MAXSIZE];
 	int i;
 
-	syms = g_alloca(s->size * sizeof(unsigned char));
-
 	for (i = 0; i < s->size; i++)
 		syms[i] = (*bits >> (s->size - i - 1)) & 1;
 
-	interleave_syms(s, syms);
+	interleave_one(s, syms);
 
 	for (*bits = i = 0; i < s->size; i++)
 		*bits = (*bits << 1) | syms[i];
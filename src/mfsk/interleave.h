@@ -30,15 +30,19 @@
 #define	INTERLEAVE_FWD	0
 #define	INTERLEAVE_REV	1
 
+#define	INTERLEAVE_MAXSIZE	32
+
 struct interleave {
 	int size;
 	int direction;
+	int ptr;
 	unsigned char *table;
 };
 
 extern struct interleave *interleave_init(int size, int dir);
 extern void interleave_free(struct interleave *s);
 extern void interleave_syms(struct interleave *s, unsigned char *syms);
+extern void interleave_block(struct interleave *s, unsigned char *syms, int nsyms);
 extern void interleave_bits(struct interleave *s, unsigned int *bits);
 
 /* ---------------------------------------------------------------------- */
@@ -29,7 +29,8 @@
 #include "trx.h"
 #include "fft.h"
 #include "sfft.h"
-#include "filter.h"
+#include "firfilt.h"
+#include "hilbert.h"
 #include "interleave.h"
 #include "viterbi.h"
 
@@ -54,6 +55,8 @@ static void mfsk_rxinit(struct trx *trx)
 	m->met2 = 0.0;
 
 	m->counter = 0;
+
+	nco_init(&m->rxnco, 0.0);
 }
 
 static void mfsk_free(struct mfsk *s)
@@ -61,7 +64,7 @@ static void mfsk_free(struct mfsk *s)
 	if (s) {
 		fft_free(s->fft);
 		sfft_free(s->sfft);
-		filter_free(s->hilbert);
+		hilbert_free(s->hilbert);
 
 		g_free(s->pipe);
 
@@ -69,7 +72,7 @@ static void mfsk_free(struct mfsk *s)
 		viterbi_free(s->dec1);
 		viterbi_free(s->dec2);
 
-		filter_free(s->filt);
+		firfilt_free(s->filt);
 
 		g_free(s);
 	}
@@ -116,6 +119,13 @@ void mfsk_init(struct trx *trx)
 	}
 
 	s->numtones = 1 << s->symbits;
+
+	if (s->numtones > MFSK_MAX_TONES) {
+		g_warning("mfsk_init: too many tones\n");
+		mfsk_free(s);
+		return;
+	}
+
 	s->tonespacing = (double) SampleRate / s->symlen;
 
 	if (!(s->fft = fft_init(s->symlen, FFT_FWD))) {
@@ -128,7 +138,7 @@ void mfsk_init(struct trx *trx)
 		mfsk_free(s);
 		return;
 	}
-	if (!(s->hilbert = filter_init_hilbert(37, 1))) {
+	if (!(s->hilbert = hilbert_init(37))) {
 		g_warning("mfsk_init: init_hilbert failed\n");
 		mfsk_free(s);
 		return;
@@ -173,8 +183,8 @@ void mfsk_init(struct trx *trx)
 	flo = (cf - bw) / SampleRate;
 	fhi = (cf + bw) / SampleRate;
 
-	if ((s->filt = filter_init_bandpass(127, 1, flo, fhi)) == NULL) {
-		g_warning("mfsk_init: filter_init failed\n");
+	if ((s->filt = firfilt_init(flo, fhi, 129, 1)) == NULL) {
+		g_warning("mfsk_init: firfilt_init failed\n");
 		mfsk_free(s);
 		return;
 	}
@@ -26,30 +26,36 @@
 #define _MFSK_H
 
 #include "cmplx.h"
+#include "nco.h"
 #include "trx.h"
 #include "viterbi.h"
 #include "interleave.h"
-#include "fftfilt.h"
+#include "firfilt.h"
 #include "delay.h"
 #include "picture.h"
 
 #define	SampleRate		(8000)
 #define	SAMPLES_PER_PIXEL	(SampleRate / 1000)	/* 1 ms per pixel */
+#define	RXPICBUFLEN		64
+
+#define	MFSK_MAX_TONES		32	/* MFSK8 */
 
 #define	K	7
 #define	POLY1	0x6d
 #define	POLY2	0x4f
 
 struct rxpipe {
-	complex vector[32];	/* numtones <= 32 */
-	int symbol;
+	float vector[MFSK_MAX_TONES];	/* tone magnitudes */
 };
 
+#define PIPE_STRIDE	(sizeof(struct rxpipe) / sizeof(float))
+
 struct mfsk {
 	/*
 	 * Common stuff
 	 */
 	double phaseacc;
+	struct nco rxnco;
 
 	int symlen;
 	int symbits;
@@ -64,10 +70,10 @@ struct mfsk {
 	 */
 	int rxstate;
 
-	struct filter *hilbert;
+	struct hilbert *hilbert;
 	struct sfft *sfft;
 
-	struct filter *filt;
+	struct firfilt *filt;
 
 	struct viterbi *dec1;
 	struct viterbi *dec2;
@@ -99,6 +105,9 @@ struct mfsk {
 	complex prevz;
 	double picf;
 
+	guint rxpicbuf[RXPICBUFLEN];
+	int rxpicptr;
+
 	int symbolbit;
 
 	/*
@@ -47,11 +47,25 @@ char *alloca ();
 
 #include "mfsk.h"
 #include "filter.h"
+#include "firfilt.h"
+#include "hilbert.h"
 #include "sfft.h"
+#include "cvec.h"
 #include "varicode.h"
 #include "misc.h"
 #include "picture.h"
 
+/*
+ * Picture pixels are collected and handed over a block at a time.
+ */
+static void flushpic(struct mfsk *m)
+{
+	if (m->rxpicptr > 0) {
+		trx_put_rx_picdata_block(m->rxpicbuf, m->rxpicptr);
+		m->rxpicptr = 0;
+	}
+}
+
 static void recvpic(struct trx *trx, complex z)
 {
 	struct mfsk *m = (struct mfsk *) trx->modem;
@@ -62,7 +76,10 @@ static void recvpic(struct trx *trx, complex z)
 	if ((m->counter % SAMPLES_PER_PIXEL) == 0) {
 		m->picf = 256 * (m->picf / SAMPLES_PER_PIXEL - 1000) / trx->bandwidth;
 
-		trx_put_rx_picdata(CLAMP(m->picf, 0.0, 255.0));
+		m->rxpicbuf[m->rxpicptr++] = CLAMP(m->picf, 0.0, 255.0);
+
+		if (m->rxpicptr == RXPICBUFLEN)
+			flushpic(m);
 
 		m->picf = 0.0;
 	}
@@ -90,6 +107,8 @@ static void recvchar(struct mfsk *m, int c)
 		m->picturesize = SAMPLES_PER_PIXEL * w * h * (color ? 3 : 1);
 		m->counter = 0;
 
+		flushpic(m);
+
 		if (color)
 			trx_put_rx_picdata(('C' << 24) | (w << 12) | h);
 		else
@@ -164,16 +183,22 @@ static void decodesymbol(struct trx *trx, unsigned char symbol)
 //		m->met1, m->met2, m->met1 > m->met2 ? 1 : 2);
 }
 
-static void softdecode(struct trx *trx, complex *bins)
+static void softdecode(struct trx *trx)
 {
 	struct mfsk *m = (struct mfsk *) trx->modem;
 	float tone, sum, *b;
+	double mag[MFSK_MAX_TONES];
 	unsigned char *symbols;
 	int i, j, k;
 
+	g_return_if_fail(m->numtones <= MFSK_MAX_TONES);
+
 	b = alloca(m->symbits * sizeof(float));
 	symbols = alloca(m->symbits * sizeof(unsigned char));
 
+	cvec_mag(m->sfft->binr + m->basetone, m->sfft->bini + m->basetone,
+		 mag, m->numtones);
+
 	for (i = 0; i < m->symbits; i++)
 		b[i] = 0.0;
 
@@ -189,7 +214,7 @@ static void softdecode(struct trx *trx, complex *bins)
 		else
 			k = i;
 
-		tone = cmod(bins[k + m->basetone]);
+		tone = mag[k];
 
 		for (k = 0; k < m->symbits; k++)
 			b[k] += (j & (1 << (m->symbits - k - 1))) ? tone : -tone;
@@ -213,48 +238,12 @@ static void softdecode(struct trx *trx, complex *bins)
 	}
 }
 
-static complex mixer(struct trx *trx, complex in)
-{
-	struct mfsk *m = (struct mfsk *) trx->modem;
-	complex z;
-	float f;
-
-	f = trx->frequency - trx->bandwidth / 2;
-
-	/* Basetone is always 1000 Hz */
-	f -= 1000.0;
-
-	c_re(z) = cos(m->phaseacc);
-	c_im(z) = sin(m->phaseacc);
-
-	z = cmul(z, in);
-
-	m->phaseacc -= 2.0 * M_PI * f / SampleRate;
-
-	if (m->phaseacc > M_PI)
-		m->phaseacc -= 2.0 * M_PI;
-	else if (m->phaseacc < M_PI)
-		m->phaseacc += 2.0 * M_PI;
-
-	return z;
-}
-
-static int harddecode(struct trx *trx, complex *in)
+static int harddecode(struct trx *trx)
 {
 	struct mfsk *m = (struct mfsk *) trx->modem;
-	double x, max = 0.0;
-	int i, symbol = 0;
-
-	in += m->basetone;
 
-	for (i = 0; i < m->numtones; i++) {
-		if ((x = cmod(in[i])) > max) {
-			max = x;
-			symbol = i;
-		}
-	}
-
-	return symbol;
+	return cvec_argmax(m->sfft->binr + m->basetone,
+			   m->sfft->bini + m->basetone, m->numtones);
 }
 
 static void update_syncscope(struct mfsk *m)
@@ -266,7 +255,7 @@ static void update_syncscope(struct mfsk *m)
 
 	for (i = 0; i < 2 * m->symlen; i++) {
 		j = (i + m->pipeptr) % (2 * m->symlen);
-		data[i] = cmod(m->pipe[j].vector[m->prev1symbol]);
+		data[i] = m->pipe[j].vector[m->prev1symbol];
 	}
 
 	trx_set_scope(data, 2 * m->symlen, TRUE);
@@ -285,7 +274,7 @@ static void synchronize(struct mfsk *m)
 	j = m->pipeptr;
 
 	for (i = 0; i < 2 * m->symlen; i++) {
-		val = cmod(m->pipe[j].vector[m->prev1symbol]);
+		val = m->pipe[j].vector[m->prev1symbol];
 
 		if (val > max) {
 			max = val;
@@ -317,80 +306,153 @@ static void afc(struct trx *trx)
 		trx_set_freq(trx->frequency + (x / 8.0));
 }
 
-int mfsk_rxprocess(struct trx *trx, float *buf, int len)
+/*
+ * Run samples through the sliding FFT, storing the tone magnitudes
+ * after each one in the next row of the pipe. The pipe pointer is
+ * left at the row of the last sample.
+ */
+static void sfft_to_pipe(struct mfsk *m, complex *z, int n)
+{
+	int k;
+
+	for (;;) {
+		k = MIN(n, 2 * m->symlen - m->pipeptr);
+
+		sfft_run_block(m->sfft, z, k, m->pipe[m->pipeptr].vector, PIPE_STRIDE);
+
+		z += k;
+		n -= k;
+
+		if (n == 0)
+			break;
+
+		m->pipeptr = 0;
+	}
+
+	m->pipeptr += k - 1;
+}
+
+/*
+ * A symbol has been received, the pipe pointer is at its last sample.
+ */
+static void rxsymbol(struct trx *trx)
 {
 	struct mfsk *m = (struct mfsk *) trx->modem;
-	complex z, *bins;
-	int i;
 
-	while (len-- > 0) {
-		/* create analytic signal... */
-		c_re(z) = c_im(z) = *buf++;
+	m->synccounter = m->symlen;
 
-		filter_run(m->hilbert, z, &z);
+	m->currsymbol = harddecode(trx);
 
-		/* ...so it can be shifted in frequency */
-		z = mixer(trx, z);
+	c_re(m->currvector) = m->sfft->binr[m->currsymbol + m->basetone];
+	c_im(m->currvector) = m->sfft->bini[m->currsymbol + m->basetone];
+
+	/* decode symbol */
+	softdecode(trx);
+
+	/* update the scope */
+	update_syncscope(m);
+
+	/* symbol sync */
+	synchronize(m);
 
-		filter_run(m->filt, z, &z);
+	/* frequency tracking */
+	afc(trx);
 
+	m->prev2symbol = m->prev1symbol;
+	m->prev2vector = m->prev1vector;
+	m->prev1symbol = m->currsymbol;
+	m->prev1vector = m->currvector;
+}
+
+/*
+ * Run samples through the picture states until back to data.
+ * Returns the number of samples used.
+ */
+static int rxpicture(struct trx *trx, complex *z, int n)
+{
+	struct mfsk *m = (struct mfsk *) trx->modem;
+	int j;
+
+	for (j = 0; j < n && m->rxstate != RX_STATE_DATA; j++) {
 		if (m->rxstate == RX_STATE_PICTURE_START_2) {
 			if (m->counter++ == 352) {
 				m->counter = 0;
 				m->rxstate = RX_STATE_PICTURE;
 			}
-			continue;
-		}
-		if (m->rxstate == RX_STATE_PICTURE_START_1) {
+		} else if (m->rxstate == RX_STATE_PICTURE_START_1) {
 			if (m->counter++ == 352 + m->symlen) {
 				m->counter = 0;
 				m->rxstate = RX_STATE_PICTURE;
 			}
-			continue;
-		}
-
-		if (m->rxstate == RX_STATE_PICTURE) {
+		} else if (m->rxstate == RX_STATE_PICTURE) {
 			if (m->counter++ == m->picturesize) {
 				m->counter = 0;
 				m->rxstate = RX_STATE_DATA;
 			} else
-				recvpic(trx, z);
-			continue;
+				recvpic(trx, z[j]);
 		}
+	}
 
-		/* feed it to the sliding FFT */
-		bins = sfft_run(m->sfft, z);
+	return j;
+}
 
-		/* copy current vector to the pipe */
-		for (i = 0; i < m->numtones; i++)
-			m->pipe[m->pipeptr].vector[i] = bins[i + m->basetone];
+int mfsk_rxprocess(struct trx *trx, float *buf, int len)
+{
+	struct mfsk *m = (struct mfsk *) trx->modem;
+	complex zbuf[FILTER_BLOCKLEN], *zp;
+	int j, k, n, num;
+	float f;
 
-		if (--m->synccounter <= 0) {
-			m->synccounter = m->symlen;
+	while (len > 0) {
+		/*
+		 * The AFC may move the mixer at the end of a symbol,
+		 * so don't let a block run past the next symbol.
+		 */
+		num = MIN(len, FILTER_BLOCKLEN);
+		num = MIN(num, MAX(m->synccounter, 1));
 
-			m->currsymbol = harddecode(trx, bins);
-			m->currvector = bins[m->currsymbol + m->basetone];
+		/* Basetone is always 1000 Hz */
+		f = trx->frequency - trx->bandwidth / 2 - 1000.0;
+		nco_set_freq(&m->rxnco, -f / SampleRate);
 
-			/* decode symbol */
-			softdecode(trx, bins);
+		/* create analytic signal... */
+		hilbert_run(m->hilbert, buf, num, zbuf);
 
-			/* update the scope */
-			update_syncscope(m);
+		/* ...so it can be shifted in frequency */
+		nco_mix(&m->rxnco, zbuf, zbuf, num);
 
-			/* symbol sync */
-			synchronize(m);
+		n = firfilt_run_block(m->filt, zbuf, num, &zp);
 
-			/* frequency tracking */
-			afc(trx);
+		buf += num;
+		len -= num;
 
-			m->prev2symbol = m->prev1symbol;
-			m->prev2vector = m->prev1vector;
-			m->prev1symbol = m->currsymbol;
-			m->prev1vector = m->currvector;
-		}
+		for (j = 0; j < n; ) {
+			/* picture states, until back to data */
+			j += rxpicture(trx, zp + j, n - j);
+
+			/*
+			 * Feed the data to the sliding FFT. The filter may
+			 * give back more samples than it got, so split them
+			 * at the symbol ends, and stop when a symbol starts
+			 * a picture.
+			 */
+			while (j < n && m->rxstate == RX_STATE_DATA) {
+				k = MIN(n - j, MAX(m->synccounter, 1));
+
+				sfft_to_pipe(m, zp + j, k);
+
+				j += k;
+				m->synccounter -= k;
 
-		m->pipeptr = (m->pipeptr + 1) % (2 * m->symlen);
+				if (m->synccounter <= 0)
+					rxsymbol(trx);
+
+				m->pipeptr = (m->pipeptr + 1) % (2 * m->symlen);
+			}
+		}
 	}
 
+	flushpic(m);
+
 	return 0;
 }
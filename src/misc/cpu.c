@@ -0,0 +1,61 @@
+/*
+ *    cpu.c  --  CPU feature detection
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "cpu.h"
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Returns the CPU_* flags of the SIMD extensions the CPU and the
+ * operating system support. The result is computed only once but
+ * calling this from several threads at once is harmless.
+ */
+guint cpu_features(void)
+{
+	static volatile guint features = CPU_UNKNOWN;
+	guint f = 0;
+
+	if (features != CPU_UNKNOWN)
+		return features;
+
+#ifdef HAVE_X86_SIMD
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("sse2"))
+		f |= CPU_SSE2;
+	if (__builtin_cpu_supports("avx")) {
+		f |= CPU_AVX;
+		if (__builtin_cpu_supports("fma"))
+			f |= CPU_FMA;
+		if (__builtin_cpu_supports("avx2"))
+			f |= CPU_AVX2;
+	}
+#endif
+
+	features = f;
+
+	return f;
+}
+
+/* ---------------------------------------------------------------------- */
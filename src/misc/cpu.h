@@ -0,0 +1,48 @@
+/*
+ *    cpu.h  --  CPU feature detection
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _CPU_H
+#define _CPU_H
+
+#include <glib.h>
+
+/*
+ * Set when the compiler can build SIMD code for single functions
+ * with __attribute__ ((target(...))), so that the rest of the
+ * program still runs on CPUs without those instructions.
+ */
+#if (defined(__i386__) || defined(__x86_64__)) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define HAVE_X86_SIMD
+#endif
+
+#define CPU_SSE2	(1 << 0)
+#define CPU_AVX		(1 << 1)
+#define CPU_FMA		(1 << 2)
+#define CPU_AVX2	(1 << 3)
+#define CPU_UNKNOWN	(1U << 31)
+
+extern guint cpu_features(void);
+
+#endif				/* _CPU_H */
@@ -0,0 +1,650 @@
+/*
+ *    cvec.c  --  Complex vector kernels on split arrays
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "cvec.h"
+#include "cpu.h"
+
+#ifdef HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * a[i] * b[i], or conj(a[i]) * b[i] when 'conj' is set.
+ */
+static inline void term(gdouble ar, gdouble ai, gdouble br, gdouble bi,
+			gboolean conj, gdouble *tr, gdouble *ti)
+{
+	if (conj) {
+		*tr = ar * br + ai * bi;
+		*ti = ar * bi - ai * br;
+	} else {
+		*tr = ar * br - ai * bi;
+		*ti = ar * bi + ai * br;
+	}
+}
+
+static inline complex dot_generic(const gdouble *ar, const gdouble *ai,
+				  const gdouble *br, const gdouble *bi,
+				  guint len, gboolean conj)
+{
+	gdouble sr[4] = { 0.0, 0.0, 0.0, 0.0 };
+	gdouble si[4] = { 0.0, 0.0, 0.0, 0.0 };
+	gdouble tr, ti;
+	complex z;
+	guint i, k;
+
+	for (i = 0; i + 4 <= len; i += 4) {
+		for (k = 0; k < 4; k++) {
+			term(ar[i + k], ai[i + k], br[i + k], bi[i + k],
+			     conj, &tr, &ti);
+			sr[k] += tr;
+			si[k] += ti;
+		}
+	}
+
+	c_re(z) = (sr[0] + sr[2]) + (sr[1] + sr[3]);
+	c_im(z) = (si[0] + si[2]) + (si[1] + si[3]);
+
+	for (; i < len; i++) {
+		term(ar[i], ai[i], br[i], bi[i], conj, &tr, &ti);
+		c_re(z) += tr;
+		c_im(z) += ti;
+	}
+
+	return z;
+}
+
+static complex cvec_dot_generic(const gdouble *ar, const gdouble *ai,
+				const gdouble *br, const gdouble *bi,
+				guint len)
+{
+	return dot_generic(ar, ai, br, bi, len, FALSE);
+}
+
+static complex cvec_corr_generic(const gdouble *ar, const gdouble *ai,
+				 const gdouble *br, const gdouble *bi,
+				 guint len)
+{
+	return dot_generic(ar, ai, br, bi, len, TRUE);
+}
+
+static void cvec_cmac_generic(const gdouble *ar, const gdouble *ai,
+			      const gdouble *br, const gdouble *bi,
+			      gdouble *accr, gdouble *acci, guint len)
+{
+	gdouble tr, ti;
+	guint i;
+
+	for (i = 0; i < len; i++) {
+		term(ar[i], ai[i], br[i], bi[i], FALSE, &tr, &ti);
+		accr[i] += tr;
+		acci[i] += ti;
+	}
+}
+
+static void cvec_power_generic(const gdouble *re, const gdouble *im,
+			       gdouble *out, guint len)
+{
+	guint i;
+
+	for (i = 0; i < len; i++)
+		out[i] = re[i] * re[i] + im[i] * im[i];
+}
+
+static void cvec_mag_generic(const gdouble *re, const gdouble *im,
+			     gdouble *out, guint len)
+{
+	guint i;
+
+	for (i = 0; i < len; i++)
+		out[i] = sqrt(re[i] * re[i] + im[i] * im[i]);
+}
+
+static guint cvec_argmax_generic(const gdouble *re, const gdouble *im,
+				 guint len)
+{
+	gdouble x, max = 0.0;
+	guint i, n = 0;
+
+	for (i = 0; i < len; i++) {
+		if ((x = re[i] * re[i] + im[i] * im[i]) > max) {
+			max = x;
+			n = i;
+		}
+	}
+
+	return n;
+}
+
+/* ---------------------------------------------------------------------- */
+
+#ifdef HAVE_X86_SIMD
+
+__attribute__ ((target("sse2")))
+static inline gdouble hsum_pd(__m128d v)
+{
+	return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+__attribute__ ((target("sse2")))
+static inline void term_sse2(__m128d ar, __m128d ai, __m128d br, __m128d bi,
+			     gboolean conj, __m128d *tr, __m128d *ti)
+{
+	if (conj) {
+		*tr = _mm_add_pd(_mm_mul_pd(ar, br), _mm_mul_pd(ai, bi));
+		*ti = _mm_sub_pd(_mm_mul_pd(ar, bi), _mm_mul_pd(ai, br));
+	} else {
+		*tr = _mm_sub_pd(_mm_mul_pd(ar, br), _mm_mul_pd(ai, bi));
+		*ti = _mm_add_pd(_mm_mul_pd(ar, bi), _mm_mul_pd(ai, br));
+	}
+}
+
+/* partial sums 0,1 in the first register and 2,3 in the second */
+__attribute__ ((target("sse2")))
+static inline complex dot_sse2(const gdouble *ar, const gdouble *ai,
+			       const gdouble *br, const gdouble *bi,
+			       guint len, gboolean conj)
+{
+	__m128d sr0 = _mm_setzero_pd(), sr1 = _mm_setzero_pd();
+	__m128d si0 = _mm_setzero_pd(), si1 = _mm_setzero_pd();
+	__m128d tr, ti;
+	gdouble r, s;
+	complex z;
+	guint i;
+
+	for (i = 0; i + 4 <= len; i += 4) {
+		term_sse2(_mm_loadu_pd(ar + i), _mm_loadu_pd(ai + i),
+			  _mm_loadu_pd(br + i), _mm_loadu_pd(bi + i),
+			  conj, &tr, &ti);
+		sr0 = _mm_add_pd(sr0, tr);
+		si0 = _mm_add_pd(si0, ti);
+
+		term_sse2(_mm_loadu_pd(ar + i + 2), _mm_loadu_pd(ai + i + 2),
+			  _mm_loadu_pd(br + i + 2), _mm_loadu_pd(bi + i + 2),
+			  conj, &tr, &ti);
+		sr1 = _mm_add_pd(sr1, tr);
+		si1 = _mm_add_pd(si1, ti);
+	}
+
+	c_re(z) = hsum_pd(_mm_add_pd(sr0, sr1));
+	c_im(z) = hsum_pd(_mm_add_pd(si0, si1));
+
+	for (; i < len; i++) {
+		term(ar[i], ai[i], br[i], bi[i], conj, &r, &s);
+		c_re(z) += r;
+		c_im(z) += s;
+	}
+
+	return z;
+}
+
+__attribute__ ((target("sse2")))
+static complex cvec_dot_sse2(const gdouble *ar, const gdouble *ai,
+			     const gdouble *br, const gdouble *bi, guint len)
+{
+	return dot_sse2(ar, ai, br, bi, len, FALSE);
+}
+
+__attribute__ ((target("sse2")))
+static complex cvec_corr_sse2(const gdouble *ar, const gdouble *ai,
+			      const gdouble *br, const gdouble *bi, guint len)
+{
+	return dot_sse2(ar, ai, br, bi, len, TRUE);
+}
+
+__attribute__ ((target("sse2")))
+static void cvec_cmac_sse2(const gdouble *ar, const gdouble *ai,
+			   const gdouble *br, const gdouble *bi,
+			   gdouble *accr, gdouble *acci, guint len)
+{
+	__m128d tr, ti;
+	guint i;
+
+	for (i = 0; i + 2 <= len; i += 2) {
+		term_sse2(_mm_loadu_pd(ar + i), _mm_loadu_pd(ai + i),
+			  _mm_loadu_pd(br + i), _mm_loadu_pd(bi + i),
+			  FALSE, &tr, &ti);
+		_mm_storeu_pd(accr + i, _mm_add_pd(_mm_loadu_pd(accr + i), tr));
+		_mm_storeu_pd(acci + i, _mm_add_pd(_mm_loadu_pd(acci + i), ti));
+	}
+
+	cvec_cmac_generic(ar + i, ai + i, br + i, bi + i,
+			  accr + i, acci + i, len - i);
+}
+
+__attribute__ ((target("sse2")))
+static inline __m128d power_sse2(const gdouble *re, const gdouble *im)
+{
+	__m128d r = _mm_loadu_pd(re);
+	__m128d i = _mm_loadu_pd(im);
+
+	return _mm_add_pd(_mm_mul_pd(r, r), _mm_mul_pd(i, i));
+}
+
+__attribute__ ((target("sse2")))
+static void cvec_power_sse2(const gdouble *re, const gdouble *im,
+			    gdouble *out, guint len)
+{
+	guint i;
+
+	for (i = 0; i + 2 <= len; i += 2)
+		_mm_storeu_pd(out + i, power_sse2(re + i, im + i));
+
+	cvec_power_generic(re + i, im + i, out + i, len - i);
+}
+
+__attribute__ ((target("sse2")))
+static void cvec_mag_sse2(const gdouble *re, const gdouble *im,
+			  gdouble *out, guint len)
+{
+	guint i;
+
+	for (i = 0; i + 2 <= len; i += 2)
+		_mm_storeu_pd(out + i, _mm_sqrt_pd(power_sse2(re + i, im + i)));
+
+	cvec_mag_generic(re + i, im + i, out + i, len - i);
+}
+
+/*
+ * Each lane keeps its first maximum and the index of it. The lanes
+ * are then merged preferring the lower index on equal values, and
+ * the leftover elements, which come after all of those, go last.
+ */
+__attribute__ ((target("sse2")))
+static guint cvec_argmax_sse2(const gdouble *re, const gdouble *im,
+			      guint len)
+{
+	__m128d max = _mm_setzero_pd();
+	__m128d idx = _mm_setzero_pd();
+	__m128d cur = _mm_set_pd(1.0, 0.0);
+	__m128d two = _mm_set1_pd(2.0);
+	__m128d x, gt;
+	gdouble m[2], k[2], y;
+	guint i, n;
+
+	for (i = 0; i + 2 <= len; i += 2) {
+		x = power_sse2(re + i, im + i);
+		gt = _mm_cmpgt_pd(x, max);
+		max = _mm_or_pd(_mm_and_pd(gt, x), _mm_andnot_pd(gt, max));
+		idx = _mm_or_pd(_mm_and_pd(gt, cur), _mm_andnot_pd(gt, idx));
+		cur = _mm_add_pd(cur, two);
+	}
+
+	_mm_storeu_pd(m, max);
+	_mm_storeu_pd(k, idx);
+
+	if (m[1] > m[0] || (m[1] == m[0] && k[1] < k[0])) {
+		m[0] = m[1];
+		k[0] = k[1];
+	}
+
+	n = (guint) k[0];
+
+	for (; i < len; i++) {
+		if ((y = re[i] * re[i] + im[i] * im[i]) > m[0]) {
+			m[0] = y;
+			n = i;
+		}
+	}
+
+	return n;
+}
+
+__attribute__ ((target("avx")))
+static inline void term_avx(__m256d ar, __m256d ai, __m256d br, __m256d bi,
+			    gboolean conj, __m256d *tr, __m256d *ti)
+{
+	if (conj) {
+		*tr = _mm256_add_pd(_mm256_mul_pd(ar, br), _mm256_mul_pd(ai, bi));
+		*ti = _mm256_sub_pd(_mm256_mul_pd(ar, bi), _mm256_mul_pd(ai, br));
+	} else {
+		*tr = _mm256_sub_pd(_mm256_mul_pd(ar, br), _mm256_mul_pd(ai, bi));
+		*ti = _mm256_add_pd(_mm256_mul_pd(ar, bi), _mm256_mul_pd(ai, br));
+	}
+}
+
+__attribute__ ((target("avx")))
+static inline gdouble hsum_avx(__m256d v)
+{
+	return hsum_pd(_mm_add_pd(_mm256_castpd256_pd128(v),
+				  _mm256_extractf128_pd(v, 1)));
+}
+
+__attribute__ ((target("avx")))
+static inline complex dot_avx(const gdouble *ar, const gdouble *ai,
+			      const gdouble *br, const gdouble *bi,
+			      guint len, gboolean conj)
+{
+	__m256d sr = _mm256_setzero_pd(), si = _mm256_setzero_pd();
+	__m256d tr, ti;
+	gdouble r, s;
+	complex z;
+	guint i;
+
+	for (i = 0; i + 4 <= len; i += 4) {
+		term_avx(_mm256_loadu_pd(ar + i), _mm256_loadu_pd(ai + i),
+			 _mm256_loadu_pd(br + i), _mm256_loadu_pd(bi + i),
+			 conj, &tr, &ti);
+		sr = _mm256_add_pd(sr, tr);
+		si = _mm256_add_pd(si, ti);
+	}
+
+	c_re(z) = hsum_avx(sr);
+	c_im(z) = hsum_avx(si);
+
+	for (; i < len; i++) {
+		term(ar[i], ai[i], br[i], bi[i], conj, &r, &s);
+		c_re(z) += r;
+		c_im(z) += s;
+	}
+
+	return z;
+}
+
+__attribute__ ((target("avx")))
+static complex cvec_dot_avx(const gdouble *ar, const gdouble *ai,
+			    const gdouble *br, const gdouble *bi, guint len)
+{
+	return dot_avx(ar, ai, br, bi, len, FALSE);
+}
+
+__attribute__ ((target("avx")))
+static complex cvec_corr_avx(const gdouble *ar, const gdouble *ai,
+			     const gdouble *br, const gdouble *bi, guint len)
+{
+	return dot_avx(ar, ai, br, bi, len, TRUE);
+}
+
+__attribute__ ((target("avx")))
+static void cvec_cmac_avx(const gdouble *ar, const gdouble *ai,
+			  const gdouble *br, const gdouble *bi,
+			  gdouble *accr, gdouble *acci, guint len)
+{
+	__m256d tr, ti;
+	guint i;
+
+	for (i = 0; i + 4 <= len; i += 4) {
+		term_avx(_mm256_loadu_pd(ar + i), _mm256_loadu_pd(ai + i),
+			 _mm256_loadu_pd(br + i), _mm256_loadu_pd(bi + i),
+			 FALSE, &tr, &ti);
+		_mm256_storeu_pd(accr + i,
+				 _mm256_add_pd(_mm256_loadu_pd(accr + i), tr));
+		_mm256_storeu_pd(acci + i,
+				 _mm256_add_pd(_mm256_loadu_pd(acci + i), ti));
+	}
+
+	cvec_cmac_generic(ar + i, ai + i, br + i, bi + i,
+			  accr + i, acci + i, len - i);
+}
+
+__attribute__ ((target("avx")))
+static inline __m256d power_avx(const gdouble *re, const gdouble *im)
+{
+	__m256d r = _mm256_loadu_pd(re);
+	__m256d i = _mm256_loadu_pd(im);
+
+	return _mm256_add_pd(_mm256_mul_pd(r, r), _mm256_mul_pd(i, i));
+}
+
+__attribute__ ((target("avx")))
+static void cvec_power_avx(const gdouble *re, const gdouble *im,
+			   gdouble *out, guint len)
+{
+	guint i;
+
+	for (i = 0; i + 4 <= len; i += 4)
+		_mm256_storeu_pd(out + i, power_avx(re + i, im + i));
+
+	cvec_power_generic(re + i, im + i, out + i, len - i);
+}
+
+__attribute__ ((target("avx")))
+static void cvec_mag_avx(const gdouble *re, const gdouble *im,
+			 gdouble *out, guint len)
+{
+	guint i;
+
+	for (i = 0; i + 4 <= len; i += 4)
+		_mm256_storeu_pd(out + i, _mm256_sqrt_pd(power_avx(re + i, im + i)));
+
+	cvec_mag_generic(re + i, im + i, out + i, len - i);
+}
+
+__attribute__ ((target("avx")))
+static guint cvec_argmax_avx(const gdouble *re, const gdouble *im,
+			     guint len)
+{
+	__m256d max = _mm256_setzero_pd();
+	__m256d idx = _mm256_setzero_pd();
+	__m256d cur = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+	__m256d four = _mm256_set1_pd(4.0);
+	__m256d x, gt;
+	gdouble m[4], k[4], y;
+	guint i, j, n;
+
+	for (i = 0; i + 4 <= len; i += 4) {
+		x = power_avx(re + i, im + i);
+		gt = _mm256_cmp_pd(x, max, _CMP_GT_OQ);
+		max = _mm256_blendv_pd(max, x, gt);
+		idx = _mm256_blendv_pd(idx, cur, gt);
+		cur = _mm256_add_pd(cur, four);
+	}
+
+	_mm256_storeu_pd(m, max);
+	_mm256_storeu_pd(k, idx);
+
+	for (j = 1; j < 4; j++) {
+		if (m[j] > m[0] || (m[j] == m[0] && k[j] < k[0])) {
+			m[0] = m[j];
+			k[0] = k[j];
+		}
+	}
+
+	n = (guint) k[0];
+
+	for (; i < len; i++) {
+		if ((y = re[i] * re[i] + im[i] * im[i]) > m[0]) {
+			m[0] = y;
+			n = i;
+		}
+	}
+
+	return n;
+}
+
+#endif				/* HAVE_X86_SIMD */
+
+/* ---------------------------------------------------------------------- */
+
+void cvec_split(const complex *in, gdouble *re, gdouble *im, guint len)
+{
+	guint i;
+
+	for (i = 0; i < len; i++) {
+		re[i] = c_re(in[i]);
+		im[i] = c_im(in[i]);
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+
+struct cvec_impl {
+	const gchar *name;
+	guint features;
+	complex (*dot) (const gdouble *, const gdouble *,
+			const gdouble *, const gdouble *, guint);
+	complex (*corr) (const gdouble *, const gdouble *,
+			 const gdouble *, const gdouble *, guint);
+	void (*cmac) (const gdouble *, const gdouble *,
+		      const gdouble *, const gdouble *,
+		      gdouble *, gdouble *, guint);
+	void (*power) (const gdouble *, const gdouble *, gdouble *, guint);
+	void (*mag) (const gdouble *, const gdouble *, gdouble *, guint);
+	guint (*argmax) (const gdouble *, const gdouble *, guint);
+};
+
+/*
+ * In order of preference.
+ */
+static const struct cvec_impl cvec_impls[] = {
+#ifdef HAVE_X86_SIMD
+	{ "avx",	CPU_AVX,
+	  cvec_dot_avx, cvec_corr_avx, cvec_cmac_avx,
+	  cvec_power_avx, cvec_mag_avx, cvec_argmax_avx },
+	{ "sse2",	CPU_SSE2,
+	  cvec_dot_sse2, cvec_corr_sse2, cvec_cmac_sse2,
+	  cvec_power_sse2, cvec_mag_sse2, cvec_argmax_sse2 },
+#endif
+	{ "generic",	0,
+	  cvec_dot_generic, cvec_corr_generic, cvec_cmac_generic,
+	  cvec_power_generic, cvec_mag_generic, cvec_argmax_generic },
+};
+
+#define N_IMPLS	(sizeof(cvec_impls) / sizeof(cvec_impls[0]))
+
+static const struct cvec_impl *cvec_impl = NULL;
+
+static complex cvec_dot_first(const gdouble *ar, const gdouble *ai,
+			      const gdouble *br, const gdouble *bi, guint len)
+{
+	cvec_init();
+	return cvec_dot(ar, ai, br, bi, len);
+}
+
+static complex cvec_corr_first(const gdouble *ar, const gdouble *ai,
+			       const gdouble *br, const gdouble *bi, guint len)
+{
+	cvec_init();
+	return cvec_corr(ar, ai, br, bi, len);
+}
+
+static void cvec_cmac_first(const gdouble *ar, const gdouble *ai,
+			    const gdouble *br, const gdouble *bi,
+			    gdouble *accr, gdouble *acci, guint len)
+{
+	cvec_init();
+	cvec_cmac(ar, ai, br, bi, accr, acci, len);
+}
+
+static void cvec_power_first(const gdouble *re, const gdouble *im,
+			     gdouble *out, guint len)
+{
+	cvec_init();
+	cvec_power(re, im, out, len);
+}
+
+static void cvec_mag_first(const gdouble *re, const gdouble *im,
+			   gdouble *out, guint len)
+{
+	cvec_init();
+	cvec_mag(re, im, out, len);
+}
+
+static guint cvec_argmax_first(const gdouble *re, const gdouble *im,
+			       guint len)
+{
+	cvec_init();
+	return cvec_argmax(re, im, len);
+}
+
+complex (*cvec_dot)(const gdouble *ar, const gdouble *ai,
+		    const gdouble *br, const gdouble *bi,
+		    guint len) = cvec_dot_first;
+
+complex (*cvec_corr)(const gdouble *ar, const gdouble *ai,
+		     const gdouble *br, const gdouble *bi,
+		     guint len) = cvec_corr_first;
+
+void (*cvec_cmac)(const gdouble *ar, const gdouble *ai,
+		  const gdouble *br, const gdouble *bi,
+		  gdouble *accr, gdouble *acci, guint len) = cvec_cmac_first;
+
+void (*cvec_power)(const gdouble *re, const gdouble *im,
+		   gdouble *out, guint len) = cvec_power_first;
+
+void (*cvec_mag)(const gdouble *re, const gdouble *im,
+		 gdouble *out, guint len) = cvec_mag_first;
+
+guint (*cvec_argmax)(const gdouble *re, const gdouble *im,
+		     guint len) = cvec_argmax_first;
+
+/*
+ * Pick the implementation. Calling this more than once, even from
+ * several threads at the same time, is harmless as every call makes
+ * the same choice.
+ */
+void cvec_init(void)
+{
+	const struct cvec_impl *impl = NULL;
+	const gchar *want;
+	guint i, cpu;
+
+	cpu = cpu_features();
+	want = getenv("GMFSK_CVEC");
+
+	for (i = 0; i < N_IMPLS; i++) {
+		if ((cvec_impls[i].features & cpu) != cvec_impls[i].features)
+			continue;
+
+		if (want && strcmp(want, cvec_impls[i].name))
+			continue;
+
+		impl = &cvec_impls[i];
+		break;
+	}
+
+	if (!impl) {
+		g_warning("cvec_init: '%s' not available\n", want);
+		impl = &cvec_impls[N_IMPLS - 1];
+	}
+
+	cvec_dot = impl->dot;
+	cvec_corr = impl->corr;
+	cvec_cmac = impl->cmac;
+	cvec_power = impl->power;
+	cvec_mag = impl->mag;
+	cvec_argmax = impl->argmax;
+
+	cvec_impl = impl;
+}
+
+const gchar *cvec_name(void)
+{
+	if (!cvec_impl)
+		cvec_init();
+
+	return cvec_impl->name;
+}
+
+/* ---------------------------------------------------------------------- */
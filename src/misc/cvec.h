@@ -0,0 +1,78 @@
+/*
+ *    cvec.h  --  Complex vector kernels on split arrays
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _CVEC_H
+#define _CVEC_H
+
+#include <glib.h>
+
+#include "cmplx.h"
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Complex vector kernels for the demodulators. The vectors are kept
+ * as separate arrays of real and imaginary parts (re[i] + j im[i]),
+ * which is what SIMD wants. Like mac.h these point to the fastest
+ * implementation the CPU supports, chosen the first time one of them
+ * is called; GMFSK_CVEC set to "generic", "sse2" or "avx" forces one.
+ *
+ * All implementations do the same double precision operations in the
+ * same order, so they give identical results. The sums are kept in
+ * four partial sums, element i going to sum i % 4, which are added
+ * as (s0 + s2) + (s1 + s3) before the last len % 4 elements.
+ */
+
+/* sum of a[i] * b[i] */
+extern complex (*cvec_dot)(const gdouble *ar, const gdouble *ai,
+			   const gdouble *br, const gdouble *bi, guint len);
+
+/* sum of conj(a[i]) * b[i], the ccor() of every pair added up */
+extern complex (*cvec_corr)(const gdouble *ar, const gdouble *ai,
+			    const gdouble *br, const gdouble *bi, guint len);
+
+/* acc[i] += a[i] * b[i] */
+extern void (*cvec_cmac)(const gdouble *ar, const gdouble *ai,
+			 const gdouble *br, const gdouble *bi,
+			 gdouble *accr, gdouble *acci, guint len);
+
+/* out[i] = cpwr(a[i]) */
+extern void (*cvec_power)(const gdouble *re, const gdouble *im,
+			  gdouble *out, guint len);
+
+/* out[i] = cmod(a[i]) */
+extern void (*cvec_mag)(const gdouble *re, const gdouble *im,
+			gdouble *out, guint len);
+
+/* index of the first a[i] with the largest power, 0 if len is 0 */
+extern guint (*cvec_argmax)(const gdouble *re, const gdouble *im, guint len);
+
+/* split interleaved complex numbers into separate arrays */
+extern void cvec_split(const complex *in, gdouble *re, gdouble *im, guint len);
+
+extern void cvec_init(void);
+extern const gchar *cvec_name(void);
+
+/* ---------------------------------------------------------------------- */
+#endif				/* _CVEC_H */
@@ -0,0 +1,120 @@
+/*
+ *    decimator.c  --  Decimating FIR filter
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <string.h>
+
+#include "decimator.h"
+#include "filter.h"
+#include "mac.h"
+
+/* ---------------------------------------------------------------------- */
+
+struct decimator *decimator_init(gint len, gint factor, const gfloat *taps)
+{
+	struct decimator *d;
+
+	g_return_val_if_fail(len > 0 && factor > 0, NULL);
+
+	d = g_new0(struct decimator, 1);
+
+	d->length = len;
+	d->factor = factor;
+
+	d->taps = g_memdup(taps, len * sizeof(gfloat));
+
+	d->ibuffer = g_new0(gfloat, len + FILTER_BLOCKLEN);
+	d->qbuffer = g_new0(gfloat, len + FILTER_BLOCKLEN);
+
+	d->counter = 0;
+
+	return d;
+}
+
+void decimator_free(struct decimator *d)
+{
+	if (d) {
+		g_free(d->taps);
+		g_free(d->ibuffer);
+		g_free(d->qbuffer);
+		g_free(d);
+	}
+}
+
+/*
+ * Take 'taps' (the decimator keeps them) in place of the current ones.
+ * They are swapped in whole, never half written.
+ */
+void decimator_set_taps(struct decimator *d, gfloat *taps)
+{
+	gfloat *old = d->taps;
+
+	d->taps = taps;
+	g_free(old);
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Run 'n' samples through the filter and store the outputs in 'out',
+ * which may be the same array as 'in'. Returns the number of outputs.
+ *
+ * Like filter_run(), an output is due on every 'factor'th input and
+ * is taken over the 'length' samples preceding that input, so the
+ * two give identical results for the same taps.
+ */
+gint decimator_run(struct decimator *d, const complex *in, gint n, complex *out)
+{
+	gfloat *ibuf = d->ibuffer;
+	gfloat *qbuf = d->qbuffer;
+	gint len = d->length;
+	gint i, k, num, m = 0;
+
+	while (n > 0) {
+		num = MIN(n, FILTER_BLOCKLEN);
+
+		for (i = 0; i < num; i++) {
+			ibuf[len + i] = c_re(in[i]);
+			qbuf[len + i] = c_im(in[i]);
+		}
+
+		/* index of the first input that produces an output */
+		k = d->factor - d->counter - 1;
+
+		for (i = k; i < num; i += d->factor)
+			out[m++] = mac_iq(ibuf + i, qbuf + i,
+					  d->taps, d->taps, len);
+
+		d->counter = (d->counter + num) % d->factor;
+
+		memmove(ibuf, ibuf + num, len * sizeof(gfloat));
+		memmove(qbuf, qbuf + num, len * sizeof(gfloat));
+
+		in += num;
+		n -= num;
+	}
+
+	return m;
+}
+
+/* ---------------------------------------------------------------------- */
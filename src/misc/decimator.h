@@ -0,0 +1,58 @@
+/*
+ *    decimator.h  --  Decimating FIR filter
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _DECIMATOR_H
+#define _DECIMATOR_H
+
+#include <glib.h>
+
+#include "cmplx.h"
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * A complex FIR filter that only computes the outputs it keeps.
+ * Input is taken a block at a time into a linear history buffer,
+ * so the samples in between output instants cost one store each.
+ */
+struct decimator {
+	gint length;
+	gint factor;
+
+	gfloat *taps;
+
+	gfloat *ibuffer;
+	gfloat *qbuffer;
+
+	gint counter;
+};
+
+extern struct decimator *decimator_init(gint len, gint factor, const gfloat *taps);
+extern void decimator_free(struct decimator *d);
+extern void decimator_set_taps(struct decimator *d, gfloat *taps);
+
+extern gint decimator_run(struct decimator *d, const complex *in, gint n, complex *out);
+
+/* ---------------------------------------------------------------------- */
+#endif				/* _DECIMATOR_H */
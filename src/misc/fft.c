@@ -28,6 +28,7 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <pthread.h>
 
 #include "fft.h"
 #include "misc.h"
@@ -36,6 +37,58 @@
 
 #define	FLAGS	(FFTW_MEASURE | FFTW_OUT_OF_PLACE | FFTW_USE_WISDOM)
 
+/*
+ * Plans are cached process wide and shared by every struct fft of the
+ * same length and direction. Executing a plan is reentrant in FFTW,
+ * only the planner (and the wisdom it uses) is not, so plan creation
+ * is serialized. Cached plans live until the program exits.
+ */
+struct fft_plan {
+	gint len;
+	gint dir;
+	gint flags;
+	fftw_plan plan;
+	struct fft_plan *next;
+};
+
+static struct fft_plan *plan_cache = NULL;
+static pthread_mutex_t plan_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static gboolean wisdom_changed = FALSE;
+
+static fftw_plan plan_get(gint len, gint dir, gint flags)
+{
+	struct fft_plan *p;
+	fftw_plan plan;
+
+	pthread_mutex_lock(&plan_mutex);
+
+	for (p = plan_cache; p; p = p->next) {
+		if (p->len == len && p->dir == dir && p->flags == flags) {
+			pthread_mutex_unlock(&plan_mutex);
+			return p->plan;
+		}
+	}
+
+	if ((plan = fftw_create_plan(len, dir, flags)) != NULL) {
+		p = g_new0(struct fft_plan, 1);
+
+		p->len = len;
+		p->dir = dir;
+		p->flags = flags;
+		p->plan = plan;
+
+		p->next = plan_cache;
+		plan_cache = p;
+
+		wisdom_changed = TRUE;
+	}
+
+	pthread_mutex_unlock(&plan_mutex);
+
+	return plan;
+}
+
 struct fft *fft_init(gint len, gint dir)
 {
 	struct fft *s;
@@ -52,15 +105,7 @@ struct fft *fft_init(gint len, gint dir)
 		return NULL;
 	}
 
-#if 1
-	s->plan = fftw_create_plan(len, dir, FLAGS);
-#else
-	s->plan = fftw_plan_dft_1d(len, s->in, s->out,
-				   FFTW_FORWARD,
-				   FFTW_MEASURE);
-#endif
-
-	if (!s->plan) {
+	if ((s->plan = plan_get(len, dir, FLAGS)) == NULL) {
 		fft_free(s);
 		return NULL;
 	}
@@ -76,8 +121,6 @@ struct fft *fft_init(gint len, gint dir)
 void fft_free(struct fft *s)
 {
 	if (s) {
-		if (s->plan)
-			fftw_destroy_plan(s->plan);
 		if (s->in)
 			fftw_free(s->in);
 		if (s->out)
@@ -117,6 +160,63 @@ void fft_run(struct fft *s)
 
 /* ---------------------------------------------------------------------- */
 
+struct preplan {
+	gint *lens;
+	gint num;
+	void (*done)(void);
+};
+
+static void *preplan_loop(void *args)
+{
+	struct preplan *pp = args;
+	gint i;
+
+	for (i = 0; i < pp->num; i++) {
+		plan_get(pp->lens[i], FFT_FWD, FLAGS);
+		plan_get(pp->lens[i], FFT_REV, FLAGS);
+	}
+
+	if (pp->done)
+		pp->done();
+
+	g_free(pp->lens);
+	g_free(pp);
+
+	return NULL;
+}
+
+/*
+ * Plan both directions of the given lengths on a background thread so
+ * that modem initialization later finds them in the cache and does not
+ * have to wait for FFTW_MEASURE. The lengths are planned in the given
+ * order. 'done' (may be NULL) is called from the planner thread when
+ * all of them are ready.
+ */
+void fft_preplan(const gint *lens, gint num, void (*done)(void))
+{
+	struct preplan *pp;
+	pthread_attr_t attr;
+	pthread_t thread;
+
+	pp = g_new0(struct preplan, 1);
+	pp->lens = g_memdup(lens, num * sizeof(gint));
+	pp->num = num;
+	pp->done = done;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+	if (pthread_create(&thread, &attr, preplan_loop, pp) != 0) {
+		g_warning("fft_preplan: pthread_create: %m\n");
+		g_free(pp->lens);
+		g_free(pp);
+	}
+
+	pthread_attr_destroy(&attr);
+}
+
+/* ---------------------------------------------------------------------- */
+
 void fft_load_wisdom(const gchar *filename)
 {
 	FILE *fp;
@@ -129,8 +229,10 @@ void fft_load_wisdom(const gchar *filename)
 		return;
 	}
 
+	pthread_mutex_lock(&plan_mutex);
 	if (fftw_import_wisdom_from_file(fp) == FFTW_FAILURE)
 		g_warning("fftw_import_wisdom_from_file failed!");
+	pthread_mutex_unlock(&plan_mutex);
 
 	fclose(fp);
 }
@@ -147,7 +249,10 @@ void fft_save_wisdom(const gchar *filename)
 		return;
 	}
 
+	pthread_mutex_lock(&plan_mutex);
 	fftw_export_wisdom_to_file(fp);
+	wisdom_changed = FALSE;
+	pthread_mutex_unlock(&plan_mutex);
 
 	fclose(fp);
 }
@@ -157,13 +262,37 @@ void fft_set_wisdom(const char *wisdom)
 	if (wisdom == NULL)
 		return;
 
+	pthread_mutex_lock(&plan_mutex);
 	if (fftw_import_wisdom_from_string(wisdom) == FFTW_FAILURE)
 		g_warning("Error importing FFTW wisdom!!!\n");
+	pthread_mutex_unlock(&plan_mutex);
 }
 
 char *fft_get_wisdom(void)
 {
-	return fftw_export_wisdom_to_string();
+	char *wisdom;
+
+	pthread_mutex_lock(&plan_mutex);
+	wisdom = fftw_export_wisdom_to_string();
+	wisdom_changed = FALSE;
+	pthread_mutex_unlock(&plan_mutex);
+
+	return wisdom;
+}
+
+/*
+ * Returns TRUE if plans have been created (and so possibly wisdom
+ * accumulated) since the last fft_get_wisdom().
+ */
+gboolean fft_wisdom_changed(void)
+{
+	gboolean changed;
+
+	pthread_mutex_lock(&plan_mutex);
+	changed = wisdom_changed;
+	pthread_mutex_unlock(&plan_mutex);
+
+	return changed;
 }
 
 /* ---------------------------------------------------------------------- */
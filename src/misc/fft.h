@@ -55,11 +55,14 @@ extern void fft_clear_outbuf(struct fft *s);
 
 extern void fft_run(struct fft *s);
 
+extern void fft_preplan(const gint *lens, gint num, void (*done)(void));
+
 extern void fft_load_wisdom(const gchar *filename);
 extern void fft_save_wisdom(const gchar *filename);
 
 extern void fft_set_wisdom(const gchar *wisdom);
 extern char *fft_get_wisdom(void);
+extern gboolean fft_wisdom_changed(void);
 
 
 #endif
@@ -0,0 +1,640 @@
+/*
+ *    fftf.c  --  Single precision FFT
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "fftf.h"
+#include "cpu.h"
+
+#ifdef HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * A decimation in time FFT on bit reversed input. The first two
+ * radix-2 stages need no multiplies and are done together as one
+ * radix-4 pass. If the number of stages is odd, a single radix-2
+ * stage with a span of 4 follows. The rest of the stages are done
+ * two at a time, reading and writing the data only once for each
+ * pair. The arithmetic is exactly that of the radix-2 stages, only
+ * the order of the memory passes changes.
+ *
+ * The twiddles are stored in the order the passes use them: four
+ * for the radix-2 stage, then for each pair of stages with span m
+ * the m twiddles of the first stage, the m of the second stage for
+ * the upper half and the m for the lower half.
+ */
+
+static inline gint log2len(gint len)
+{
+	gint n = 0;
+
+	while ((1 << n) < len)
+		n++;
+
+	return n;
+}
+
+static pthread_once_t core_once = PTHREAD_ONCE_INIT;
+
+static void core_init(void);
+
+static void set_twiddle(fcomplex *w, gint k, gint span)
+{
+	gdouble phase = -M_PI * k / span;
+
+	w->re = cos(phase);
+	w->im = sin(phase);
+}
+
+struct fftf *fftf_init(gint len)
+{
+	struct fftf *s;
+	fcomplex *w;
+	gint i, j, k, m, bits;
+
+	if (len < 4 || (len & (len - 1)) != 0) {
+		g_warning("fftf_init: bad length %d\n", len);
+		return NULL;
+	}
+
+	pthread_once(&core_once, core_init);
+
+	s = g_new0(struct fftf, 1);
+
+	s->len = len;
+	s->bitrev = g_new(gint, len);
+	s->twiddle = fftf_malloc(len);
+	s->rtwiddle = fftf_malloc(len);
+
+	bits = log2len(len);
+
+	for (i = 0; i < len; i++) {
+		for (j = 0, k = 0; k < bits; k++)
+			if (i & (1 << k))
+				j |= 1 << (bits - 1 - k);
+		s->bitrev[i] = j;
+	}
+
+	w = s->twiddle;
+
+	if (bits & 1) {
+		for (k = 0; k < 4; k++)
+			set_twiddle(w++, k, 4);
+		m = 8;
+	} else
+		m = 4;
+
+	for (; 4 * m <= len; m *= 4) {
+		for (k = 0; k < m; k++)
+			set_twiddle(w + k, k, m);
+		for (k = 0; k < m; k++)
+			set_twiddle(w + m + k, k, 2 * m);
+		for (k = 0; k < m; k++)
+			set_twiddle(w + 2 * m + k, k + m, 2 * m);
+		w += 3 * m;
+	}
+
+	for (k = 0; k < len; k++)
+		set_twiddle(s->rtwiddle + k, k, len);
+
+	return s;
+}
+
+void fftf_free(struct fftf *s)
+{
+	if (s) {
+		g_free(s->bitrev);
+		free(s->twiddle);
+		free(s->rtwiddle);
+		g_free(s);
+	}
+}
+
+/*
+ * Buffers aligned for the SIMD loads. Release them with free().
+ */
+fcomplex *fftf_malloc(gint len)
+{
+	void *p;
+
+	if (posix_memalign(&p, 32, len * sizeof(fcomplex)) != 0)
+		return NULL;
+
+	memset(p, 0, len * sizeof(fcomplex));
+
+	return p;
+}
+
+/* ---------------------------------------------------------------------- */
+
+#define	CMUL(z, x, w) {					\
+	(z).re = (x).re * (w).re - (x).im * (w).im;	\
+	(z).im = (x).re * (w).im + (x).im * (w).re;	\
+}
+
+static void first_generic(fcomplex *x, gint len)
+{
+	fcomplex a0, a1, a2, a3;
+	gint i;
+
+	for (i = 0; i < len; i += 4, x += 4) {
+		a0.re = x[0].re + x[1].re;
+		a0.im = x[0].im + x[1].im;
+		a1.re = x[0].re - x[1].re;
+		a1.im = x[0].im - x[1].im;
+		a2.re = x[2].re + x[3].re;
+		a2.im = x[2].im + x[3].im;
+		a3.re = x[2].re - x[3].re;
+		a3.im = x[2].im - x[3].im;
+
+		/* a3 * -j */
+		x[0].re = a0.re + a2.re;
+		x[0].im = a0.im + a2.im;
+		x[1].re = a1.re + a3.im;
+		x[1].im = a1.im - a3.re;
+		x[2].re = a0.re - a2.re;
+		x[2].im = a0.im - a2.im;
+		x[3].re = a1.re - a3.im;
+		x[3].im = a1.im + a3.re;
+	}
+}
+
+static void radix2_generic(fcomplex *x, gint len, const fcomplex *w)
+{
+	fcomplex t;
+	gint b, k;
+
+	for (b = 0; b < len; b += 8) {
+		for (k = 0; k < 4; k++) {
+			CMUL(t, x[b + k + 4], w[k]);
+			x[b + k + 4].re = x[b + k].re - t.re;
+			x[b + k + 4].im = x[b + k].im - t.im;
+			x[b + k].re += t.re;
+			x[b + k].im += t.im;
+		}
+	}
+}
+
+static void radix4_generic(fcomplex *x, gint len, gint m, const fcomplex *w)
+{
+	fcomplex a0, a1, a2, a3, t, u;
+	fcomplex *p;
+	gint b, k;
+
+	for (b = 0; b < len; b += 4 * m) {
+		for (k = 0; k < m; k++) {
+			p = x + b + k;
+
+			CMUL(t, p[m], w[k]);
+			CMUL(u, p[3 * m], w[k]);
+
+			a1.re = p[0].re - t.re;
+			a1.im = p[0].im - t.im;
+			a0.re = p[0].re + t.re;
+			a0.im = p[0].im + t.im;
+			a3.re = p[2 * m].re - u.re;
+			a3.im = p[2 * m].im - u.im;
+			a2.re = p[2 * m].re + u.re;
+			a2.im = p[2 * m].im + u.im;
+
+			CMUL(t, a2, w[m + k]);
+			CMUL(u, a3, w[2 * m + k]);
+
+			p[0].re = a0.re + t.re;
+			p[0].im = a0.im + t.im;
+			p[2 * m].re = a0.re - t.re;
+			p[2 * m].im = a0.im - t.im;
+			p[m].re = a1.re + u.re;
+			p[m].im = a1.im + u.im;
+			p[3 * m].re = a1.re - u.re;
+			p[3 * m].im = a1.im - u.im;
+		}
+	}
+}
+
+static void core_generic(struct fftf *s, fcomplex *x)
+{
+	const fcomplex *w = s->twiddle;
+	gint m = 4;
+
+	first_generic(x, s->len);
+
+	if (log2len(s->len) & 1) {
+		radix2_generic(x, s->len, w);
+		w += 4;
+		m = 8;
+	}
+
+	for (; 4 * m <= s->len; m *= 4) {
+		radix4_generic(x, s->len, m, w);
+		w += 3 * m;
+	}
+}
+
+#ifdef HAVE_X86_SIMD
+
+/*
+ * The SIMD versions do the same single precision operations as the
+ * generic ones, complex multiplies included, so the results are
+ * identical.
+ */
+__attribute__ ((target("sse2")))
+static inline __m128 cmul_sse2(__m128 x, __m128 w)
+{
+	const __m128 sign = _mm_set_ps(0.0, -0.0, 0.0, -0.0);
+	__m128 wr, wi, xs;
+
+	wr = _mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 2, 0, 0));
+	wi = _mm_shuffle_ps(w, w, _MM_SHUFFLE(3, 3, 1, 1));
+	xs = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+
+	return _mm_add_ps(_mm_mul_ps(x, wr),
+			  _mm_xor_ps(_mm_mul_ps(xs, wi), sign));
+}
+
+__attribute__ ((target("sse2")))
+static void first_sse2(fcomplex *x, gint len)
+{
+	const __m128 sign = _mm_set_ps(-0.0, 0.0, 0.0, 0.0);
+	__m128 p, q, s, d;
+	gint i;
+
+	for (i = 0; i < len; i += 4, x += 4) {
+		p = _mm_loadu_ps((float *) x);
+		q = _mm_loadu_ps((float *) (x + 2));
+
+		/* (x0 + x1, x0 - x1) and (x2 + x3, x2 - x3) */
+		s = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 0, 3, 2));
+		d = _mm_sub_ps(s, p);
+		s = _mm_add_ps(p, s);
+		p = _mm_shuffle_ps(s, d, _MM_SHUFFLE(3, 2, 1, 0));
+
+		s = _mm_shuffle_ps(q, q, _MM_SHUFFLE(1, 0, 3, 2));
+		d = _mm_sub_ps(s, q);
+		s = _mm_add_ps(q, s);
+		q = _mm_shuffle_ps(s, d, _MM_SHUFFLE(3, 2, 1, 0));
+
+		/* (a2, a3 * -j) */
+		q = _mm_xor_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 3, 1, 0)), sign);
+
+		_mm_storeu_ps((float *) x, _mm_add_ps(p, q));
+		_mm_storeu_ps((float *) (x + 2), _mm_sub_ps(p, q));
+	}
+}
+
+__attribute__ ((target("sse2")))
+static void radix2_sse2(fcomplex *x, gint len, const fcomplex *w)
+{
+	__m128 w0, w1, x0, x1, t;
+	gint b, k;
+
+	w0 = _mm_loadu_ps((float *) w);
+	w1 = _mm_loadu_ps((float *) (w + 2));
+
+	for (b = 0; b < len; b += 8) {
+		for (k = 0; k < 4; k += 2) {
+			x0 = _mm_loadu_ps((float *) (x + b + k));
+			x1 = _mm_loadu_ps((float *) (x + b + k + 4));
+
+			t = cmul_sse2(x1, k ? w1 : w0);
+
+			_mm_storeu_ps((float *) (x + b + k), _mm_add_ps(x0, t));
+			_mm_storeu_ps((float *) (x + b + k + 4), _mm_sub_ps(x0, t));
+		}
+	}
+}
+
+__attribute__ ((target("sse2")))
+static void radix4_sse2(fcomplex *x, gint len, gint m, const fcomplex *w)
+{
+	__m128 a0, a1, a2, a3, t, u, w1;
+	float *p;
+	gint b, k;
+
+	for (b = 0; b < len; b += 4 * m) {
+		for (k = 0; k < m; k += 2) {
+			p = (float *) (x + b + k);
+
+			w1 = _mm_loadu_ps((float *) (w + k));
+
+			t = cmul_sse2(_mm_loadu_ps(p + 2 * m), w1);
+			u = cmul_sse2(_mm_loadu_ps(p + 6 * m), w1);
+
+			a0 = _mm_loadu_ps(p);
+			a2 = _mm_loadu_ps(p + 4 * m);
+
+			a1 = _mm_sub_ps(a0, t);
+			a0 = _mm_add_ps(a0, t);
+			a3 = _mm_sub_ps(a2, u);
+			a2 = _mm_add_ps(a2, u);
+
+			t = cmul_sse2(a2, _mm_loadu_ps((float *) (w + m + k)));
+			u = cmul_sse2(a3, _mm_loadu_ps((float *) (w + 2 * m + k)));
+
+			_mm_storeu_ps(p, _mm_add_ps(a0, t));
+			_mm_storeu_ps(p + 4 * m, _mm_sub_ps(a0, t));
+			_mm_storeu_ps(p + 2 * m, _mm_add_ps(a1, u));
+			_mm_storeu_ps(p + 6 * m, _mm_sub_ps(a1, u));
+		}
+	}
+}
+
+__attribute__ ((target("sse2")))
+static void core_sse2(struct fftf *s, fcomplex *x)
+{
+	const fcomplex *w = s->twiddle;
+	gint m = 4;
+
+	first_sse2(x, s->len);
+
+	if (log2len(s->len) & 1) {
+		radix2_sse2(x, s->len, w);
+		w += 4;
+		m = 8;
+	}
+
+	for (; 4 * m <= s->len; m *= 4) {
+		radix4_sse2(x, s->len, m, w);
+		w += 3 * m;
+	}
+}
+
+__attribute__ ((target("avx")))
+static inline __m256 cmul_avx(__m256 x, __m256 w)
+{
+	__m256 wr, wi, xs;
+
+	wr = _mm256_moveldup_ps(w);
+	wi = _mm256_movehdup_ps(w);
+	xs = _mm256_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1));
+
+	return _mm256_addsub_ps(_mm256_mul_ps(x, wr), _mm256_mul_ps(xs, wi));
+}
+
+__attribute__ ((target("avx")))
+static void radix2_avx(fcomplex *x, gint len, const fcomplex *w)
+{
+	__m256 w0, x0, t;
+	gint b;
+
+	w0 = _mm256_loadu_ps((float *) w);
+
+	for (b = 0; b < len; b += 8) {
+		x0 = _mm256_loadu_ps((float *) (x + b));
+		t = cmul_avx(_mm256_loadu_ps((float *) (x + b + 4)), w0);
+
+		_mm256_storeu_ps((float *) (x + b), _mm256_add_ps(x0, t));
+		_mm256_storeu_ps((float *) (x + b + 4), _mm256_sub_ps(x0, t));
+	}
+}
+
+__attribute__ ((target("avx")))
+static void radix4_avx(fcomplex *x, gint len, gint m, const fcomplex *w)
+{
+	__m256 a0, a1, a2, a3, t, u, w1;
+	float *p;
+	gint b, k;
+
+	for (b = 0; b < len; b += 4 * m) {
+		for (k = 0; k < m; k += 4) {
+			p = (float *) (x + b + k);
+
+			w1 = _mm256_loadu_ps((float *) (w + k));
+
+			t = cmul_avx(_mm256_loadu_ps(p + 2 * m), w1);
+			u = cmul_avx(_mm256_loadu_ps(p + 6 * m), w1);
+
+			a0 = _mm256_loadu_ps(p);
+			a2 = _mm256_loadu_ps(p + 4 * m);
+
+			a1 = _mm256_sub_ps(a0, t);
+			a0 = _mm256_add_ps(a0, t);
+			a3 = _mm256_sub_ps(a2, u);
+			a2 = _mm256_add_ps(a2, u);
+
+			t = cmul_avx(a2, _mm256_loadu_ps((float *) (w + m + k)));
+			u = cmul_avx(a3, _mm256_loadu_ps((float *) (w + 2 * m + k)));
+
+			_mm256_storeu_ps(p, _mm256_add_ps(a0, t));
+			_mm256_storeu_ps(p + 4 * m, _mm256_sub_ps(a0, t));
+			_mm256_storeu_ps(p + 2 * m, _mm256_add_ps(a1, u));
+			_mm256_storeu_ps(p + 6 * m, _mm256_sub_ps(a1, u));
+		}
+	}
+}
+
+__attribute__ ((target("avx")))
+static void core_avx(struct fftf *s, fcomplex *x)
+{
+	const fcomplex *w = s->twiddle;
+	gint m = 4;
+
+	first_sse2(x, s->len);
+
+	if (log2len(s->len) & 1) {
+		radix2_avx(x, s->len, w);
+		w += 4;
+		m = 8;
+	}
+
+	for (; 4 * m <= s->len; m *= 4) {
+		radix4_avx(x, s->len, m, w);
+		w += 3 * m;
+	}
+}
+
+#endif				/* HAVE_X86_SIMD */
+
+static void (*fftf_core_impl) (struct fftf *, fcomplex *) = core_generic;
+
+/*
+ * Pick the core once, from fftf_init(). The channel bank can set up
+ * FFTs on several threads at the same time.
+ */
+static void core_init(void)
+{
+#ifdef HAVE_X86_SIMD
+	if (cpu_features() & CPU_AVX)
+		fftf_core_impl = core_avx;
+	else if (cpu_features() & CPU_SSE2)
+		fftf_core_impl = core_sse2;
+#endif
+}
+
+void fftf_core(struct fftf *s, fcomplex *x)
+{
+	fftf_core_impl(s, x);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void fftf_scramble(struct fftf *s, fcomplex *x)
+{
+	fcomplex tmp;
+	gint i, j;
+
+	for (i = 0; i < s->len; i++) {
+		if ((j = s->bitrev[i]) > i) {
+			tmp = x[i];
+			x[i] = x[j];
+			x[j] = tmp;
+		}
+	}
+}
+
+void fftf_run(struct fftf *s, fcomplex *x)
+{
+	fftf_scramble(s, x);
+	fftf_core(s, x);
+}
+
+void fftf_run_window(struct fftf *s, const fcomplex *in,
+		     const gfloat *window, fcomplex *out)
+{
+	gint i, j;
+
+	if (window) {
+		for (i = 0; i < s->len; i++) {
+			j = s->bitrev[i];
+			out[j].re = in[i].re * window[i];
+			out[j].im = in[i].im * window[i];
+		}
+	} else {
+		for (i = 0; i < s->len; i++)
+			out[s->bitrev[i]] = in[i];
+	}
+
+	fftf_core(s, out);
+}
+
+void fftf_run_real(struct fftf *s, const gfloat *in,
+		   const gfloat *window, fcomplex *out)
+{
+	fcomplex z0, z1, e, o, t;
+	gint i, j, k;
+
+	for (i = 0; i < s->len; i++) {
+		j = s->bitrev[i];
+		if (window) {
+			out[j].re = in[2 * i] * window[2 * i];
+			out[j].im = in[2 * i + 1] * window[2 * i + 1];
+		} else {
+			out[j].re = in[2 * i];
+			out[j].im = in[2 * i + 1];
+		}
+	}
+
+	fftf_core(s, out);
+
+	/*
+	 * Z = FFT(even + j * odd), E = Z[k] + conj(Z[N-k]) and
+	 * O = Z[k] - conj(Z[N-k]) give X[k] = (E - j * W^k * O) / 2.
+	 * Bins k and N-k are done together, in place.
+	 */
+	z0 = out[0];
+	out[0].re = z0.re + z0.im;
+	out[0].im = 0.0;
+
+	for (k = 1; k <= s->len / 2; k++) {
+		z0 = out[k];
+		z1 = out[s->len - k];
+
+		e.re = z0.re + z1.re;
+		e.im = z0.im - z1.im;
+		o.re = z0.re - z1.re;
+		o.im = z0.im + z1.im;
+		CMUL(t, o, s->rtwiddle[k]);
+		out[k].re = 0.5 * (e.re + t.im);
+		out[k].im = 0.5 * (e.im - t.re);
+
+		/* the same with k and N-k swapped */
+		e.im = -e.im;
+		o.re = -o.re;
+		CMUL(t, o, s->rtwiddle[s->len - k]);
+		out[s->len - k].re = 0.5 * (e.re + t.im);
+		out[s->len - k].im = 0.5 * (e.im - t.re);
+	}
+}
+
+void fftf_separ_two_reals(struct fftf *s, const fcomplex *buf,
+			  fcomplex *out0, fcomplex *out1)
+{
+	gint i, len = s->len;
+
+	out0[0].re = buf[0].re;
+	out1[0].re = buf[0].im;
+
+	for (i = 1; i < len / 2; i++) {
+		out0[i].re = buf[i].re + buf[len - i].re;
+		out0[i].im = buf[i].im - buf[len - i].im;
+		out1[i].re = buf[i].im + buf[len - i].im;
+		out1[i].im = (-buf[i].re) + buf[len - i].re;
+	}
+
+	out0[0].im = buf[len / 2].re;
+	out1[0].im = buf[len / 2].im;
+}
+
+void fftf_separ_energy(struct fftf *s, const fcomplex *buf,
+		       gint first, gint n,
+		       gfloat *energy0, gfloat *energy1)
+{
+	const fcomplex *lo, *hi;
+	gfloat re, im;
+	gint i = 0;
+
+	/* bin 0 holds the DC and the Nyquist bins, as above */
+	if (first == 0 && n > 0) {
+		re = buf[0].re;
+		im = buf[s->len / 2].re;
+		energy0[0] = re * re + im * im;
+
+		re = buf[0].im;
+		im = buf[s->len / 2].im;
+		energy1[0] = re * re + im * im;
+
+		i = first = 1;
+	}
+
+	lo = buf + first;
+	hi = buf + s->len - first;
+
+	for (; i < n; i++, lo++, hi--) {
+		re = lo->re + hi->re;
+		im = lo->im - hi->im;
+		energy0[i] = re * re + im * im;
+
+		re = lo->im + hi->im;
+		im = (-lo->re) + hi->re;
+		energy1[i] = re * re + im * im;
+	}
+}
+
+/* ---------------------------------------------------------------------- */
@@ -0,0 +1,100 @@
+/*
+ *    fftf.h  --  Single precision FFT
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _FFTF_H
+#define _FFTF_H
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The FFT used by the modems that work in single precision (Olivia,
+ * MT63) and by the waterfall. The double precision filters in misc/
+ * use FFTW through fft.h.
+ *
+ * All transforms are in place, unscaled and forward (exp(-j...)),
+ * on interleaved complex data that is layout compatible with the
+ * fcmpx types of the C++ modems. For an inverse transform conjugate
+ * the data before and after.
+ */
+typedef struct {
+	gfloat re;
+	gfloat im;
+} fcomplex;
+
+struct fftf {
+	gint len;
+	gint *bitrev;		/* bit reverse permutation */
+	fcomplex *twiddle;	/* per pass, see fftf.c */
+	fcomplex *rtwiddle;	/* exp(-j*pi*k/len) for real transforms */
+};
+
+extern struct fftf *fftf_init(gint len);
+extern void fftf_free(struct fftf *s);
+
+/* buffers aligned for the SIMD code, release with free() */
+extern fcomplex *fftf_malloc(gint len);
+
+/* the butterflies only, the data must already be in bit reversed order */
+extern void fftf_core(struct fftf *s, fcomplex *x);
+
+extern void fftf_scramble(struct fftf *s, fcomplex *x);
+extern void fftf_run(struct fftf *s, fcomplex *x);
+
+/* out[] = FFT(in[] * window[]), window may be NULL, in != out */
+extern void fftf_run_window(struct fftf *s, const fcomplex *in,
+			    const gfloat *window, fcomplex *out);
+
+/*
+ * Transform 2 * len real samples (times window, if not NULL) with a
+ * len point FFT. out[0..len-1] gets the bins 0 to len-1, the Nyquist
+ * bin is dropped.
+ */
+extern void fftf_run_real(struct fftf *s, const gfloat *in,
+			  const gfloat *window, fcomplex *out);
+
+/*
+ * Two real sequences transformed at once as the real and imaginary
+ * parts of one complex one. Separate the spectra into len/2 bins
+ * each, the Nyquist bin goes into the imaginary part of bin 0.
+ */
+extern void fftf_separ_two_reals(struct fftf *s, const fcomplex *buf,
+				 fcomplex *out0, fcomplex *out1);
+
+/*
+ * The same, but only the energies of bins first...first+n-1
+ * are computed.
+ */
+extern void fftf_separ_energy(struct fftf *s, const fcomplex *buf,
+			      gint first, gint n,
+			      gfloat *energy0, gfloat *energy1);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif				/* _FFTF_H */
@@ -23,18 +23,259 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <pthread.h>
 
 #include "fftfilt.h"
+#include "filter.h"
+#include "firdesign.h"
 #include "fft.h"
 #include "misc.h"
+#include "cpu.h"
+
+#ifdef HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
 
 #undef	DEBUG
 
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Designed filter spectra are shared between filters and kept around
+ * for a while after the last user is gone, so switching the CW or
+ * Hell bandwidth back and forth does not need a new design and FFT.
+ */
+#define	SPEC_CACHE_MAX	16
+
+struct fftfilt_spec {
+	gdouble f1;
+	gdouble f2;
+	gint len;
+
+	gint refcount;
+	complex *filter;
+
+	struct fftfilt_spec *next;
+};
+
+static struct fftfilt_spec *spec_cache = NULL;
+static pthread_mutex_t spec_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static complex *spec_design(gdouble f1, gdouble f2, gint filterlen)
+{
+	struct fft *fft;
+	complex *filter;
+	gint len = filterlen / 2 + 1;
+	gdouble *taps;
+	gint i;
+
+	if ((fft = fft_init(filterlen, FFT_FWD)) == NULL)
+		return NULL;
+
+	taps = g_new(gdouble, len);
+	fir_design_double(taps, len, 0, f1, f2);
+
+	for (i = 0; i < len; i++) {
+		c_re(fft->in[i]) = taps[i];
+		c_im(fft->in[i]) = 0.0;
+#ifdef DEBUG
+                fprintf(stderr, "% e\t", taps[i]);
+#endif
+	}
+
+	g_free(taps);
+
+	fft_run(fft);
+
+	filter = g_new(complex, filterlen);
+
+	/*
+	 * Scale down by 'filterlen' because inverse transform is 
+	 * unscaled in FFTW.
+	 */
+	for (i = 0; i < filterlen; i++) {
+		c_re(filter[i]) = c_re(fft->out[i]) / filterlen;
+		c_im(filter[i]) = c_im(fft->out[i]) / filterlen;
+	}
+
+	fft_free(fft);
+
+#ifdef DEBUG
+	for (i = 0; i < filterlen; i++)
+		fprintf(stderr, "% e\n", 10 * log10(cpwr(filter[i])));
+#endif
+
+	return filter;
+}
+
+/*
+ * Drop unused spectra beyond SPEC_CACHE_MAX. The list is kept in
+ * most recently used order so the oldest ones go first.
+ */
+static void spec_trim(void)
+{
+	struct fftfilt_spec **p, *sp;
+	gint count = 0;
+
+	p = &spec_cache;
+
+	while ((sp = *p) != NULL) {
+		if (sp->refcount == 0 && ++count > SPEC_CACHE_MAX) {
+			*p = sp->next;
+			g_free(sp->filter);
+			g_free(sp);
+			continue;
+		}
+		p = &sp->next;
+	}
+}
+
+static struct fftfilt_spec *spec_get(gdouble f1, gdouble f2, gint len)
+{
+	struct fftfilt_spec **p, *sp;
+	complex *filter;
+
+	pthread_mutex_lock(&spec_mutex);
+
+	for (p = &spec_cache; (sp = *p) != NULL; p = &sp->next) {
+		if (sp->f1 == f1 && sp->f2 == f2 && sp->len == len) {
+			/* move to the front */
+			*p = sp->next;
+			sp->next = spec_cache;
+			spec_cache = sp;
+
+			sp->refcount++;
+			pthread_mutex_unlock(&spec_mutex);
+			return sp;
+		}
+	}
+
+	pthread_mutex_unlock(&spec_mutex);
+
+	/* design outside the lock, the FFT planner takes its own */
+	if ((filter = spec_design(f1, f2, len)) == NULL)
+		return NULL;
+
+	sp = g_new0(struct fftfilt_spec, 1);
+
+	sp->f1 = f1;
+	sp->f2 = f2;
+	sp->len = len;
+	sp->refcount = 1;
+	sp->filter = filter;
+
+	pthread_mutex_lock(&spec_mutex);
+	sp->next = spec_cache;
+	spec_cache = sp;
+	spec_trim();
+	pthread_mutex_unlock(&spec_mutex);
+
+	return sp;
+}
+
+static void spec_put(struct fftfilt_spec *sp)
+{
+	if (sp == NULL)
+		return;
+
+	pthread_mutex_lock(&spec_mutex);
+	sp->refcount--;
+	spec_trim();
+	pthread_mutex_unlock(&spec_mutex);
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Multiply the input spectrum with the filter shape. The SIMD
+ * versions do the same multiplies and adds as cmul() so all of
+ * them give identical results.
+ */
+static void mul_generic(complex *out, const complex *in,
+			const complex *filter, gint len)
+{
+	gint i;
+
+	for (i = 0; i < len; i++)
+		out[i] = cmul(in[i], filter[i]);
+}
+
+#ifdef HAVE_X86_SIMD
+
+__attribute__ ((target("sse2")))
+static void mul_sse2(complex *out, const complex *in,
+		     const complex *filter, gint len)
+{
+	const __m128d sign = _mm_set_pd(0.0, -0.0);
+	__m128d x, f, re, im;
+	gint i;
+
+	for (i = 0; i < len; i++) {
+		x = _mm_loadu_pd((const double *) (in + i));
+		f = _mm_loadu_pd((const double *) (filter + i));
+
+		/* (xr * fr, xi * fr) + (-xi * fi, xr * fi) */
+		re = _mm_mul_pd(x, _mm_unpacklo_pd(f, f));
+		im = _mm_mul_pd(_mm_shuffle_pd(x, x, 1), _mm_unpackhi_pd(f, f));
+
+		_mm_storeu_pd((double *) (out + i),
+			      _mm_add_pd(re, _mm_xor_pd(im, sign)));
+	}
+}
+
+__attribute__ ((target("avx")))
+static void mul_avx(complex *out, const complex *in,
+		    const complex *filter, gint len)
+{
+	__m256d x, f, re, im;
+	gint i;
+
+	for (i = 0; i + 2 <= len; i += 2) {
+		x = _mm256_loadu_pd((const double *) (in + i));
+		f = _mm256_loadu_pd((const double *) (filter + i));
+
+		re = _mm256_mul_pd(x, _mm256_movedup_pd(f));
+		im = _mm256_mul_pd(_mm256_permute_pd(x, 5),
+				   _mm256_permute_pd(f, 15));
+
+		_mm256_storeu_pd((double *) (out + i),
+				 _mm256_addsub_pd(re, im));
+	}
+
+	mul_generic(out + i, in + i, filter + i, len - i);
+}
+
+#endif				/* HAVE_X86_SIMD */
+
+static void (*fftfilt_mul) (complex *, const complex *,
+			    const complex *, gint) = mul_generic;
+
+static pthread_once_t mul_once = PTHREAD_ONCE_INIT;
+
+/*
+ * Pick the multiply once, the channel bank can build filters on
+ * several threads at the same time.
+ */
+static void mul_init(void)
+{
+#ifdef HAVE_X86_SIMD
+	if (cpu_features() & CPU_AVX)
+		fftfilt_mul = mul_avx;
+	else if (cpu_features() & CPU_SSE2)
+		fftfilt_mul = mul_sse2;
+#endif
+}
+
+/* ---------------------------------------------------------------------- */
+
 struct fftfilt *fftfilt_init(gdouble f1, gdouble f2, gint len)
 {
 	struct fftfilt *s;
 
+	pthread_once(&mul_once, mul_init);
+
 	s = g_new0(struct fftfilt, 1);
 
 	if ((s->fft = fft_init(len, FFT_FWD)) == NULL) {
@@ -47,19 +288,19 @@ struct fftfilt *fftfilt_init(gdouble f1, gdouble f2, gint len)
 		return NULL;
 	}
 
-	if ((s->tmpfft = fft_init(len, FFT_FWD)) == NULL) {
-		fftfilt_free(s);
-		return NULL;
-	}
-
-	s->ovlbuf = g_new0(complex, len / 2);
-	s->filter = g_new0(complex, len);
-
 	s->filterlen = len;
 	s->inptr = 0;
 
+	s->outlen = FILTER_BLOCKLEN + len / 2;
+	s->outbuf = g_new(complex, s->outlen);
+
 	fftfilt_set_freqs(s, f1, f2);
 
+	if (s->spec == NULL) {
+		fftfilt_free(s);
+		return NULL;
+	}
+
 	return s;
 }
 
@@ -68,92 +309,113 @@ void fftfilt_free(struct fftfilt *s)
 	if (s) {
 		fft_free(s->fft);
 		fft_free(s->ift);
-		fft_free(s->tmpfft);
-		g_free(s->ovlbuf);
-		g_free(s->filter);
+		spec_put(s->spec);
+		g_free(s->outbuf);
 		g_free(s);
 	}
 }
 
+/*
+ * Switch to the (f1, f2) filter shape. Shapes that have been used
+ * recently come straight from the cache. On failure the old shape
+ * is kept.
+ */
 void fftfilt_set_freqs(struct fftfilt *s, gdouble f1, gdouble f2)
 {
-	gint len = s->filterlen / 2 + 1;
-	gdouble t, h, x;
-	gint i;
+	struct fftfilt_spec *sp, *old;
 
-	fft_clear_inbuf(s->tmpfft);
+	if ((sp = spec_get(f1, f2, s->filterlen)) == NULL) {
+		g_warning("fftfilt_set_freqs: filter design failed\n");
+		return;
+	}
 
-	for (i = 0; i < len; i++) {
-		t = i - (len - 1.0) / 2.0;
-		h = i / (len - 1.0);
+	/* swap the new shape in before letting go of the old one */
+	old = s->spec;
+	s->spec = sp;
+	s->filter = sp->filter;
+	spec_put(old);
+}
 
-		x = (2 * f2 * sinc(2 * f2 * t) -
-		     2 * f1 * sinc(2 * f1 * t)) * hamming(h);
+/* ---------------------------------------------------------------------- */
 
-		c_re(s->tmpfft->in[i]) = x;
-		c_im(s->tmpfft->in[i]) = 0.0;
-#ifdef DEBUG
-                fprintf(stderr, "% e\t", x);
-#endif
-	}
+/*
+ * Filter with fast convolution (overlap-save algorithm).
+ *
+ * The FFT input holds the previous filterlen/2 samples followed by
+ * the new ones. The filter is filterlen/2+1 taps long, so the second
+ * half of the circular convolution is the wanted linear one.
+ */
+static complex *convolve(struct fftfilt *s)
+{
+	gint half = s->filterlen / 2;
 
-	fft_run(s->tmpfft);
+	/* FFT */
+	fft_run(s->fft);
 
-	/*
-	 * Scale down by 'filterlen' because inverse transform is 
-	 * unscaled in FFTW.
-	 */
-	for (i = 0; i < s->filterlen; i++) {
-		c_re(s->filter[i]) = c_re(s->tmpfft->out[i]) / s->filterlen;
-		c_im(s->filter[i]) = c_im(s->tmpfft->out[i]) / s->filterlen;
-	}
+	/* multiply with the filter shape */
+	fftfilt_mul(s->ift->in, s->fft->out, s->filter, s->filterlen);
 
-#ifdef DEBUG
-	for (i = 0; i < s->filterlen; i++)
-		fprintf(stderr, "% e\n", 10 * log10(cpwr(s->filter[i])));
-#endif
+	/* IFFT */
+	fft_run(s->ift);
+
+	/* the new samples are the history for the next round */
+	memcpy(s->fft->in, s->fft->in + half, half * sizeof(complex));
+	s->inptr = 0;
+
+	return s->ift->out + half;
 }
 
-/*
- * Filter with fast convolution (overlap-add algorithm).
- */
 gint fftfilt_run(struct fftfilt *s, complex in, complex **out)
 {
-	gint i;
+	gint half = s->filterlen / 2;
 
 	/* collect filterlen/2 input samples */
-	s->fft->in[s->inptr++] = in;
+	s->fft->in[half + s->inptr++] = in;
 
-	if (s->inptr < s->filterlen / 2)
+	if (s->inptr < half)
 		return 0;
 
-	/* FFT */
-	fft_run(s->fft);
+	*out = convolve(s);
 
-	/* multiply with the filter shape */
-	for (i = 0; i < s->filterlen; i++)
-		s->ift->in[i] = cmul(s->fft->out[i], s->filter[i]);
+	/* signal the caller there is filterlen/2 samples ready */
+	return half;
+}
 
-	/* IFFT */
-	fft_run(s->ift);
+/*
+ * Filter a block of 'n' samples. Returns the number of output
+ * samples, a multiple of filterlen/2, and points 'out' at them.
+ * The output stays valid until the next call.
+ */
+gint fftfilt_run_block(struct fftfilt *s, const complex *in, gint n,
+		       complex **out)
+{
+	gint half = s->filterlen / 2;
+	gint num, count = 0;
 
-	/* overlap and add */
-	for (i = 0; i < s->filterlen / 2; i++) {
-		c_re(s->ift->out[i]) += c_re(s->ovlbuf[i]);
-		c_im(s->ift->out[i]) += c_im(s->ovlbuf[i]);
+	if (s->inptr + n > s->outlen) {
+		s->outlen = s->inptr + n;
+		s->outbuf = g_renew(complex, s->outbuf, s->outlen);
 	}
-	*out = s->ift->out;
 
-	/* save the second half for overlapping */
-	for (i = 0; i < s->filterlen / 2; i++) {
-		c_re(s->ovlbuf[i]) = c_re(s->ift->out[i + s->filterlen / 2]);
-		c_im(s->ovlbuf[i]) = c_im(s->ift->out[i + s->filterlen / 2]);
+	while (n > 0) {
+		num = MIN(n, half - s->inptr);
+
+		memcpy(s->fft->in + half + s->inptr, in, num * sizeof(complex));
+		s->inptr += num;
+
+		in += num;
+		n -= num;
+
+		if (s->inptr < half)
+			break;
+
+		memcpy(s->outbuf + count, convolve(s), half * sizeof(complex));
+		count += half;
 	}
 
-	/* clear inbuf */
-	fft_clear_inbuf(s->fft);
-	s->inptr = 0;
+	*out = s->outbuf;
 
-	/* signal the caller there is filterlen/2 samples ready */
-	return s->filterlen / 2;
+	return count;
 }
+
+/* ---------------------------------------------------------------------- */
@@ -32,18 +32,21 @@
 
 /* ---------------------------------------------------------------------- */
 
+struct fftfilt_spec;
+
 struct fftfilt {
 	gint filterlen;
 
         struct fft *fft;
         struct fft *ift;
-        struct fft *tmpfft;
 
+	struct fftfilt_spec *spec;
 	complex *filter;
 
 	gint inptr;
 
-	complex *ovlbuf;
+	complex *outbuf;
+	gint outlen;
 };
 
 /* ---------------------------------------------------------------------- */
@@ -54,6 +57,8 @@ extern void fftfilt_free(struct fftfilt *s);
 extern void fftfilt_set_freqs(struct fftfilt *s, gdouble f1, gdouble f2);
 
 extern gint fftfilt_run(struct fftfilt *, complex in, complex **out);
+extern gint fftfilt_run_block(struct fftfilt *, const complex *in, gint n,
+			      complex **out);
 
 /* ---------------------------------------------------------------------- */
 
@@ -26,6 +26,8 @@
 #include <string.h>
 
 #include "filter.h"
+#include "firdesign.h"
+#include "tables.h"
 
 #undef	DEBUG
 
@@ -35,87 +37,25 @@
 
 /* ---------------------------------------------------------------------- */
 
-/*
- * This gets used when not optimising
- */
-#ifndef	__OPTIMIZE__
-gfloat mac(const gfloat *a, const gfloat *b, guint len)
-{ 
-	float sum = 0;
-	guint i;
-
-	for (i = 0; i < len; i++)
-		sum += (*a++) * (*b++);
-	return sum;
-}
-#endif
-
-/* ---------------------------------------------------------------------- */
-
-/*
- * Sinc done properly.
- */
-static inline gdouble sinc(gdouble x)
-{
-	if (fabs(x) < 1e-10)
-		return 1.0;
-	else
-		return sin(M_PI * x) / (M_PI * x);
-}
-
-/*
- * Don't ask...
- */
-static inline gdouble cosc(gdouble x)
-{
-	if (fabs(x) < 1e-10)
-		return 0.0;
-	else
-		return (1.0 - cos(M_PI * x)) / (M_PI * x);
-}
-
-/*
- * Hamming window function.
- */
-static inline gdouble hamming(gdouble x)
-{
-	return 0.54 - 0.46 * cos(2 * M_PI * x);
-}
-
-/* ---------------------------------------------------------------------- */
-
 /*
  * Create a band pass FIR filter with 6 dB corner frequencies
- * of 'f1' and 'f2'. (0 <= f1 < f2 <= 0.5)
+ * of 'f1' and 'f2'. (0 <= f1 < f2 <= 0.5) The fixed ones the
+ * modems use were designed at build time already.
  */
 static gfloat *mk_filter(gint len, gint hilbert, gfloat f1, gfloat f2)
 {
+	const struct fir_table *t;
 	gfloat *fir;
-	gfloat t, h, x;
-	gint i;
+
+	for (t = fir_tables; t->len; t++) {
+		if (t->len == len && t->hilbert == hilbert &&
+		    t->f1 == f1 && t->f2 == f2)
+			return g_memdup(t->taps, len * sizeof(gfloat));
+	}
 
 	fir = g_new(gfloat, len);
 
-	for (i = 0; i < len; i++) {
-		t = i - (len - 1.0) / 2.0;
-		h = i * (1.0 / (len - 1.0));
-
-		if (!hilbert) {
-			x = (2 * f2 * sinc(2 * f2 * t) -
-			     2 * f1 * sinc(2 * f1 * t)) * hamming(h);
-		} else {
-			x = (2 * f2 * cosc(2 * f2 * t) -
-			     2 * f1 * cosc(2 * f1 * t)) * hamming(h);
-			/*
-			 * The actual filter code assumes the impulse response
-			 * is in time reversed order. This will be anti-
-			 * symmetric so the minus sign handles that for us.
-			 */
-			x = -x;
-		}
-
-		fir[i] = x;
-	}
+	fir_design(fir, len, hilbert, f1, f2);
 
 	return fir;
 }
@@ -135,7 +75,16 @@ struct filter *filter_init(gint len, gint dec, gfloat *itaps, gfloat *qtaps)
 	if (qtaps)
 		f->qfilter = g_memdup(qtaps, len * sizeof(gfloat));
 
-	f->pointer = len;
+	/* room for the history and a whole block of new samples */
+	f->ihistory = mirror_new((len + FILTER_BLOCKLEN) * sizeof(gfloat));
+	f->qhistory = mirror_new((len + FILTER_BLOCKLEN) * sizeof(gfloat));
+
+	f->ibuffer = (gfloat *) f->ihistory->data;
+	f->qbuffer = (gfloat *) f->qhistory->data;
+
+	f->mask = f->ihistory->size / sizeof(gfloat) - 1;
+
+	f->pointer = 0;
 	f->counter = 0;
 
 	return f;
@@ -194,96 +143,189 @@ void filter_free(struct filter *f)
 	if (f) {
 		g_free(f->ifilter);
 		g_free(f->qfilter);
+		mirror_free(f->ihistory);
+		mirror_free(f->qhistory);
 		g_free(f);
 	}
 }
 
 /* ---------------------------------------------------------------------- */
 
-gint filter_run(struct filter *f, complex in, complex *out)
+/*
+ * Store one sample in the history.
+ */
+static inline void push(struct filter *f, struct mirror *m, gfloat x)
 {
-	gfloat *iptr = f->ibuffer + f->pointer;
-	gfloat *qptr = f->qbuffer + f->pointer;
+	gfloat *buf = (gfloat *) m->data;
 
-	f->pointer++;
-	f->counter++;
+	buf[f->pointer] = x;
 
-	*iptr = c_re(in);
-	*qptr = c_im(in);
+	if (!m->mapped)
+		buf[f->pointer + f->mask + 1] = x;
+}
 
-	if (f->counter == f->decimateratio) {
-		out->re = mac(iptr - f->length, f->ifilter, f->length);
-		out->im = mac(qptr - f->length, f->qfilter, f->length);
-	}
+static inline void advance(struct filter *f)
+{
+	f->pointer = (f->pointer + 1) & f->mask;
+}
 
-	if (f->pointer == BufferLen) {
-		iptr = f->ibuffer + BufferLen - f->length;
-		qptr = f->qbuffer + BufferLen - f->length;
-		memcpy(f->ibuffer, iptr, f->length * sizeof(float));
-		memcpy(f->qbuffer, qptr, f->length * sizeof(float));
-		f->pointer = f->length;
-	}
+/*
+ * The 'length' samples preceding the one at 'pos' in the ring.
+ */
+static inline gint window(struct filter *f, gint pos)
+{
+	return (pos - f->length) & f->mask;
+}
 
-	if (f->counter == f->decimateratio) {
+/*
+ * The output is taken over the 'length' samples preceding the
+ * current input, so the filters have one sample of extra delay.
+ */
+static inline gboolean output_due(struct filter *f)
+{
+	if (++f->counter == f->decimateratio) {
 		f->counter = 0;
-		return 1;
+		return TRUE;
+	}
+	return FALSE;
+}
+
+gint filter_run(struct filter *f, complex in, complex *out)
+{
+	gint w, ret = 0;
+
+	if (output_due(f)) {
+		w = window(f, f->pointer);
+		*out = mac_iq(f->ibuffer + w, f->qbuffer + w,
+			      f->ifilter, f->qfilter, f->length);
+		ret = 1;
 	}
 
-	return 0;
+	push(f, f->ihistory, c_re(in));
+	push(f, f->qhistory, c_im(in));
+	advance(f);
+
+	return ret;
 }
 
 gint filter_I_run(struct filter *f, gfloat in, gfloat *out)
 {
-	gfloat *iptr = f->ibuffer + f->pointer;
+	gint ret = 0;
 
-	f->pointer++;
-	f->counter++;
+	if (output_due(f)) {
+		*out = mac(f->ibuffer + window(f, f->pointer), f->ifilter,
+			   f->length);
+		ret = 1;
+	}
 
-	*iptr = in;
+	push(f, f->ihistory, in);
+	advance(f);
 
-	if (f->counter == f->decimateratio) {
-		*out = mac(iptr - f->length, f->ifilter, f->length);
-	}
+	return ret;
+}
+
+gint filter_Q_run(struct filter *f, gfloat in, gfloat *out)
+{
+	gint ret = 0;
 
-	if (f->pointer == BufferLen) {
-		iptr = f->ibuffer + BufferLen - f->length;
-		memcpy(f->ibuffer, iptr, f->length * sizeof(float));
-		f->pointer = f->length;
+	if (output_due(f)) {
+		*out = mac(f->qbuffer + window(f, f->pointer), f->qfilter,
+			   f->length);
+		ret = 1;
 	}
 
-	if (f->counter == f->decimateratio) {
-		f->counter = 0;
-		return 1;
+	push(f, f->qhistory, in);
+	advance(f);
+
+	return ret;
+}
+
+/*
+ * Compute the outputs for the 'n' samples already written to the
+ * history from f->pointer on, and advance past them.
+ */
+static gint run_chunk(struct filter *f, gint n, complex *out)
+{
+	gint i, w, m = 0;
+
+	for (i = 0; i < n; i++) {
+		if (output_due(f)) {
+			w = window(f, f->pointer + i);
+			out[m++] = mac_iq(f->ibuffer + w, f->qbuffer + w,
+					  f->ifilter, f->qfilter, f->length);
+		}
 	}
 
-	return 0;
+	f->pointer = (f->pointer + n) & f->mask;
+
+	return m;
 }
 
-gint filter_Q_run(struct filter *f, gfloat in, gfloat *out)
+/*
+ * Run 'n' samples through the filter. Returns the number of output
+ * samples stored in 'out', which is n / decimateratio rounded either
+ * way depending on where in the decimation cycle the filter is.
+ * 'out' may be the same array as 'in'.
+ *
+ * The input is written to the history a chunk at a time and every
+ * window is then read straight out of the mirrored ring.
+ */
+gint filter_run_block(struct filter *f, const complex *in, gint n, complex *out)
 {
-	gfloat *qptr = f->ibuffer + f->pointer;
+	gint chunk, i, m = 0;
+	gfloat *ibuf, *qbuf;
 
-	f->pointer++;
-	f->counter++;
+	while (n > 0) {
+		chunk = MIN(n, f->mask + 1 - f->length);
 
-	*qptr = in;
+		ibuf = f->ibuffer + f->pointer;
+		qbuf = f->qbuffer + f->pointer;
 
-	if (f->counter == f->decimateratio) {
-		*out = mac(qptr - f->length, f->qfilter, f->length);
-	}
+		for (i = 0; i < chunk; i++) {
+			ibuf[i] = c_re(in[i]);
+			qbuf[i] = c_im(in[i]);
+		}
+
+		mirror_sync(f->ihistory, f->pointer * sizeof(gfloat),
+			    chunk * sizeof(gfloat));
+		mirror_sync(f->qhistory, f->pointer * sizeof(gfloat),
+			    chunk * sizeof(gfloat));
+
+		m += run_chunk(f, chunk, out + m);
 
-	if (f->pointer == BufferLen) {
-		qptr = f->qbuffer + BufferLen - f->length;
-		memcpy(f->qbuffer, qptr, f->length * sizeof(float));
-		f->pointer = f->length;
+		in += chunk;
+		n -= chunk;
 	}
 
-	if (f->counter == f->decimateratio) {
-		f->counter = 0;
-		return 1;
+	return m;
+}
+
+/*
+ * Same as above but with the same real sample fed to both the I and
+ * the Q filter, which is what a Hilbert transformer wants.
+ */
+gint filter_run_block_real(struct filter *f, const gfloat *in, gint n, complex *out)
+{
+	gint chunk, m = 0;
+
+	while (n > 0) {
+		chunk = MIN(n, f->mask + 1 - f->length);
+
+		memcpy(f->ibuffer + f->pointer, in, chunk * sizeof(gfloat));
+		memcpy(f->qbuffer + f->pointer, in, chunk * sizeof(gfloat));
+
+		mirror_sync(f->ihistory, f->pointer * sizeof(gfloat),
+			    chunk * sizeof(gfloat));
+		mirror_sync(f->qhistory, f->pointer * sizeof(gfloat),
+			    chunk * sizeof(gfloat));
+
+		m += run_chunk(f, chunk, out + m);
+
+		in += chunk;
+		n -= chunk;
 	}
 
-	return 0;
+	return m;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -28,34 +28,23 @@
 #include <glib.h>
 
 #include "cmplx.h"
+#include "mac.h"
+#include "mirror.h"
 
-#define BufferLen	1024
-
-/* ---------------------------------------------------------------------- */
-
-#ifdef __OPTIMIZE__
-
-#ifdef __i386__
-#include "filter-i386.h"
-#endif				/* __i386__ */
-
-
-#ifndef __HAVE_ARCH_MAC
-extern __inline__ float mac(const gfloat *a, const gfloat *b, guint size)
-{
-	gfloat sum = 0;
-	guint i;
-
-	for (i = 0; i < size; i++)
-		sum += (*a++) * (*b++);
-	return sum;
-}
-#endif				/* __HAVE_ARCH_MAC */
-
-#endif				/* __OPTIMIZE__ */
+/*
+ * Callers of the block functions feed at most this many samples at
+ * a time, so their scratch buffers can live on the stack.
+ */
+#define FILTER_BLOCKLEN	512
 
 /* ---------------------------------------------------------------------- */
 
+/*
+ * The history is a ring in mirrored memory (see mirror.h) with the
+ * next sample going to buffer[pointer], so the last 'length' samples
+ * are always available in order starting at
+ * buffer + ((pointer - length) & mask).
+ */
 struct filter {
 	gint length;
 	gint decimateratio;
@@ -63,9 +52,13 @@ struct filter {
 	gfloat *ifilter;
 	gfloat *qfilter;
 
-	gfloat ibuffer[BufferLen];
-	gfloat qbuffer[BufferLen];
+	struct mirror *ihistory;
+	struct mirror *qhistory;
+
+	gfloat *ibuffer;
+	gfloat *qbuffer;
 
+	gint mask;
 	gint pointer;
 	gint counter;
 };
@@ -80,6 +73,9 @@ extern gint filter_run(struct filter *f, complex in, complex *out);
 extern gint filter_I_run(struct filter *f, gfloat in, gfloat *out);
 extern gint filter_Q_run(struct filter *f, gfloat in, gfloat *out);
 
+extern gint filter_run_block(struct filter *f, const complex *in, gint n, complex *out);
+extern gint filter_run_block_real(struct filter *f, const gfloat *in, gint n, complex *out);
+
 extern void filter_dump(struct filter *f);
 
 /* ---------------------------------------------------------------------- */
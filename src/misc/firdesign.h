@@ -0,0 +1,132 @@
+/*
+ *    firdesign.h  --  Windowed sinc FIR design
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _FIRDESIGN_H
+#define _FIRDESIGN_H
+
+#include <math.h>
+
+/*
+ * The windowed sinc filter design of filter.c, firfilt.c and fftfilt.c,
+ * and the sliding FFT twiddle scale of sfft.c. It uses no glib so that
+ * the gentables program can include it and build the very same tables
+ * at compile time.
+ */
+
+/*
+ * The sliding FFT twiddles are scaled down a little to keep the bins
+ * from drifting with accumulated rounding errors.
+ */
+#define	SFFT_STABCOEFF	0.9999
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Sinc done properly.
+ */
+static inline double fir_sinc(double x)
+{
+	if (fabs(x) < 1e-10)
+		return 1.0;
+	else
+		return sin(M_PI * x) / (M_PI * x);
+}
+
+/*
+ * Don't ask...
+ */
+static inline double fir_cosc(double x)
+{
+	if (fabs(x) < 1e-10)
+		return 0.0;
+	else
+		return (1.0 - cos(M_PI * x)) / (M_PI * x);
+}
+
+/*
+ * Hamming window function.
+ */
+static inline double fir_hamming(double x)
+{
+	return 0.54 - 0.46 * cos(2 * M_PI * x);
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * One tap of a band pass FIR filter with 6 dB corner frequencies of
+ * 'f1' and 'f2'. (0 <= f1 < f2 <= 0.5)
+ */
+static inline double fir_tap(int i, int len, int hilbert,
+			     double f1, double f2)
+{
+	double t, h, x;
+
+	t = i - (len - 1.0) / 2.0;
+	h = i * (1.0 / (len - 1.0));
+
+	if (!hilbert) {
+		x = (2 * f2 * fir_sinc(2 * f2 * t) -
+		     2 * f1 * fir_sinc(2 * f1 * t)) * fir_hamming(h);
+	} else {
+		x = (2 * f2 * fir_cosc(2 * f2 * t) -
+		     2 * f1 * fir_cosc(2 * f1 * t)) * fir_hamming(h);
+		/*
+		 * The actual filter code assumes the impulse response
+		 * is in time reversed order. This will be anti-
+		 * symmetric so the minus sign handles that for us.
+		 */
+		x = -x;
+	}
+
+	return x;
+}
+
+/*
+ * Fill 'fir' with the 'len' taps of the filter above.
+ */
+static inline void fir_design(float *fir, int len, int hilbert,
+			      double f1, double f2)
+{
+	int i;
+
+	for (i = 0; i < len; i++)
+		fir[i] = fir_tap(i, len, hilbert, f1, f2);
+}
+
+/*
+ * Same in double precision, for the FFT filter spectra.
+ */
+static inline void fir_design_double(double *fir, int len, int hilbert,
+				     double f1, double f2)
+{
+	int i;
+
+	for (i = 0; i < len; i++)
+		fir[i] = fir_tap(i, len, hilbert, f1, f2);
+}
+
+/* ---------------------------------------------------------------------- */
+
+#endif				/* _FIRDESIGN_H */
@@ -0,0 +1,459 @@
+/*
+ *    firfilt.c  --  Band pass filter with a timed choice of engine
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "firfilt.h"
+#include "filter.h"
+#include "firdesign.h"
+#include "misc.h"
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * The engine chosen for each (length, factor) pair so far. The list
+ * can be saved with firfilt_get_tuning() and handed back on the next
+ * run with firfilt_set_tuning(), so the timing is done only once.
+ */
+struct tuning {
+	gint len;
+	gint factor;
+	gint engine;
+
+	struct tuning *next;
+};
+
+static struct tuning *tunings = NULL;
+static gboolean tunings_changed = FALSE;
+static pthread_mutex_t tune_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const gchar *engine_names[] = { "direct", "fft" };
+
+static gint lookup(gint len, gint factor);
+
+/* ---------------------------------------------------------------------- */
+
+static struct firfilt *filt_new(gdouble f1, gdouble f2, gint len,
+				gint factor, gint engine)
+{
+	struct firfilt *f;
+	gfloat *taps;
+
+	f = g_new0(struct firfilt, 1);
+
+	f->length = len;
+	f->factor = factor;
+	f->engine = engine;
+
+	if (engine == FIRFILT_FFT) {
+		if ((f->fft = fftfilt_init(f1, f2, 2 * (len - 1))) == NULL) {
+			firfilt_free(f);
+			return NULL;
+		}
+		f->phase = factor - 1;
+		return f;
+	}
+
+	taps = g_new(gfloat, len);
+	fir_design(taps, len, 0, f1, f2);
+	f->dec = decimator_init(len, factor, taps);
+	g_free(taps);
+
+	/*
+	 * The decimator output at an input is over the samples before
+	 * it. Line the outputs up with the FFT engine by starting one
+	 * input early and throwing that first output away.
+	 */
+	f->dec->counter = factor - 1;
+	f->skip = TRUE;
+
+	f->outlen = FILTER_BLOCKLEN;
+	f->outbuf = g_new(complex, f->outlen);
+
+	return f;
+}
+
+/*
+ * Rough choice for a pair that has not been timed: the FFT engine
+ * costs some eight multiplies per input for each doubling of its
+ * length, the direct one len / factor.
+ */
+static gint guess(gint len, gint factor)
+{
+	gint n, cost = 0;
+
+	for (n = 2 * (len - 1); n > 1; n >>= 1)
+		cost += 8;
+
+	return (len / factor > cost) ? FIRFILT_FFT : FIRFILT_DIRECT;
+}
+
+/*
+ * Create a filter with 6 dB corner frequencies of 'f1' and 'f2'
+ * (0 <= f1 < f2 <= 0.5), 'len' taps (odd) and output decimated by
+ * 'factor'. The engine is the one named in the GMFSK_FIRFILT
+ * environment variable, else the faster one if 'len' and 'factor'
+ * have been timed (see firfilt_pretune()), else a guess. The timing
+ * is never done here, so a mode switch does not wait for it.
+ */
+struct firfilt *firfilt_init(gdouble f1, gdouble f2, gint len, gint factor)
+{
+	const gchar *want;
+	gint engine;
+
+	g_return_val_if_fail(len >= 3 && (len & 1) && factor > 0, NULL);
+
+	if ((want = getenv("GMFSK_FIRFILT")) != NULL)
+		engine = strcmp(want, "direct") ? FIRFILT_FFT : FIRFILT_DIRECT;
+	else {
+		pthread_mutex_lock(&tune_mutex);
+		engine = lookup(len, factor);
+		pthread_mutex_unlock(&tune_mutex);
+
+		if (engine < 0)
+			engine = guess(len, factor);
+	}
+
+	return filt_new(f1, f2, len, factor, engine);
+}
+
+void firfilt_free(struct firfilt *f)
+{
+	if (f) {
+		decimator_free(f->dec);
+		fftfilt_free(f->fft);
+		g_free(f->outbuf);
+		g_free(f);
+	}
+}
+
+/*
+ * The new taps are designed aside and swapped in, the running ones are
+ * not rewritten.
+ */
+void firfilt_set_freqs(struct firfilt *f, gdouble f1, gdouble f2)
+{
+	gfloat *taps;
+
+	if (f->engine == FIRFILT_FFT) {
+		fftfilt_set_freqs(f->fft, f1, f2);
+		return;
+	}
+
+	taps = g_new(gfloat, f->length);
+	fir_design(taps, f->length, 0, f1, f2);
+	decimator_set_taps(f->dec, taps);
+}
+
+/*
+ * Filter a block of 'n' samples. Returns the number of output
+ * samples and points 'out' at them. The output stays valid until
+ * the next call.
+ */
+gint firfilt_run_block(struct firfilt *f, const complex *in, gint n,
+		       complex **out)
+{
+	complex *zp;
+	gint i, m;
+
+	if (f->engine == FIRFILT_FFT) {
+		n = fftfilt_run_block(f->fft, in, n, &zp);
+
+		if (f->factor == 1) {
+			*out = zp;
+			return n;
+		}
+
+		/* keep every 'factor'th output, in place */
+		for (m = 0, i = f->phase; i < n; i += f->factor)
+			zp[m++] = zp[i];
+
+		f->phase = i - n;
+
+		*out = zp;
+		return m;
+	}
+
+	if (n > f->outlen) {
+		f->outlen = n;
+		f->outbuf = g_renew(complex, f->outbuf, f->outlen);
+	}
+
+	zp = f->outbuf;
+	m = decimator_run(f->dec, in, n, zp);
+
+	if (f->skip && m > 0) {
+		f->skip = FALSE;
+		zp++;
+		m--;
+	}
+
+	*out = zp;
+	return m;
+}
+
+const gchar *firfilt_name(struct firfilt *f)
+{
+	return engine_names[f->engine];
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Seconds it takes 'f' to filter 'num' samples. The best of a few
+ * runs, to keep other processes from spoiling the comparison.
+ */
+static gdouble bench(struct firfilt *f, const complex *in, gint num)
+{
+	GTimer *timer;
+	complex *out;
+	gdouble t, best = 0.0;
+	gint i, j, n;
+
+	timer = g_timer_new();
+
+	for (i = 0; i < 3; i++) {
+		g_timer_start(timer);
+
+		for (j = 0; j < num; j += n) {
+			n = MIN(num - j, FILTER_BLOCKLEN);
+			firfilt_run_block(f, in + j, n, &out);
+		}
+
+		g_timer_stop(timer);
+
+		t = g_timer_elapsed(timer, NULL);
+
+		if (i == 0 || t < best)
+			best = t;
+	}
+
+	g_timer_destroy(timer);
+
+	return best;
+}
+
+static gint lookup(gint len, gint factor)
+{
+	struct tuning *t;
+
+	for (t = tunings; t; t = t->next)
+		if (t->len == len && t->factor == factor)
+			return t->engine;
+
+	return -1;
+}
+
+static void remember(gint len, gint factor, gint engine)
+{
+	struct tuning *t;
+
+	if (lookup(len, factor) >= 0)
+		return;
+
+	t = g_new0(struct tuning, 1);
+
+	t->len = len;
+	t->factor = factor;
+	t->engine = engine;
+
+	t->next = tunings;
+	tunings = t;
+}
+
+/*
+ * Return the faster engine for a 'len' tap filter decimating by
+ * 'factor'. The first call for a pair times both engines on a few
+ * FFT blocks worth of signal, which takes a fraction of a second
+ * for the longest filters the modems use.
+ */
+gint firfilt_tune(gint len, gint factor)
+{
+	struct firfilt *f;
+	complex *in;
+	gdouble t[2];
+	gint i, num, engine;
+
+	pthread_mutex_lock(&tune_mutex);
+	engine = lookup(len, factor);
+	pthread_mutex_unlock(&tune_mutex);
+
+	if (engine >= 0)
+		return engine;
+
+	num = MAX(8 * FILTER_BLOCKLEN, 4 * (len - 1));
+
+	in = g_new(complex, num);
+
+	for (i = 0; i < num; i++) {
+		c_re(in[i]) = cos(0.3 * i);
+		c_im(in[i]) = sin(0.3 * i);
+	}
+
+	for (engine = FIRFILT_DIRECT; engine <= FIRFILT_FFT; engine++) {
+		if ((f = filt_new(0.05, 0.15, len, factor, engine)) == NULL) {
+			t[engine] = G_MAXDOUBLE;
+			continue;
+		}
+		t[engine] = bench(f, in, num);
+		firfilt_free(f);
+	}
+
+	g_free(in);
+
+	engine = (t[FIRFILT_FFT] < t[FIRFILT_DIRECT]) ? FIRFILT_FFT : FIRFILT_DIRECT;
+
+	pthread_mutex_lock(&tune_mutex);
+	remember(len, factor, engine);
+	tunings_changed = TRUE;
+	pthread_mutex_unlock(&tune_mutex);
+
+	return engine;
+}
+
+struct pretune {
+	gint *sizes;
+	gint num;
+};
+
+static void *pretune_loop(void *args)
+{
+	struct pretune *pt = args;
+	gint i;
+
+	for (i = 0; i < pt->num; i++)
+		firfilt_tune(pt->sizes[2 * i], pt->sizes[2 * i + 1]);
+
+	g_free(pt->sizes);
+	g_free(pt);
+
+	return NULL;
+}
+
+/*
+ * Time the engines for 'num' (length, factor) pairs, given one after
+ * the other in 'sizes', on a background thread. Pairs already timed
+ * are skipped, so only the first run of the program does the work.
+ */
+void firfilt_pretune(const gint *sizes, gint num)
+{
+	struct pretune *pt;
+	pthread_attr_t attr;
+	pthread_t thread;
+
+	pt = g_new0(struct pretune, 1);
+	pt->sizes = g_memdup(sizes, 2 * num * sizeof(gint));
+	pt->num = num;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+	if (pthread_create(&thread, &attr, pretune_loop, pt) != 0) {
+		g_warning("firfilt_pretune: pthread_create: %m\n");
+		g_free(pt->sizes);
+		g_free(pt);
+	}
+
+	pthread_attr_destroy(&attr);
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * The tuning is saved as text, one "length factor engine" line per
+ * pair. Lines that do not parse are skipped, so a tuning from a
+ * newer or older version does no harm.
+ */
+void firfilt_set_tuning(const gchar *str)
+{
+	gchar **lines, name[16];
+	gint i, len, factor, engine;
+
+	if (str == NULL)
+		return;
+
+	lines = g_strsplit(str, "\n", 0);
+
+	pthread_mutex_lock(&tune_mutex);
+
+	for (i = 0; lines[i]; i++) {
+		if (sscanf(lines[i], "%d %d %15s", &len, &factor, name) != 3)
+			continue;
+
+		if (len < 3 || !(len & 1) || factor < 1)
+			continue;
+
+		for (engine = 0; engine < G_N_ELEMENTS(engine_names); engine++)
+			if (!strcmp(name, engine_names[engine]))
+				break;
+
+		if (engine < G_N_ELEMENTS(engine_names))
+			remember(len, factor, engine);
+	}
+
+	pthread_mutex_unlock(&tune_mutex);
+
+	g_strfreev(lines);
+}
+
+gchar *firfilt_get_tuning(void)
+{
+	struct tuning *t;
+	GString *s;
+
+	s = g_string_new("");
+
+	pthread_mutex_lock(&tune_mutex);
+
+	for (t = tunings; t; t = t->next)
+		g_string_append_printf(s, "%d %d %s\n", t->len, t->factor,
+				       engine_names[t->engine]);
+
+	tunings_changed = FALSE;
+
+	pthread_mutex_unlock(&tune_mutex);
+
+	return g_string_free(s, FALSE);
+}
+
+/*
+ * Returns TRUE if new pairs have been timed since the tuning was
+ * last fetched with firfilt_get_tuning().
+ */
+gboolean firfilt_tuning_changed(void)
+{
+	gboolean changed;
+
+	pthread_mutex_lock(&tune_mutex);
+	changed = tunings_changed;
+	pthread_mutex_unlock(&tune_mutex);
+
+	return changed;
+}
+
+/* ---------------------------------------------------------------------- */
@@ -0,0 +1,86 @@
+/*
+ *    firfilt.h  --  Band pass filter with a timed choice of engine
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _FIRFILT_H
+#define _FIRFILT_H
+
+#include <glib.h>
+
+#include "cmplx.h"
+#include "decimator.h"
+#include "fftfilt.h"
+
+/* ---------------------------------------------------------------------- */
+
+#define	FIRFILT_DIRECT	0
+#define	FIRFILT_FFT	1
+
+/*
+ * A complex band pass FIR filter that runs either as a direct
+ * convolution (decimator.c) or as a fast convolution (fftfilt.c).
+ * Both engines give the same outputs, up to rounding, so the caller
+ * does not need to know which one it got.
+ *
+ * The 'length' taps are the fftfilt_init() shape for an FFT of
+ * 2 * (length - 1) points. Output k is the filter output at input
+ * k * factor + factor - 1. The direct engine delivers it with the
+ * next input, the FFT engine in bursts every length - 1 inputs.
+ */
+struct firfilt {
+	gint length;
+	gint factor;
+	gint engine;
+
+	struct decimator *dec;
+	struct fftfilt *fft;
+
+	gint phase;		/* next FFT output to keep */
+	gboolean skip;		/* first direct output is not wanted */
+
+	complex *outbuf;
+	gint outlen;
+};
+
+/* ---------------------------------------------------------------------- */
+
+extern struct firfilt *firfilt_init(gdouble f1, gdouble f2, gint len, gint factor);
+extern void firfilt_free(struct firfilt *f);
+
+extern void firfilt_set_freqs(struct firfilt *f, gdouble f1, gdouble f2);
+
+extern gint firfilt_run_block(struct firfilt *f, const complex *in, gint n,
+			      complex **out);
+
+extern const gchar *firfilt_name(struct firfilt *f);
+
+extern gint firfilt_tune(gint len, gint factor);
+extern void firfilt_pretune(const gint *sizes, gint num);
+
+extern void firfilt_set_tuning(const gchar *str);
+extern gchar *firfilt_get_tuning(void);
+extern gboolean firfilt_tuning_changed(void);
+
+/* ---------------------------------------------------------------------- */
+
+#endif				/* _FIRFILT_H */
@@ -0,0 +1,155 @@
+/*
+ *    gentables.c  --  Write the tables of tables.h
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/*
+ * Run at build time, writes tables.c to standard output. It links
+ * with nothing but the C library, so it can be built and run before
+ * the rest of the tree.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "firdesign.h"
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Fixed filter designs. The 37 tap Hilbert transformer is in front
+ * of every receiver but PSK31 and CW.
+ */
+static const struct {
+	int len;
+	int hilbert;
+	float f1;
+	float f2;
+} firs[] = {
+	{ 37, 0, 0.05, 0.45 },
+	{ 37, 1, 0.05, 0.45 },
+};
+
+/*
+ * Sliding FFT lengths: the MFSK16 and MFSK8 symbol lengths.
+ */
+static const int twiddles[] = { 512, 1024 };
+
+#define	NFIRS		(sizeof(firs) / sizeof(firs[0]))
+#define	NTWIDDLES	(sizeof(twiddles) / sizeof(twiddles[0]))
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Floats get nine and doubles seventeen significant digits, enough
+ * for the compiler to read back exactly the same values.
+ */
+static void put_floats(const char *name, const float *v, int len)
+{
+	int i;
+
+	printf("static const gfloat %s[%d] = {\n", name, len);
+
+	for (i = 0; i < len; i++)
+		printf("%s% .8ef,%s", (i % 4) ? " " : "\t", v[i],
+		       (i % 4 == 3 || i == len - 1) ? "\n" : "");
+
+	printf("};\n\n");
+}
+
+static void put_doubles(const char *name, const double *v, int len)
+{
+	int i;
+
+	printf("static const gdouble %s[%d] = {\n", name, len);
+
+	for (i = 0; i < len; i++)
+		printf("%s% .16e,%s", (i % 3) ? " " : "\t", v[i],
+		       (i % 3 == 2 || i == len - 1) ? "\n" : "");
+
+	printf("};\n\n");
+}
+
+int main(void)
+{
+	char name[32];
+	float *fir;
+	double *re, *im;
+	unsigned int i;
+	int j, len;
+
+	printf("/* Generated by gentables, do not edit. */\n\n");
+	printf("#include \"tables.h\"\n\n");
+
+	/* same expressions as filter.c and sfft.c use at run time */
+	for (i = 0; i < NFIRS; i++) {
+		fir = malloc(firs[i].len * sizeof(float));
+
+		fir_design(fir, firs[i].len, firs[i].hilbert,
+			   firs[i].f1, firs[i].f2);
+
+		sprintf(name, "fir%u", i);
+		put_floats(name, fir, firs[i].len);
+
+		free(fir);
+	}
+
+	for (i = 0; i < NTWIDDLES; i++) {
+		len = twiddles[i];
+
+		re = malloc(len * sizeof(double));
+		im = malloc(len * sizeof(double));
+
+		for (j = 0; j < len; j++) {
+			re[j] = cos(j * 2.0 * M_PI / len) * SFFT_STABCOEFF;
+			im[j] = sin(j * 2.0 * M_PI / len) * SFFT_STABCOEFF;
+		}
+
+		sprintf(name, "tw%dre", len);
+		put_doubles(name, re, len);
+
+		sprintf(name, "tw%dim", len);
+		put_doubles(name, im, len);
+
+		free(re);
+		free(im);
+	}
+
+	printf("const struct fir_table fir_tables[] = {\n");
+
+	for (i = 0; i < NFIRS; i++)
+		printf("\t{ %d, %d, %.8ef, %.8ef, fir%u },\n", firs[i].len,
+		       firs[i].hilbert, firs[i].f1, firs[i].f2, i);
+
+	printf("\t{ 0, 0, 0.0, 0.0, NULL }\n};\n\n");
+
+	printf("const struct twiddle_table twiddle_tables[] = {\n");
+
+	for (i = 0; i < NTWIDDLES; i++)
+		printf("\t{ %d, tw%dre, tw%dim },\n", twiddles[i],
+		       twiddles[i], twiddles[i]);
+
+	printf("\t{ 0, NULL, NULL }\n};\n");
+
+	return 0;
+}
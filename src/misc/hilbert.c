@@ -0,0 +1,137 @@
+/*
+ *    hilbert.c  --  Hilbert transformer
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "hilbert.h"
+#include "filter.h"
+#include "mac.h"
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * The taps on even k go with the stream holding the newest sample,
+ * the ones on odd k with the other stream. The latter has one sample
+ * less in the window so it gets a zero first tap to make the two
+ * dot products the same length.
+ */
+static gfloat *split_taps(const gfloat *fir, gint len, gboolean even, gint size)
+{
+	gfloat *taps;
+	gint j, k;
+
+	taps = g_new0(gfloat, size);
+
+	for (j = size - 1, k = even ? len - 1 : len - 2; k >= 0; j--, k -= 2)
+		taps[j] = fir[k];
+
+	return taps;
+}
+
+struct hilbert *hilbert_init(gint len)
+{
+	struct hilbert *h;
+	struct filter *f;
+	gint center;
+
+	if ((len & 1) == 0) {
+		g_warning("hilbert_init: length must be odd\n");
+		return NULL;
+	}
+
+	if ((f = filter_init_hilbert(len, 1)) == NULL)
+		return NULL;
+
+	h = g_new0(struct hilbert, 1);
+
+	h->length = len;
+	h->size = (len + 1) / 2;
+
+	/*
+	 * The in-phase leg is nonzero only at an even distance from
+	 * the centre tap, the quadrature leg only at an odd distance.
+	 */
+	center = (len - 1) / 2;
+	h->swap = center & 1;
+
+	h->itaps = split_taps(f->ifilter, len, !h->swap, h->size);
+	h->qtaps = split_taps(f->qfilter, len, h->swap, h->size);
+
+	filter_free(f);
+
+	h->buffer[0] = g_new0(gfloat, 2 * h->size);
+	h->buffer[1] = g_new0(gfloat, 2 * h->size);
+
+	h->newest = 1;
+
+	return h;
+}
+
+void hilbert_free(struct hilbert *h)
+{
+	if (h) {
+		g_free(h->itaps);
+		g_free(h->qtaps);
+		g_free(h->buffer[0]);
+		g_free(h->buffer[1]);
+		g_free(h);
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Each output is taken over the samples preceding the input, as with
+ * filter_run(), so the delay is the same as with the plain FIR.
+ */
+void hilbert_run(struct hilbert *h, const gfloat *in, gint n, complex *out)
+{
+	gfloat *a, *b;
+	gint i, s, p;
+
+	for (i = 0; i < n; i++) {
+		s = h->newest;
+
+		a = h->buffer[s] + h->pointer[s];
+		b = h->buffer[!s] + h->pointer[!s];
+
+		if (h->swap)
+			out[i] = mac_iq(b, a, h->itaps, h->qtaps, h->size);
+		else
+			out[i] = mac_iq(a, b, h->itaps, h->qtaps, h->size);
+
+		/* the samples alternate between the two streams */
+		s = !s;
+		p = h->pointer[s];
+
+		h->buffer[s][p] = in[i];
+		h->buffer[s][p + h->size] = in[i];
+
+		if (++p == h->size)
+			p = 0;
+
+		h->pointer[s] = p;
+		h->newest = s;
+	}
+}
+
+/* ---------------------------------------------------------------------- */
@@ -0,0 +1,62 @@
+/*
+ *    hilbert.h  --  Hilbert transformer
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _HILBERT_H
+#define _HILBERT_H
+
+#include <glib.h>
+
+#include "cmplx.h"
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Makes an analytic signal out of a real one, with the same response
+ * as filter_init_hilbert(). Both legs of that filter have every other
+ * tap zero, the in-phase leg on the odd and the quadrature leg on the
+ * even distances from the centre tap. So the history is split into
+ * the even and the odd samples and each leg is a dense dot product
+ * over one of them, half the work of the plain FIR.
+ */
+struct hilbert {
+	gint length;
+	gint size;
+
+	gfloat *itaps;
+	gfloat *qtaps;
+
+	gfloat *buffer[2];
+	gint pointer[2];
+
+	gint newest;
+	gboolean swap;
+};
+
+extern struct hilbert *hilbert_init(gint len);
+extern void hilbert_free(struct hilbert *h);
+
+extern void hilbert_run(struct hilbert *h, const gfloat *in, gint n, complex *out);
+
+/* ---------------------------------------------------------------------- */
+#endif				/* _HILBERT_H */
@@ -0,0 +1,346 @@
+/*
+ *    mac.c  --  Multiply-accumulate kernels
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "mac.h"
+#include "cpu.h"
+
+#ifdef HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* ---------------------------------------------------------------------- */
+
+static gfloat mac_generic(const gfloat *a, const gfloat *b, guint len)
+{
+	gfloat sum = 0;
+	guint i;
+
+	for (i = 0; i < len; i++)
+		sum += (*a++) * (*b++);
+	return sum;
+}
+
+static complex mac_iq_generic(const gfloat *i, const gfloat *q,
+			      const gfloat *ifir, const gfloat *qfir,
+			      guint len)
+{
+	gfloat isum = 0, qsum = 0;
+	complex z;
+	guint k;
+
+	for (k = 0; k < len; k++) {
+		isum += i[k] * ifir[k];
+		qsum += q[k] * qfir[k];
+	}
+
+	z.re = isum;
+	z.im = qsum;
+	return z;
+}
+
+/* ---------------------------------------------------------------------- */
+
+#ifdef HAVE_X86_SIMD
+
+__attribute__ ((target("sse2")))
+static inline gfloat hsum_sse(__m128 v)
+{
+	v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+	v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+	return _mm_cvtss_f32(v);
+}
+
+__attribute__ ((target("avx")))
+static inline gfloat hsum_avx(__m256 v)
+{
+	return hsum_sse(_mm_add_ps(_mm256_castps256_ps128(v),
+				   _mm256_extractf128_ps(v, 1)));
+}
+
+__attribute__ ((target("sse2")))
+static gfloat mac_sse2(const gfloat *a, const gfloat *b, guint len)
+{
+	__m128 s0 = _mm_setzero_ps();
+	__m128 s1 = _mm_setzero_ps();
+	gfloat sum;
+	guint i = 0;
+
+	for (; i + 8 <= len; i += 8) {
+		s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(a + i),
+					       _mm_loadu_ps(b + i)));
+		s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(a + i + 4),
+					       _mm_loadu_ps(b + i + 4)));
+	}
+	if (i + 4 <= len) {
+		s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(a + i),
+					       _mm_loadu_ps(b + i)));
+		i += 4;
+	}
+
+	sum = hsum_sse(_mm_add_ps(s0, s1));
+
+	for (; i < len; i++)
+		sum += a[i] * b[i];
+	return sum;
+}
+
+__attribute__ ((target("sse2")))
+static complex mac_iq_sse2(const gfloat *i, const gfloat *q,
+			   const gfloat *ifir, const gfloat *qfir,
+			   guint len)
+{
+	__m128 si = _mm_setzero_ps();
+	__m128 sq = _mm_setzero_ps();
+	gfloat isum, qsum;
+	complex z;
+	guint k = 0;
+
+	for (; k + 4 <= len; k += 4) {
+		si = _mm_add_ps(si, _mm_mul_ps(_mm_loadu_ps(i + k),
+					       _mm_loadu_ps(ifir + k)));
+		sq = _mm_add_ps(sq, _mm_mul_ps(_mm_loadu_ps(q + k),
+					       _mm_loadu_ps(qfir + k)));
+	}
+
+	isum = hsum_sse(si);
+	qsum = hsum_sse(sq);
+
+	for (; k < len; k++) {
+		isum += i[k] * ifir[k];
+		qsum += q[k] * qfir[k];
+	}
+
+	z.re = isum;
+	z.im = qsum;
+	return z;
+}
+
+__attribute__ ((target("avx")))
+static gfloat mac_avx(const gfloat *a, const gfloat *b, guint len)
+{
+	__m256 s0 = _mm256_setzero_ps();
+	__m256 s1 = _mm256_setzero_ps();
+	gfloat sum;
+	guint i = 0;
+
+	for (; i + 16 <= len; i += 16) {
+		s0 = _mm256_add_ps(s0, _mm256_mul_ps(_mm256_loadu_ps(a + i),
+						     _mm256_loadu_ps(b + i)));
+		s1 = _mm256_add_ps(s1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8),
+						     _mm256_loadu_ps(b + i + 8)));
+	}
+	if (i + 8 <= len) {
+		s0 = _mm256_add_ps(s0, _mm256_mul_ps(_mm256_loadu_ps(a + i),
+						     _mm256_loadu_ps(b + i)));
+		i += 8;
+	}
+
+	sum = hsum_avx(_mm256_add_ps(s0, s1));
+
+	for (; i < len; i++)
+		sum += a[i] * b[i];
+	return sum;
+}
+
+__attribute__ ((target("avx")))
+static complex mac_iq_avx(const gfloat *i, const gfloat *q,
+			  const gfloat *ifir, const gfloat *qfir,
+			  guint len)
+{
+	__m256 si = _mm256_setzero_ps();
+	__m256 sq = _mm256_setzero_ps();
+	gfloat isum, qsum;
+	complex z;
+	guint k = 0;
+
+	for (; k + 8 <= len; k += 8) {
+		si = _mm256_add_ps(si, _mm256_mul_ps(_mm256_loadu_ps(i + k),
+						     _mm256_loadu_ps(ifir + k)));
+		sq = _mm256_add_ps(sq, _mm256_mul_ps(_mm256_loadu_ps(q + k),
+						     _mm256_loadu_ps(qfir + k)));
+	}
+
+	isum = hsum_avx(si);
+	qsum = hsum_avx(sq);
+
+	for (; k < len; k++) {
+		isum += i[k] * ifir[k];
+		qsum += q[k] * qfir[k];
+	}
+
+	z.re = isum;
+	z.im = qsum;
+	return z;
+}
+
+__attribute__ ((target("avx,fma")))
+static gfloat mac_fma(const gfloat *a, const gfloat *b, guint len)
+{
+	__m256 s0 = _mm256_setzero_ps();
+	__m256 s1 = _mm256_setzero_ps();
+	gfloat sum;
+	guint i = 0;
+
+	for (; i + 16 <= len; i += 16) {
+		s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i),
+				     _mm256_loadu_ps(b + i), s0);
+		s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8),
+				     _mm256_loadu_ps(b + i + 8), s1);
+	}
+	if (i + 8 <= len) {
+		s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i),
+				     _mm256_loadu_ps(b + i), s0);
+		i += 8;
+	}
+
+	sum = hsum_avx(_mm256_add_ps(s0, s1));
+
+	for (; i < len; i++)
+		sum += a[i] * b[i];
+	return sum;
+}
+
+__attribute__ ((target("avx,fma")))
+static complex mac_iq_fma(const gfloat *i, const gfloat *q,
+			  const gfloat *ifir, const gfloat *qfir,
+			  guint len)
+{
+	__m256 si = _mm256_setzero_ps();
+	__m256 sq = _mm256_setzero_ps();
+	gfloat isum, qsum;
+	complex z;
+	guint k = 0;
+
+	for (; k + 8 <= len; k += 8) {
+		si = _mm256_fmadd_ps(_mm256_loadu_ps(i + k),
+				     _mm256_loadu_ps(ifir + k), si);
+		sq = _mm256_fmadd_ps(_mm256_loadu_ps(q + k),
+				     _mm256_loadu_ps(qfir + k), sq);
+	}
+
+	isum = hsum_avx(si);
+	qsum = hsum_avx(sq);
+
+	for (; k < len; k++) {
+		isum += i[k] * ifir[k];
+		qsum += q[k] * qfir[k];
+	}
+
+	z.re = isum;
+	z.im = qsum;
+	return z;
+}
+
+#endif				/* HAVE_X86_SIMD */
+
+/* ---------------------------------------------------------------------- */
+
+struct mac_impl {
+	const gchar *name;
+	guint features;
+	gfloat (*mac) (const gfloat *, const gfloat *, guint);
+	complex (*mac_iq) (const gfloat *, const gfloat *,
+			   const gfloat *, const gfloat *, guint);
+};
+
+/*
+ * In order of preference.
+ */
+static const struct mac_impl mac_impls[] = {
+#ifdef HAVE_X86_SIMD
+	{ "fma",	CPU_AVX | CPU_FMA,	mac_fma,	mac_iq_fma	},
+	{ "avx",	CPU_AVX,		mac_avx,	mac_iq_avx	},
+	{ "sse2",	CPU_SSE2,		mac_sse2,	mac_iq_sse2	},
+#endif
+	{ "generic",	0,			mac_generic,	mac_iq_generic	},
+};
+
+#define N_IMPLS	(sizeof(mac_impls) / sizeof(mac_impls[0]))
+
+static const struct mac_impl *mac_impl = NULL;
+
+static gfloat mac_first(const gfloat *a, const gfloat *b, guint len)
+{
+	mac_init();
+	return mac(a, b, len);
+}
+
+static complex mac_iq_first(const gfloat *i, const gfloat *q,
+			    const gfloat *ifir, const gfloat *qfir,
+			    guint len)
+{
+	mac_init();
+	return mac_iq(i, q, ifir, qfir, len);
+}
+
+gfloat (*mac)(const gfloat *a, const gfloat *b, guint len) = mac_first;
+
+complex (*mac_iq)(const gfloat *i, const gfloat *q,
+		  const gfloat *ifir, const gfloat *qfir, guint len) = mac_iq_first;
+
+/*
+ * Pick the implementation. Calling this more than once, even from
+ * several threads at the same time, is harmless as every call makes
+ * the same choice.
+ */
+void mac_init(void)
+{
+	const struct mac_impl *impl = NULL;
+	const gchar *want;
+	guint i, cpu;
+
+	cpu = cpu_features();
+	want = getenv("GMFSK_MAC");
+
+	for (i = 0; i < N_IMPLS; i++) {
+		if ((mac_impls[i].features & cpu) != mac_impls[i].features)
+			continue;
+		if (want && strcmp(want, mac_impls[i].name))
+			continue;
+		impl = &mac_impls[i];
+		break;
+	}
+
+	if (!impl) {
+		g_warning("mac_init: '%s' not available\n", want);
+		impl = &mac_impls[N_IMPLS - 1];
+	}
+
+	mac = impl->mac;
+	mac_iq = impl->mac_iq;
+	mac_impl = impl;
+}
+
+const gchar *mac_name(void)
+{
+	if (!mac_impl)
+		mac_init();
+
+	return mac_impl->name;
+}
+
+/* ---------------------------------------------------------------------- */
@@ -0,0 +1,53 @@
+/*
+ *    mac.h  --  Multiply-accumulate kernels
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _MAC_H
+#define _MAC_H
+
+#include <glib.h>
+
+#include "cmplx.h"
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Dot products used by the FIR filters. These point to the fastest
+ * implementation the CPU supports, chosen the first time one of them
+ * is called. Setting the environment variable GMFSK_MAC to the name
+ * of an implementation ("generic", "sse2", "avx" or "fma") forces
+ * that one instead, if the CPU can run it.
+ */
+
+/* sum of a[i] * b[i] */
+extern gfloat (*mac)(const gfloat *a, const gfloat *b, guint len);
+
+/* both sums of filter_run() in one pass: re = i.ifir, im = q.qfir */
+extern complex (*mac_iq)(const gfloat *i, const gfloat *q,
+			 const gfloat *ifir, const gfloat *qfir, guint len);
+
+extern void mac_init(void);
+extern const gchar *mac_name(void);
+
+/* ---------------------------------------------------------------------- */
+#endif				/* _MAC_H */
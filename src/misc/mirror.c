@@ -0,0 +1,160 @@
+/*
+ *    mirror.c  --  Ring buffer memory mapped twice back to back
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include "mirror.h"
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Get a file descriptor for 'size' bytes of anonymous shared memory,
+ * or -1 if there is no way to.
+ */
+static gint mirror_fd(gsize size)
+{
+#if defined(__linux__) && defined(SYS_memfd_create)
+	gint fd;
+
+	if ((fd = syscall(SYS_memfd_create, "gmfsk-mirror", 0)) < 0)
+		return -1;
+
+	if (ftruncate(fd, size) < 0) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+#else
+	return -1;
+#endif
+}
+
+/*
+ * Map the memory twice into a reserved region of 2 * size bytes.
+ */
+static guchar *mirror_map(gsize size)
+{
+	guchar *addr;
+	gint fd;
+
+	if ((fd = mirror_fd(size)) < 0)
+		return NULL;
+
+	addr = mmap(NULL, 2 * size, PROT_NONE,
+		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (addr == MAP_FAILED) {
+		close(fd);
+		return NULL;
+	}
+
+	if (mmap(addr, size, PROT_READ | PROT_WRITE,
+		 MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+	    mmap(addr + size, size, PROT_READ | PROT_WRITE,
+		 MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+		munmap(addr, 2 * size);
+		close(fd);
+		return NULL;
+	}
+
+	/* the mappings keep the memory */
+	close(fd);
+
+	return addr;
+}
+
+/*
+ * Create a mirrored block of at least 'minsize' bytes. The size is
+ * rounded up to a power of two and to at least one page, so it can
+ * hold a ring of any power of two sized elements indexed with a mask.
+ * The memory starts out zeroed.
+ */
+struct mirror *mirror_new(gsize minsize)
+{
+	struct mirror *m;
+	gsize size;
+
+	size = sysconf(_SC_PAGESIZE);
+
+	while (size < minsize)
+		size <<= 1;
+
+	m = g_new0(struct mirror, 1);
+
+	m->size = size;
+
+	if ((m->data = mirror_map(size)) != NULL) {
+		m->mapped = TRUE;
+	} else {
+		m->data = g_new0(guchar, 2 * size);
+		m->mapped = FALSE;
+	}
+
+	return m;
+}
+
+void mirror_free(struct mirror *m)
+{
+	if (m) {
+		if (m->mapped)
+			munmap(m->data, 2 * m->size);
+		else
+			g_free(m->data);
+
+		g_free(m);
+	}
+}
+
+/*
+ * Make the two copies equal after 'len' bytes were written starting
+ * at 'offset' in the first copy, possibly running on into the second
+ * one. Nothing to do when the memory is really mapped twice.
+ */
+void mirror_sync(struct mirror *m, gsize offset, gsize len)
+{
+	gsize n;
+
+	if (m->mapped || len == 0)
+		return;
+
+	n = MIN(len, m->size - offset);
+
+	memcpy(m->data + m->size + offset, m->data + offset, n);
+
+	if (n < len)
+		memcpy(m->data, m->data + m->size, len - n);
+}
+
+/* ---------------------------------------------------------------------- */
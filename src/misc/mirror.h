@@ -0,0 +1,59 @@
+/*
+ *    mirror.h  --  Ring buffer memory mapped twice back to back
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _MIRROR_H
+#define _MIRROR_H
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A block of 'size' bytes that is also visible again right after
+ * itself, at data + size. Anything up to 'size' bytes long starting
+ * anywhere in the first copy is then contiguous in memory, so a ring
+ * buffer kept in it never has to wrap a window or copy its history.
+ *
+ * Where the system can not map the same memory twice 'mapped' is
+ * FALSE and the second copy is ordinary memory; writers then call
+ * mirror_sync() on what they have written to keep the copies equal.
+ */
+struct mirror {
+	guchar *data;
+	gsize size;
+	gboolean mapped;
+};
+
+extern struct mirror *mirror_new(gsize minsize);
+extern void mirror_free(struct mirror *m);
+
+extern void mirror_sync(struct mirror *m, gsize offset, gsize len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif				/* _MIRROR_H */
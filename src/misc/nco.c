@@ -0,0 +1,331 @@
+/*
+ *    nco.c  --  Numerically controlled oscillator and mixer
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <math.h>
+#include <pthread.h>
+
+#include "nco.h"
+#include "cpu.h"
+
+#ifdef HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * The kernels mix 'len' samples, a multiple of NCO_LANES, with the
+ * phasors p[] and advance each of them by 'w' every NCO_LANES samples.
+ * All of them do the same multiplies in the same order as cmul() so
+ * the results do not depend on the kernel picked.
+ */
+typedef void (*mix_func) (complex *p, complex w,
+			  const complex *in, complex *out, gint len);
+typedef void (*mix_real_func) (complex *p, complex w,
+			       const gfloat *in, complex *out, gint len);
+
+static void mix_generic(complex *p, complex w,
+			const complex *in, complex *out, gint len)
+{
+	gint i, k;
+
+	for (i = 0; i < len; i += NCO_LANES) {
+		for (k = 0; k < NCO_LANES; k++) {
+			out[i + k] = cmul(in[i + k], p[k]);
+			p[k] = cmul(p[k], w);
+		}
+	}
+}
+
+static void mix_real_generic(complex *p, complex w,
+			     const gfloat *in, complex *out, gint len)
+{
+	gint i, k;
+
+	for (i = 0; i < len; i += NCO_LANES) {
+		for (k = 0; k < NCO_LANES; k++) {
+			c_re(out[i + k]) = in[i + k] * c_re(p[k]);
+			c_im(out[i + k]) = in[i + k] * c_im(p[k]);
+			p[k] = cmul(p[k], w);
+		}
+	}
+}
+
+#ifdef HAVE_X86_SIMD
+
+/* (xr * fr, xi * fr) + (-xi * fi, xr * fi) */
+__attribute__ ((target("sse2")))
+static inline __m128d cmul_sse2(__m128d x, __m128d fr, __m128d fi)
+{
+	const __m128d sign = _mm_set_pd(0.0, -0.0);
+	__m128d re, im;
+
+	re = _mm_mul_pd(x, fr);
+	im = _mm_mul_pd(_mm_shuffle_pd(x, x, 1), fi);
+
+	return _mm_add_pd(re, _mm_xor_pd(im, sign));
+}
+
+__attribute__ ((target("sse2")))
+static void mix_sse2(complex *p, complex w,
+		     const complex *in, complex *out, gint len)
+{
+	__m128d wr = _mm_set1_pd(c_re(w));
+	__m128d wi = _mm_set1_pd(c_im(w));
+	__m128d z[NCO_LANES], x;
+	gint i, k;
+
+	for (k = 0; k < NCO_LANES; k++)
+		z[k] = _mm_loadu_pd((double *) (p + k));
+
+	for (i = 0; i < len; i += NCO_LANES) {
+		for (k = 0; k < NCO_LANES; k++) {
+			x = _mm_loadu_pd((const double *) (in + i + k));
+			x = cmul_sse2(x, _mm_unpacklo_pd(z[k], z[k]),
+				      _mm_unpackhi_pd(z[k], z[k]));
+			_mm_storeu_pd((double *) (out + i + k), x);
+
+			z[k] = cmul_sse2(z[k], wr, wi);
+		}
+	}
+
+	for (k = 0; k < NCO_LANES; k++)
+		_mm_storeu_pd((double *) (p + k), z[k]);
+}
+
+__attribute__ ((target("sse2")))
+static void mix_real_sse2(complex *p, complex w,
+			  const gfloat *in, complex *out, gint len)
+{
+	__m128d wr = _mm_set1_pd(c_re(w));
+	__m128d wi = _mm_set1_pd(c_im(w));
+	__m128d z[NCO_LANES], x;
+	gint i, k;
+
+	for (k = 0; k < NCO_LANES; k++)
+		z[k] = _mm_loadu_pd((double *) (p + k));
+
+	for (i = 0; i < len; i += NCO_LANES) {
+		for (k = 0; k < NCO_LANES; k++) {
+			x = _mm_mul_pd(_mm_set1_pd(in[i + k]), z[k]);
+			_mm_storeu_pd((double *) (out + i + k), x);
+
+			z[k] = cmul_sse2(z[k], wr, wi);
+		}
+	}
+
+	for (k = 0; k < NCO_LANES; k++)
+		_mm_storeu_pd((double *) (p + k), z[k]);
+}
+
+/* Two complex numbers per register, see mul_avx() in fftfilt.c */
+__attribute__ ((target("avx")))
+static inline __m256d cmul_avx(__m256d x, __m256d f)
+{
+	__m256d re, im;
+
+	re = _mm256_mul_pd(x, _mm256_movedup_pd(f));
+	im = _mm256_mul_pd(_mm256_permute_pd(x, 5), _mm256_permute_pd(f, 15));
+
+	return _mm256_addsub_pd(re, im);
+}
+
+__attribute__ ((target("avx")))
+static void mix_avx(complex *p, complex w,
+		    const complex *in, complex *out, gint len)
+{
+	__m256d ww, z0, z1, x0, x1;
+	gint i;
+
+	ww = _mm256_setr_pd(c_re(w), c_im(w), c_re(w), c_im(w));
+	z0 = _mm256_loadu_pd((double *) (p + 0));
+	z1 = _mm256_loadu_pd((double *) (p + 2));
+
+	for (i = 0; i < len; i += NCO_LANES) {
+		x0 = _mm256_loadu_pd((const double *) (in + i + 0));
+		x1 = _mm256_loadu_pd((const double *) (in + i + 2));
+
+		_mm256_storeu_pd((double *) (out + i + 0), cmul_avx(x0, z0));
+		_mm256_storeu_pd((double *) (out + i + 2), cmul_avx(x1, z1));
+
+		z0 = cmul_avx(z0, ww);
+		z1 = cmul_avx(z1, ww);
+	}
+
+	_mm256_storeu_pd((double *) (p + 0), z0);
+	_mm256_storeu_pd((double *) (p + 2), z1);
+}
+
+__attribute__ ((target("avx")))
+static inline __m256d dup_avx(const gfloat *in)
+{
+	__m128d x = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd((const double *) in)));
+
+	return _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_unpacklo_pd(x, x)),
+				    _mm_unpackhi_pd(x, x), 1);
+}
+
+__attribute__ ((target("avx")))
+static void mix_real_avx(complex *p, complex w,
+			 const gfloat *in, complex *out, gint len)
+{
+	__m256d ww, z0, z1;
+	gint i;
+
+	ww = _mm256_setr_pd(c_re(w), c_im(w), c_re(w), c_im(w));
+	z0 = _mm256_loadu_pd((double *) (p + 0));
+	z1 = _mm256_loadu_pd((double *) (p + 2));
+
+	for (i = 0; i < len; i += NCO_LANES) {
+		_mm256_storeu_pd((double *) (out + i + 0),
+				 _mm256_mul_pd(dup_avx(in + i + 0), z0));
+		_mm256_storeu_pd((double *) (out + i + 2),
+				 _mm256_mul_pd(dup_avx(in + i + 2), z1));
+
+		z0 = cmul_avx(z0, ww);
+		z1 = cmul_avx(z1, ww);
+	}
+
+	_mm256_storeu_pd((double *) (p + 0), z0);
+	_mm256_storeu_pd((double *) (p + 2), z1);
+}
+
+#endif				/* HAVE_X86_SIMD */
+
+static mix_func nco_mix_lanes = mix_generic;
+static mix_real_func nco_mix_real_lanes = mix_real_generic;
+
+static pthread_once_t mix_once = PTHREAD_ONCE_INIT;
+
+/*
+ * Pick the mixers once, the channel bank can start NCOs on several
+ * threads at the same time.
+ */
+static void mix_init(void)
+{
+#ifdef HAVE_X86_SIMD
+	if (cpu_features() & CPU_AVX) {
+		nco_mix_lanes = mix_avx;
+		nco_mix_real_lanes = mix_real_avx;
+	} else if (cpu_features() & CPU_SSE2) {
+		nco_mix_lanes = mix_sse2;
+		nco_mix_real_lanes = mix_real_sse2;
+	}
+#endif
+}
+
+/* ---------------------------------------------------------------------- */
+
+static void setfreq(struct nco *s, gdouble freq)
+{
+	gint k;
+
+	s->freq = freq;
+
+	for (k = 0; k < NCO_LANES; k++) {
+		c_re(s->step[k]) = cos(2.0 * M_PI * freq * k);
+		c_im(s->step[k]) = sin(2.0 * M_PI * freq * k);
+	}
+
+	c_re(s->lanestep) = cos(2.0 * M_PI * freq * NCO_LANES);
+	c_im(s->lanestep) = sin(2.0 * M_PI * freq * NCO_LANES);
+}
+
+void nco_init(struct nco *s, gdouble freq)
+{
+	pthread_once(&mix_once, mix_init);
+
+	c_re(s->phasor) = 1.0;
+	c_im(s->phasor) = 0.0;
+
+	setfreq(s, freq);
+}
+
+void nco_set_freq(struct nco *s, gdouble freq)
+{
+	if (freq != s->freq)
+		setfreq(s, freq);
+}
+
+/*
+ * Renormalize the phasor and spread it over the lanes.
+ */
+static void nco_start(struct nco *s, complex *p)
+{
+	gdouble m;
+	gint k;
+
+	m = 1.0 / cmod(s->phasor);
+
+	c_re(s->phasor) *= m;
+	c_im(s->phasor) *= m;
+
+	for (k = 0; k < NCO_LANES; k++)
+		p[k] = cmul(s->phasor, s->step[k]);
+}
+
+void nco_mix(struct nco *s, const complex *in, complex *out, gint len)
+{
+	complex p[NCO_LANES];
+	gint i, n;
+
+	nco_start(s, p);
+
+	n = len - len % NCO_LANES;
+
+	nco_mix_lanes(p, s->lanestep, in, out, n);
+
+	s->phasor = p[0];
+
+	for (i = n; i < len; i++) {
+		out[i] = cmul(in[i], s->phasor);
+		s->phasor = cmul(s->phasor, s->step[1]);
+	}
+}
+
+void nco_mix_real(struct nco *s, const gfloat *in, complex *out, gint len)
+{
+	complex p[NCO_LANES];
+	gint i, n;
+
+	nco_start(s, p);
+
+	n = len - len % NCO_LANES;
+
+	nco_mix_real_lanes(p, s->lanestep, in, out, n);
+
+	s->phasor = p[0];
+
+	for (i = n; i < len; i++) {
+		c_re(out[i]) = in[i] * c_re(s->phasor);
+		c_im(out[i]) = in[i] * c_im(s->phasor);
+		s->phasor = cmul(s->phasor, s->step[1]);
+	}
+}
+
+/* ---------------------------------------------------------------------- */
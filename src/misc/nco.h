@@ -0,0 +1,61 @@
+/*
+ *    nco.h  --  Numerically controlled oscillator and mixer
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _NCO_H
+#define _NCO_H
+
+#include <glib.h>
+
+#include "cmplx.h"
+
+/* ---------------------------------------------------------------------- */
+
+#define	NCO_LANES	4
+
+/*
+ * A complex oscillator run as a recursive phasor: every sample the
+ * phasor is rotated by a complex multiply instead of evaluating cos()
+ * and sin() of a phase accumulator. NCO_LANES phasors, one sample
+ * apart, are stepped NCO_LANES samples at a time so that a block can
+ * be mixed with SIMD. The phasor is scaled back to unit length at the
+ * start of every block to stop the amplitude from drifting.
+ *
+ * The frequency is normalized to the sample rate and may be negative.
+ */
+struct nco {
+	gdouble freq;
+	complex phasor;
+	complex step[NCO_LANES];	/* w^0 ... w^(NCO_LANES - 1) */
+	complex lanestep;		/* w^NCO_LANES */
+};
+
+extern void nco_init(struct nco *s, gdouble freq);
+extern void nco_set_freq(struct nco *s, gdouble freq);
+
+/* out[i] = in[i] * exp(j * phase), phase advancing by 2 * pi * freq */
+extern void nco_mix(struct nco *s, const complex *in, complex *out, gint len);
+extern void nco_mix_real(struct nco *s, const gfloat *in, complex *out, gint len);
+
+/* ---------------------------------------------------------------------- */
+#endif				/* _NCO_H */
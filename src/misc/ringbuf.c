@@ -0,0 +1,195 @@
+/*
+ *    ringbuf.c  --  Single producer / single consumer ring buffer
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <string.h>
+
+#include "ringbuf.h"
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Create a ring buffer of at least 'size' elements of 'elemsize'
+ * bytes each. The size is rounded up to a power of two.
+ */
+struct ringbuf *ringbuf_new(guint elemsize, guint size)
+{
+	struct ringbuf *rb;
+	guint n;
+
+	for (n = 1; n < size; n <<= 1)
+		;
+
+	rb = g_new0(struct ringbuf, 1);
+
+	rb->data = g_malloc0(n * elemsize);
+	rb->elemsize = elemsize;
+	rb->size = n;
+	rb->mask = n - 1;
+
+	return rb;
+}
+
+void ringbuf_free(struct ringbuf *rb)
+{
+	if (rb) {
+		g_free(rb->data);
+		g_free(rb);
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+
+guint ringbuf_read_space(struct ringbuf *rb)
+{
+	return (guint) g_atomic_int_get(&rb->head) - (guint) rb->tail;
+}
+
+guint ringbuf_write_space(struct ringbuf *rb)
+{
+	return rb->size - ((guint) rb->head - (guint) g_atomic_int_get(&rb->tail));
+}
+
+/*
+ * Return a pointer to the contiguous free space of the buffer and
+ * its length in elements in 'len'. The span may be shorter than the
+ * total free space when it wraps around the end of the buffer.
+ * Writer side only.
+ */
+gpointer ringbuf_write_span(struct ringbuf *rb, guint *len)
+{
+	guint head, space;
+
+	head = (guint) rb->head & rb->mask;
+	space = ringbuf_write_space(rb);
+
+	*len = MIN(space, rb->size - head);
+
+	return rb->data + head * rb->elemsize;
+}
+
+/*
+ * Publish 'len' elements written into the span to the reader.
+ */
+void ringbuf_write_commit(struct ringbuf *rb, guint len)
+{
+	g_atomic_int_add(&rb->head, len);
+}
+
+/*
+ * Return a pointer to the contiguous readable data and its length
+ * in elements in 'len'. Reader side only.
+ */
+gpointer ringbuf_read_span(struct ringbuf *rb, guint *len)
+{
+	guint tail, avail;
+
+	tail = (guint) rb->tail & rb->mask;
+	avail = ringbuf_read_space(rb);
+
+	*len = MIN(avail, rb->size - tail);
+
+	return rb->data + tail * rb->elemsize;
+}
+
+/*
+ * Release 'len' elements back to the writer.
+ */
+void ringbuf_read_commit(struct ringbuf *rb, guint len)
+{
+	g_atomic_int_add(&rb->tail, len);
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Copy up to 'len' elements into the buffer. Whatever does not fit
+ * is dropped and counted as an overrun. Returns the number of
+ * elements written.
+ */
+guint ringbuf_write(struct ringbuf *rb, gconstpointer buf, guint len)
+{
+	const guchar *src = buf;
+	guint n, done = 0;
+	gpointer dst;
+
+	while (done < len) {
+		dst = ringbuf_write_span(rb, &n);
+
+		if (n == 0)
+			break;
+
+		n = MIN(n, len - done);
+		memcpy(dst, src, n * rb->elemsize);
+		src += n * rb->elemsize;
+
+		ringbuf_write_commit(rb, n);
+		done += n;
+	}
+
+	if (done < len)
+		g_atomic_int_add(&rb->overruns, len - done);
+
+	return done;
+}
+
+/*
+ * Copy up to 'len' elements out of the buffer. Returns the number
+ * of elements read.
+ */
+guint ringbuf_read(struct ringbuf *rb, gpointer buf, guint len)
+{
+	guchar *dst = buf;
+	guint n, done = 0;
+	gpointer src;
+
+	while (done < len) {
+		src = ringbuf_read_span(rb, &n);
+
+		if (n == 0)
+			break;
+
+		n = MIN(n, len - done);
+		memcpy(dst, src, n * rb->elemsize);
+		dst += n * rb->elemsize;
+
+		ringbuf_read_commit(rb, n);
+		done += n;
+	}
+
+	return done;
+}
+
+/*
+ * Throw away everything in the buffer. Reader side only.
+ */
+void ringbuf_reset(struct ringbuf *rb)
+{
+	ringbuf_read_commit(rb, ringbuf_read_space(rb));
+}
+
+/* ---------------------------------------------------------------------- */
@@ -0,0 +1,62 @@
+/*
+ *    ringbuf.h  --  Single producer / single consumer ring buffer
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _RINGBUF_H
+#define _RINGBUF_H
+
+#include <glib.h>
+
+/*
+ * A lock free ring buffer for exactly one writer thread and one
+ * reader thread. The head and tail are free running element counters,
+ * only ever advanced by the writer and the reader respectively.
+ */
+struct ringbuf {
+	guchar *data;
+	guint elemsize;
+	guint size;
+	guint mask;
+	volatile gint head;
+	volatile gint tail;
+	volatile gint overruns;
+};
+
+extern struct ringbuf *ringbuf_new(guint elemsize, guint size);
+extern void ringbuf_free(struct ringbuf *rb);
+
+extern guint ringbuf_read_space(struct ringbuf *rb);
+extern guint ringbuf_write_space(struct ringbuf *rb);
+
+extern gpointer ringbuf_write_span(struct ringbuf *rb, guint *len);
+extern void ringbuf_write_commit(struct ringbuf *rb, guint len);
+
+extern gpointer ringbuf_read_span(struct ringbuf *rb, guint *len);
+extern void ringbuf_read_commit(struct ringbuf *rb, guint len);
+
+extern guint ringbuf_write(struct ringbuf *rb, gconstpointer buf, guint len);
+extern guint ringbuf_read(struct ringbuf *rb, gpointer buf, guint len);
+
+extern void ringbuf_reset(struct ringbuf *rb);
+
+#endif
@@ -23,36 +23,234 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <pthread.h>
 
 #include "sfft.h"
+#include "tables.h"
+#include "firdesign.h"
+#include "mirror.h"
 #include "misc.h"
+#include "cpu.h"
 
-#define	STABCOEFF	0.9999
+#ifdef HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * The sample falling out of the window, with the stability correction
+ * applied.
+ */
+static inline complex aged(struct sfft *s, complex old)
+{
+	c_re(old) *= s->corr;
+	c_im(old) *= s->corr;
+
+	return old;
+}
+
+/*
+ * The bin updates. Each bin is
+ *
+ *	bin = (bin - old + new) * twiddle
+ *
+ * and if 'mag' is not NULL the magnitudes of the bins from 'first'
+ * up to 'last' are stored there. The block functions get the samples
+ * leaving the window in 'hist', one for each input sample. All
+ * versions do exactly the same double precision operations in the
+ * same order, so they give identical results.
+ */
+static inline void update_generic(struct sfft *s, gint i, complex old,
+				  complex new, gfloat *mag)
+{
+	gdouble zr, zi;
+
+	for (; i < s->last; i++) {
+		zr = s->binr[i] - c_re(old) + c_re(new);
+		zi = s->bini[i] - c_im(old) + c_im(new);
+
+		s->binr[i] = zr * s->twr[i] - zi * s->twi[i];
+		s->bini[i] = zr * s->twi[i] + zi * s->twr[i];
+
+		if (mag)
+			mag[i - s->first] = sqrt(s->binr[i] * s->binr[i] +
+						 s->bini[i] * s->bini[i]);
+	}
+}
+
+static void block_generic(struct sfft *s, const complex *in,
+			  const complex *hist, gint n, gfloat *mag, gint stride)
+{
+	complex old;
+	gint k;
+
+	for (k = 0; k < n; k++) {
+		old = aged(s, hist[k]);
+		update_generic(s, s->first, old, in[k], mag);
+
+		if (mag)
+			mag += stride;
+	}
+}
+
+#ifdef HAVE_X86_SIMD
+
+__attribute__ ((target("sse2")))
+static void block_sse2(struct sfft *s, const complex *in,
+		       const complex *hist, gint n, gfloat *mag, gint stride)
+{
+	__m128d oldr, oldi, newr, newi, zr, zi, tr, ti, br, bi;
+	complex old;
+	gint i, k;
+
+	for (k = 0; k < n; k++) {
+		old = aged(s, hist[k]);
+
+		oldr = _mm_set1_pd(c_re(old));
+		oldi = _mm_set1_pd(c_im(old));
+		newr = _mm_set1_pd(c_re(in[k]));
+		newi = _mm_set1_pd(c_im(in[k]));
+
+		for (i = s->first; i + 2 <= s->last; i += 2) {
+			zr = _mm_add_pd(_mm_sub_pd(_mm_loadu_pd(s->binr + i), oldr), newr);
+			zi = _mm_add_pd(_mm_sub_pd(_mm_loadu_pd(s->bini + i), oldi), newi);
+
+			tr = _mm_loadu_pd(s->twr + i);
+			ti = _mm_loadu_pd(s->twi + i);
+
+			br = _mm_sub_pd(_mm_mul_pd(zr, tr), _mm_mul_pd(zi, ti));
+			bi = _mm_add_pd(_mm_mul_pd(zr, ti), _mm_mul_pd(zi, tr));
+
+			_mm_storeu_pd(s->binr + i, br);
+			_mm_storeu_pd(s->bini + i, bi);
+
+			if (mag) {
+				br = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(br, br),
+							    _mm_mul_pd(bi, bi)));
+				_mm_storel_pi((__m64 *) (mag + i - s->first),
+					      _mm_cvtpd_ps(br));
+			}
+		}
+
+		update_generic(s, i, old, in[k], mag);
+
+		if (mag)
+			mag += stride;
+	}
+}
+
+__attribute__ ((target("avx")))
+static void block_avx(struct sfft *s, const complex *in,
+		      const complex *hist, gint n, gfloat *mag, gint stride)
+{
+	__m256d oldr, oldi, newr, newi, zr, zi, tr, ti, br, bi;
+	complex old;
+	gint i, k;
+
+	for (k = 0; k < n; k++) {
+		old = aged(s, hist[k]);
+
+		oldr = _mm256_set1_pd(c_re(old));
+		oldi = _mm256_set1_pd(c_im(old));
+		newr = _mm256_set1_pd(c_re(in[k]));
+		newi = _mm256_set1_pd(c_im(in[k]));
+
+		for (i = s->first; i + 4 <= s->last; i += 4) {
+			zr = _mm256_add_pd(_mm256_sub_pd(_mm256_loadu_pd(s->binr + i), oldr), newr);
+			zi = _mm256_add_pd(_mm256_sub_pd(_mm256_loadu_pd(s->bini + i), oldi), newi);
+
+			tr = _mm256_loadu_pd(s->twr + i);
+			ti = _mm256_loadu_pd(s->twi + i);
+
+			br = _mm256_sub_pd(_mm256_mul_pd(zr, tr), _mm256_mul_pd(zi, ti));
+			bi = _mm256_add_pd(_mm256_mul_pd(zr, ti), _mm256_mul_pd(zi, tr));
+
+			_mm256_storeu_pd(s->binr + i, br);
+			_mm256_storeu_pd(s->bini + i, bi);
+
+			if (mag) {
+				br = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(br, br),
+								  _mm256_mul_pd(bi, bi)));
+				_mm_storeu_ps(mag + i - s->first, _mm256_cvtpd_ps(br));
+			}
+		}
+
+		update_generic(s, i, old, in[k], mag);
+
+		if (mag)
+			mag += stride;
+	}
+}
+
+#endif				/* HAVE_X86_SIMD */
+
+static void (*sfft_block) (struct sfft *, const complex *, const complex *,
+			   gint, gfloat *, gint) = block_generic;
+
+static pthread_once_t block_once = PTHREAD_ONCE_INIT;
+
+/*
+ * Pick the block update once, the channel bank can build sliding FFTs
+ * on several threads at the same time.
+ */
+static void block_init(void)
+{
+#ifdef HAVE_X86_SIMD
+	if (cpu_features() & CPU_AVX)
+		sfft_block = block_avx;
+	else if (cpu_features() & CPU_SSE2)
+		sfft_block = block_sse2;
+#endif
+}
 
 /* ---------------------------------------------------------------------- */
 
 struct sfft *sfft_init(gint len, gint first, gint last)
 {
+	const struct twiddle_table *t;
 	struct sfft *s;
 	gint i;
 
+	pthread_once(&block_once, block_init);
+
 	s = g_new0(struct sfft, 1);
 
-	s->twiddles = g_new0(complex, len);
-	s->history  = g_new0(complex, len);
-	s->bins     = g_new0(complex, len);
+	s->binr = g_new0(gdouble, len);
+	s->bini = g_new0(gdouble, len);
+	s->bins = g_new0(complex, len);
+	s->mirror = mirror_new(2 * len * sizeof(complex));
+	s->history = (complex *) s->mirror->data;
+	s->mask = s->mirror->size / sizeof(complex) - 1;
 
 	s->fftlen = len;
 	s->first = first;
 	s->last = last;
 
-	for (i = 0; i < len; i++) {
-		c_re(s->twiddles[i]) = cos(i * 2.0 * M_PI / len) * STABCOEFF;
-		c_im(s->twiddles[i]) = sin(i * 2.0 * M_PI / len) * STABCOEFF;
+	/* the MFSK lengths come ready made */
+	for (t = twiddle_tables; t->len; t++) {
+		if (t->len == len) {
+			s->twr = t->re;
+			s->twi = t->im;
+			break;
+		}
 	}
 
-	s->corr = pow(STABCOEFF, len);
+	if (t->len == 0) {
+		s->twbuf = g_new(gdouble, 2 * len);
+
+		for (i = 0; i < len; i++) {
+			s->twbuf[i] = cos(i * 2.0 * M_PI / len) * SFFT_STABCOEFF;
+			s->twbuf[len + i] = sin(i * 2.0 * M_PI / len) * SFFT_STABCOEFF;
+		}
+
+		s->twr = s->twbuf;
+		s->twi = s->twbuf + len;
+	}
+
+	s->corr = pow(SFFT_STABCOEFF, len);
 
 	return s;
 }
@@ -60,9 +258,11 @@ struct sfft *sfft_init(gint len, gint first, gint last)
 void sfft_free(struct sfft *s)
 {
 	if (s) {
-		g_free(s->twiddles);
-		g_free(s->history);
+		g_free(s->twbuf);
+		g_free(s->binr);
+		g_free(s->bini);
 		g_free(s->bins);
+		mirror_free(s->mirror);
 		g_free(s);
 	}
 }
@@ -72,26 +272,56 @@ void sfft_free(struct sfft *s)
  */
 complex *sfft_run(struct sfft *s, complex new)
 {
-	complex old, z;
-	gint i;
+	sfft_run_block(s, &new, 1, NULL, 0);
 
-	/* restore the sample fftlen samples back */
-	old = s->history[s->ptr];
-	c_re(old) *= s->corr;
-	c_im(old) *= s->corr;
+	return sfft_get_bins(s);
+}
+
+/*
+ * Run a block of 'n' samples. If 'mag' is not NULL the magnitudes of
+ * the wanted bins after each sample are stored in it, one row of
+ * 'last - first' values per sample, 'stride' floats apart.
+ */
+void sfft_run_block(struct sfft *s, const complex *in, gint n,
+		    gfloat *mag, gint stride)
+{
+	gint chunk;
+
+	/*
+	 * The new samples go in the history ring first. The ones falling
+	 * out of the window, 'fftlen' samples back, are then a contiguous
+	 * run in the mirrored memory, part of it possibly the new ones.
+	 */
+	while (n > 0) {
+		chunk = MIN(n, s->mask + 1 - s->fftlen);
 
-	/* save the new sample */
-	s->history[s->ptr] = new;
+		memcpy(s->history + s->ptr, in, chunk * sizeof(complex));
+		mirror_sync(s->mirror, s->ptr * sizeof(complex),
+			    chunk * sizeof(complex));
 
-	/* advance the history pointer */
-	s->ptr = (s->ptr + 1) % s->fftlen;
+		sfft_block(s, in, s->history + ((s->ptr - s->fftlen) & s->mask),
+			   chunk, mag, stride);
+
+		s->ptr = (s->ptr + chunk) & s->mask;
+
+		in += chunk;
+		n -= chunk;
+
+		if (mag)
+			mag += chunk * stride;
+	}
+}
+
+/*
+ * The current bins in complex form, valid from 'first' to 'last'.
+ */
+complex *sfft_get_bins(struct sfft *s)
+{
+	gint i;
 
-	/* calculate the wanted bins */
 	for (i = s->first; i < s->last; i++) {
-		z = s->bins[i];
-		z = csub(z, old);
-		z = cadd(z, new);
-		s->bins[i] = cmul(z, s->twiddles[i]);
+		c_re(s->bins[i]) = s->binr[i];
+		c_im(s->bins[i]) = s->bini[i];
 	}
 
 	return s->bins;
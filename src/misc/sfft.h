@@ -29,14 +29,22 @@
 
 #include "cmplx.h"
 
+/*
+ * The bins are kept as separate real and imaginary arrays so that
+ * several of them can be updated at once with SIMD instructions.
+ */
 struct sfft {
 	gint fftlen;
 	gint first;
 	gint last;
 	gint ptr;
-	complex *twiddles;
+	const gdouble *twr, *twi;
+	gdouble *twbuf;
+	gdouble *binr, *bini;
 	complex *bins;
+	struct mirror *mirror;
 	complex *history;
+	gint mask;
 	gdouble corr;
 };
 
@@ -45,4 +53,7 @@ extern void sfft_free(struct sfft *);
 
 extern complex *sfft_run(struct sfft *, complex);
 
+extern void sfft_run_block(struct sfft *, const complex *, gint, gfloat *, gint);
+extern complex *sfft_get_bins(struct sfft *);
+
 #endif
@@ -0,0 +1,60 @@
+/*
+ *    tables.h  --  Tables generated at build time
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _TABLES_H
+#define _TABLES_H
+
+#include <glib.h>
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * The tables in tables.c are written by the gentables program when
+ * gMFSK is built, so the fixed filters and twiddles need no sin() or
+ * cos() at run time and their data is shared between processes.
+ * Each list ends with an entry of zero length.
+ */
+
+/* filter.c design with these arguments */
+struct fir_table {
+	gint len;
+	gint hilbert;
+	gfloat f1;
+	gfloat f2;
+	const gfloat *taps;
+};
+
+/* sliding FFT twiddles for a length */
+struct twiddle_table {
+	gint len;
+	const gdouble *re;
+	const gdouble *im;
+};
+
+extern const struct fir_table fir_tables[];
+extern const struct twiddle_table twiddle_tables[];
+
+/* ---------------------------------------------------------------------- */
+
+#endif				/* _TABLES_H */
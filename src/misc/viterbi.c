@@ -24,17 +24,229 @@
 
 #include <stdlib.h>
 #include <string.h>
-#include <limits.h>
 
 #include "viterbi.h"
 #include "misc.h"
+#include "cpu.h"
+
+#ifdef HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Add-compare-select for one step. The new states 2j and 2j+1 both
+ * come from the previous states j and j + nstates/2 so the step is
+ * done as nstates/2 butterflies. met[] holds mettab[0][sym[0]],
+ * mettab[1][sym[0]], mettab[0][sym[1]] and mettab[1][sym[1]], the
+ * branch metric of output o is the sum of the ones picked by its
+ * two bits. The kernels give identical results.
+ */
+
+#define	HISTWORDS(v)	(((v)->nstates + 31) / 32)
+
+/* bmsel[] has a 0/-1 mask per butterfly for each output bit ... */
+#define	SEL(v, tr, bit)	((v)->bmsel + (2 * (tr) + (bit)) * ((v)->nstates / 2))
+
+/* ... of the four transitions, j -> 2j, j + nstates/2 -> 2j, etc */
+static inline gint transition(struct viterbi *v, gint j, gint tr)
+{
+	return 2 * j + (tr >> 1) + ((tr & 1) ? v->nstates : 0);
+}
+
+static inline gint sat16(gint x)
+{
+	return CLAMP(x, -32768, 32767);
+}
+
+static inline gint branchmetric(const gint *met, gint out)
+{
+	return met[2 + ((out >> 1) & 1)] + met[out & 1];
+}
+
+static void acs_generic(struct viterbi *v, const gint16 *prev, gint16 *curr,
+			guint32 *dec, const gint *met)
+{
+	gint half = v->nstates / 2;
+	gint j, k, n, lo, hi, m0, m1;
+
+	for (j = 0; j < half; j++) {
+		lo = sat16(prev[j] - prev[0]);
+		hi = sat16(prev[j + half] - prev[0]);
+
+		for (k = 0; k < 2; k++) {
+			n = 2 * j + k;
+
+			m0 = sat16(lo + branchmetric(met, v->output[transition(v, j, 2 * k)]));
+			m1 = sat16(hi + branchmetric(met, v->output[transition(v, j, 2 * k + 1)]));
+
+			if (m0 > m1) {
+				curr[n] = m0;
+			} else {
+				curr[n] = m1;
+				dec[n >> 5] |= 1U << (n & 31);
+			}
+		}
+	}
+}
+
+#ifdef HAVE_X86_SIMD
+
+#define	BM_SSE2(tr) \
+	_mm_add_epi16( \
+		_mm_xor_si128(a1, _mm_and_si128(x1, _mm_loadu_si128((__m128i *) (SEL(v, tr, 1) + j)))), \
+		_mm_xor_si128(a0, _mm_and_si128(x0, _mm_loadu_si128((__m128i *) (SEL(v, tr, 0) + j)))))
+
+__attribute__ ((target("sse2")))
+static void acs_sse2(struct viterbi *v, const gint16 *prev, gint16 *curr,
+		     guint32 *dec, const gint *met)
+{
+	gint half = v->nstates / 2;
+	__m128i base, a0, x0, a1, x1;
+	__m128i lo, hi, m0, m1, ev, od, dev, dod;
+	guint bits;
+	gint j;
+
+	base = _mm_set1_epi16(prev[0]);
+
+	a0 = _mm_set1_epi16(met[0]);
+	x0 = _mm_set1_epi16(met[0] ^ met[1]);
+	a1 = _mm_set1_epi16(met[2]);
+	x1 = _mm_set1_epi16(met[2] ^ met[3]);
+
+	for (j = 0; j < half; j += 8) {
+		lo = _mm_subs_epi16(_mm_loadu_si128((__m128i *) (prev + j)), base);
+		hi = _mm_subs_epi16(_mm_loadu_si128((__m128i *) (prev + half + j)), base);
+
+		m0 = _mm_adds_epi16(lo, BM_SSE2(0));
+		m1 = _mm_adds_epi16(hi, BM_SSE2(1));
+		ev = _mm_max_epi16(m0, m1);
+		dev = _mm_cmpgt_epi16(m0, m1);
+
+		m0 = _mm_adds_epi16(lo, BM_SSE2(2));
+		m1 = _mm_adds_epi16(hi, BM_SSE2(3));
+		od = _mm_max_epi16(m0, m1);
+		dod = _mm_cmpgt_epi16(m0, m1);
+
+		_mm_storeu_si128((__m128i *) (curr + 2 * j),
+				 _mm_unpacklo_epi16(ev, od));
+		_mm_storeu_si128((__m128i *) (curr + 2 * j + 8),
+				 _mm_unpackhi_epi16(ev, od));
+
+		bits = _mm_movemask_epi8(_mm_packs_epi16(_mm_unpacklo_epi16(dev, dod),
+							 _mm_unpackhi_epi16(dev, dod)));
+
+		dec[j >> 4] |= (~bits & 0xffff) << ((2 * j) & 31);
+	}
+}
+
+#define	BM_AVX2(tr) \
+	_mm256_add_epi16( \
+		_mm256_xor_si256(a1, _mm256_and_si256(x1, _mm256_loadu_si256((__m256i *) (SEL(v, tr, 1) + j)))), \
+		_mm256_xor_si256(a0, _mm256_and_si256(x0, _mm256_loadu_si256((__m256i *) (SEL(v, tr, 0) + j)))))
+
+__attribute__ ((target("avx2")))
+static void acs_avx2(struct viterbi *v, const gint16 *prev, gint16 *curr,
+		     guint32 *dec, const gint *met)
+{
+	gint half = v->nstates / 2;
+	__m256i base, a0, x0, a1, x1;
+	__m256i lo, hi, m0, m1, ev, od, dev, dod, d0, d1;
+	gint j;
+
+	base = _mm256_set1_epi16(prev[0]);
+
+	a0 = _mm256_set1_epi16(met[0]);
+	x0 = _mm256_set1_epi16(met[0] ^ met[1]);
+	a1 = _mm256_set1_epi16(met[2]);
+	x1 = _mm256_set1_epi16(met[2] ^ met[3]);
+
+	for (j = 0; j < half; j += 16) {
+		lo = _mm256_subs_epi16(_mm256_loadu_si256((__m256i *) (prev + j)), base);
+		hi = _mm256_subs_epi16(_mm256_loadu_si256((__m256i *) (prev + half + j)), base);
+
+		m0 = _mm256_adds_epi16(lo, BM_AVX2(0));
+		m1 = _mm256_adds_epi16(hi, BM_AVX2(1));
+		ev = _mm256_max_epi16(m0, m1);
+		dev = _mm256_cmpgt_epi16(m0, m1);
+
+		m0 = _mm256_adds_epi16(lo, BM_AVX2(2));
+		m1 = _mm256_adds_epi16(hi, BM_AVX2(3));
+		od = _mm256_max_epi16(m0, m1);
+		dod = _mm256_cmpgt_epi16(m0, m1);
+
+		/* the unpacks work within 128 bit lanes, put them in order */
+		m0 = _mm256_unpacklo_epi16(ev, od);
+		m1 = _mm256_unpackhi_epi16(ev, od);
+
+		_mm256_storeu_si256((__m256i *) (curr + 2 * j),
+				    _mm256_permute2x128_si256(m0, m1, 0x20));
+		_mm256_storeu_si256((__m256i *) (curr + 2 * j + 16),
+				    _mm256_permute2x128_si256(m0, m1, 0x31));
+
+		m0 = _mm256_unpacklo_epi16(dev, dod);
+		m1 = _mm256_unpackhi_epi16(dev, dod);
+
+		d0 = _mm256_permute2x128_si256(m0, m1, 0x20);
+		d1 = _mm256_permute2x128_si256(m0, m1, 0x31);
+
+		d0 = _mm256_permute4x64_epi64(_mm256_packs_epi16(d0, d1), 0xd8);
+
+		dec[j >> 4] = ~(guint32) _mm256_movemask_epi8(d0);
+	}
+}
+
+#endif				/* HAVE_X86_SIMD */
+
+/*
+ * Index of the first state with the best metric.
+ */
+static gint best_generic(const gint16 *metrics, gint nstates)
+{
+	gint i, best = 0;
+
+	for (i = 1; i < nstates; i++)
+		if (metrics[i] > metrics[best])
+			best = i;
+
+	return best;
+}
+
+#ifdef HAVE_X86_SIMD
+
+__attribute__ ((target("sse2")))
+static gint best_sse2(const gint16 *metrics, gint nstates)
+{
+	__m128i max, x;
+	guint mask;
+	gint i;
+
+	max = _mm_loadu_si128((__m128i *) metrics);
+
+	for (i = 8; i < nstates; i += 8)
+		max = _mm_max_epi16(max, _mm_loadu_si128((__m128i *) (metrics + i)));
+
+	max = _mm_max_epi16(max, _mm_shuffle_epi32(max, 0x4e));
+	max = _mm_max_epi16(max, _mm_shuffle_epi32(max, 0xb1));
+	max = _mm_max_epi16(max, _mm_shufflelo_epi16(_mm_shufflehi_epi16(max, 0xb1), 0xb1));
+
+	for (i = 0; ; i += 8) {
+		x = _mm_loadu_si128((__m128i *) (metrics + i));
+
+		if ((mask = _mm_movemask_epi8(_mm_cmpeq_epi16(x, max))) != 0)
+			return i + __builtin_ctz(mask) / 2;
+	}
+}
+
+#endif				/* HAVE_X86_SIMD */
 
 /* ---------------------------------------------------------------------- */
 
 struct viterbi *viterbi_init(gint k, gint poly1, gint poly2)
 {
 	struct viterbi *v;
-	gint i;
+	gint i, j, tr, half;
 
 	v = g_new0(struct viterbi, 1);
 
@@ -48,9 +260,26 @@ struct viterbi *viterbi_init(gint k, gint poly1, gint poly2)
 	for (i = 0; i < (1 << k); i++)
 		v->output[i] = parity(poly1 & i) | (parity(poly2 & i) << 1);
 
-	for (i = 0; i < PATHMEM; i++) {
-		v->metrics[i] = g_new0(int, v->nstates);
-		v->history[i] = g_new0(int, v->nstates);
+	/* the path memory is two blocks, not a row at a time */
+	v->metrics[0] = g_new0(gint16, PATHMEM * v->nstates);
+	v->history[0] = g_new0(guint32, PATHMEM * HISTWORDS(v));
+
+	for (i = 1; i < PATHMEM; i++) {
+		v->metrics[i] = v->metrics[0] + i * v->nstates;
+		v->history[i] = v->history[0] + i * HISTWORDS(v);
+	}
+
+	half = v->nstates / 2;
+
+	v->bmsel = g_new0(gint16, 4 * v->nstates);
+
+	for (tr = 0; tr < 4; tr++) {
+		for (j = 0; j < half; j++) {
+			i = v->output[transition(v, j, tr)];
+
+			SEL(v, tr, 0)[j] = (i & 1) ? -1 : 0;
+			SEL(v, tr, 1)[j] = (i & 2) ? -1 : 0;
+		}
 	}
 
 	for (i = 0; i < 256; i++) {
@@ -58,7 +287,21 @@ struct viterbi *viterbi_init(gint k, gint poly1, gint poly2)
 		v->mettab[1][i] = i - 128;
 	}
 
+	v->acs = acs_generic;
+	v->best = best_generic;
+#ifdef HAVE_X86_SIMD
+	if ((cpu_features() & CPU_AVX2) && half % 16 == 0)
+		v->acs = acs_avx2;
+	else if ((cpu_features() & CPU_SSE2) && half % 8 == 0)
+		v->acs = acs_sse2;
+
+	if ((cpu_features() & CPU_SSE2) && half % 8 == 0)
+		v->best = best_sse2;
+#endif
+
 	v->ptr = 0;
+	v->valid = 0;
+	v->fullrows = PATHMEM;
 
 	return v;
 }
@@ -69,6 +312,7 @@ gint viterbi_set_traceback(struct viterbi *v, gint traceback)
 		return -1;
 
 	v->traceback = traceback;
+	v->fullrows = PATHMEM;
 	return 0;
 }
 
@@ -78,43 +322,56 @@ gint viterbi_set_chunksize(struct viterbi *v, gint chunksize)
 		return -1;
 
 	v->chunksize = chunksize;
+	v->fullrows = PATHMEM;
 	return 0;
 }
 
 void viterbi_reset(struct viterbi *v)
 {
-	int i;
-
-	for (i = 0; i < PATHMEM; i++) {
-		memset(v->metrics[i], 0, v->nstates * sizeof(int));
-		memset(v->history[i], 0, v->nstates * sizeof(int));
-	}
+	memset(v->metrics[0], 0, PATHMEM * v->nstates * sizeof(gint16));
+	memset(v->history[0], 0, PATHMEM * HISTWORDS(v) * sizeof(guint32));
+	memset(v->norm, 0, sizeof(v->norm));
 
 	v->ptr = 0;
+	v->valid = 0;
+	v->fullrows = PATHMEM;
 }
 
 void viterbi_free(struct viterbi *v)
 {
-	int i;
-
 	if (v) {
 		g_free(v->output);
-
-		for (i = 0; i < v->nstates; i++) {
-			g_free(v->metrics[i]);
-			g_free(v->history[i]);
-		}
-
+		g_free(v->bmsel);
+		g_free(v->metrics[0]);
+		g_free(v->history[0]);
 		g_free(v);
 	}
 }
 
 static gint traceback(struct viterbi *v, gint *metric);
 
+/*
+ * Finish a step whose metrics and decisions are in row 'currptr'.
+ * Returns TRUE when a traceback is due.
+ */
+static gboolean advance(struct viterbi *v, guint currptr)
+{
+	guint prevptr = (currptr - 1) % PATHMEM;
+
+	v->norm[currptr] = v->norm[prevptr] + v->metrics[prevptr][0];
+
+	v->ptr = (v->ptr + 1) % PATHMEM;
+
+	if (v->valid < PATHMEM)
+		v->valid++;
+
+	return (v->ptr % v->chunksize) == 0;
+}
+
 gint viterbi_decode(struct viterbi *v, guchar *sym, gint *metric)
 {
 	guint currptr, prevptr;
-	gint i, j, met[4], n;
+	gint met[4];
 
 	currptr = v->ptr;
 	prevptr = (currptr - 1) % PATHMEM;
@@ -124,101 +381,518 @@ gint viterbi_decode(struct viterbi *v, guchar *sym, gint *metric)
 	sym[1] = (sym[1] < 128) ? 0 : 255;
 #endif
 
-	met[0] = v->mettab[0][sym[1]] + v->mettab[0][sym[0]];
-	met[1] = v->mettab[0][sym[1]] + v->mettab[1][sym[0]];
-	met[2] = v->mettab[1][sym[1]] + v->mettab[0][sym[0]];
-	met[3] = v->mettab[1][sym[1]] + v->mettab[1][sym[0]];
+	met[0] = v->mettab[0][sym[0]];
+	met[1] = v->mettab[1][sym[0]];
+	met[2] = v->mettab[0][sym[1]];
+	met[3] = v->mettab[1][sym[1]];
+
+	memset(v->history[currptr], 0, HISTWORDS(v) * sizeof(guint32));
+
+	v->acs(v, v->metrics[prevptr], v->metrics[currptr],
+	       v->history[currptr], met);
+
+	if (advance(v, currptr))
+		return traceback(v, metric);
+
+	return -1;
+}
+
+/*
+ * One traceback step from state 's' at row 'p'.
+ */
+#define	TRACE(v, p, s)	(((s) >> 1) | \
+			 (((v)->history[p][(s) >> 5] >> ((s) & 31)) & 1) * \
+			 ((v)->nstates / 2))
+
+/*
+ * Start a traceback at the newest row from the state with the best
+ * metric. Returns the number of steps to trace back, steps not run
+ * since the reset lead back to state 0.
+ */
+static gint traceback_start(struct viterbi *v, guint *p, gint *s)
+{
+	*p = (v->ptr - 1) % PATHMEM;
+	*s = v->best(v->metrics[*p], v->nstates);
+
+	v->sequence[*p] = *s;
+
+	return MIN(v->traceback, v->valid);
+}
+
+/*
+ * Finish a traceback that has run 'steps' steps to row 'p'.
+ */
+static gint traceback_end(struct viterbi *v, guint p, gint steps,
+			  gint *metric)
+{
+	guint c, first;
+	gint i;
+
+	for (i = steps; i < v->traceback; i++) {
+		p = (p - 1) % PATHMEM;
+		v->sequence[p] = 0;
+	}
+
+	first = p;
+
+	/*
+	 * Decode 'chunksize' bits
+	 */
+	for (c = i = 0; i < v->chunksize; i++) {
+		/*
+		 * low bit of state is the previous input bit
+		 */
+		c = (c << 1) | (v->sequence[p] & 1);
+		p = (p + 1) % PATHMEM;
+	}
+
+	if (metric) {
+		*metric = v->metrics[p][v->sequence[p]] -
+			  v->metrics[first][v->sequence[first]];
+		*metric += (gint) (v->norm[p] - v->norm[first]);
+	}
 
-	for (n = 0; n < v->nstates; n++) {
-		int p0, p1, s0, s1, m0, m1;
+	return c;
+}
 
-		s0 = n;
-		s1 = n + v->nstates;
+static gint traceback(struct viterbi *v, gint *metric)
+{
+	gint i, s, steps;
+	guint p;
 
-		p0 = s0 >> 1;
-		p1 = s1 >> 1;
+	steps = traceback_start(v, &p, &s);
 
-		m0 = v->metrics[prevptr][p0] + met[v->output[s0]];
-		m1 = v->metrics[prevptr][p1] + met[v->output[s1]];
+	for (i = 0; i < steps; i++) {
+		s = TRACE(v, p, s);
+		p = (p - 1) % PATHMEM;
+		v->sequence[p] = s;
+	}
+
+	return traceback_end(v, p, steps, metric);
+}
 
-		if (m0 > m1) {
-			v->metrics[currptr][n] = m0;
-			v->history[currptr][n] = p0;
-		} else {
-			v->metrics[currptr][n] = m1;
-			v->history[currptr][n] = p1;
+/* ---------------------------------------------------------------------- */
+
+#define	LANES		VITERBI_BANK_STREAMS
+
+/* decision words of 16 states for every lane */
+#define	DECROWS(b)	(((b)->nstates + 15) / 16)
+
+/*
+ * The bank kernels work on [state][lane] arrays: 'met' has the branch
+ * metric of each of the four outputs for every lane and 'mask' is -1
+ * for the lanes stepped, the others keep their metrics. The lanes
+ * are computed exactly as the single stream kernels do.
+ */
+static void bank_acs_generic(struct viterbi_bank *b, const gint16 *prev,
+			     gint16 *curr, guint16 *dec,
+			     const gint16 *met, const gint16 *mask)
+{
+	gint half = b->nstates / 2;
+	const gint16 *bm0, *bm1;
+	gint j, k, l, n, lo, hi, m0, m1;
+
+	memset(dec, 0, DECROWS(b) * LANES * sizeof(guint16));
+
+	for (j = 0; j < half; j++) {
+		for (k = 0; k < 2; k++) {
+			n = 2 * j + k;
+
+			bm0 = met + b->output[n] * LANES;
+			bm1 = met + b->output[n + b->nstates] * LANES;
+
+			for (l = 0; l < LANES; l++) {
+				if (!mask[l]) {
+					curr[n * LANES + l] = prev[n * LANES + l];
+					continue;
+				}
+
+				lo = sat16(prev[j * LANES + l] - prev[l]);
+				hi = sat16(prev[(j + half) * LANES + l] - prev[l]);
+
+				m0 = sat16(lo + bm0[l]);
+				m1 = sat16(hi + bm1[l]);
+
+				if (m0 > m1) {
+					curr[n * LANES + l] = m0;
+				} else {
+					curr[n * LANES + l] = m1;
+					dec[(n >> 4) * LANES + l] |= 1 << (n & 15);
+				}
+			}
 		}
 	}
+}
 
-	v->ptr = (v->ptr + 1) % PATHMEM;
+#ifdef HAVE_X86_SIMD
 
-	if ((v->ptr % v->chunksize) == 0)
-		return traceback(v, metric);
+#define	LOAD128(p)	_mm_loadu_si128((__m128i *) (p))
 
-	if (v->metrics[currptr][0] > INT_MAX / 2) {
-		for (i = 0; i < PATHMEM; i++)
-			for (j = 0; j < v->nstates; j++)
-				v->metrics[i][j] -= INT_MAX / 2;
+__attribute__ ((target("sse2")))
+static void bank_acs_sse2(struct viterbi_bank *b, const gint16 *prev,
+			  gint16 *curr, guint16 *dec,
+			  const gint16 *met, const gint16 *mask)
+{
+	const __m128i bit14 = _mm_set1_epi16(0x4000);
+	const __m128i bit15 = _mm_set1_epi16(0x8000);
+	gint half = b->nstates / 2;
+	gint *out = b->output;
+	__m128i base, act, lo, hi, m0, m1, ev, od, ce, co, acc;
+	gint h, j, n;
+
+	for (h = 0; h < LANES; h += 8) {
+		base = LOAD128(prev + h);
+		act = LOAD128(mask + h);
+		acc = _mm_setzero_si128();
+
+		for (j = 0; j < half; j++) {
+			n = 2 * j;
+
+			lo = _mm_subs_epi16(LOAD128(prev + j * LANES + h), base);
+			hi = _mm_subs_epi16(LOAD128(prev + (j + half) * LANES + h), base);
+
+			m0 = _mm_adds_epi16(lo, LOAD128(met + out[n] * LANES + h));
+			m1 = _mm_adds_epi16(hi, LOAD128(met + out[n + b->nstates] * LANES + h));
+			ev = _mm_max_epi16(m0, m1);
+			ce = _mm_cmpgt_epi16(m0, m1);
+
+			m0 = _mm_adds_epi16(lo, LOAD128(met + out[n + 1] * LANES + h));
+			m1 = _mm_adds_epi16(hi, LOAD128(met + out[n + 1 + b->nstates] * LANES + h));
+			od = _mm_max_epi16(m0, m1);
+			co = _mm_cmpgt_epi16(m0, m1);
+
+			ev = _mm_or_si128(_mm_and_si128(act, ev),
+					  _mm_andnot_si128(act, LOAD128(prev + n * LANES + h)));
+			od = _mm_or_si128(_mm_and_si128(act, od),
+					  _mm_andnot_si128(act, LOAD128(prev + (n + 1) * LANES + h)));
+
+			_mm_storeu_si128((__m128i *) (curr + n * LANES + h), ev);
+			_mm_storeu_si128((__m128i *) (curr + (n + 1) * LANES + h), od);
+
+			/* shift the decisions in, 16 states per word */
+			acc = _mm_or_si128(_mm_srli_epi16(acc, 2),
+					   _mm_or_si128(_mm_andnot_si128(ce, bit14),
+							_mm_andnot_si128(co, bit15)));
+
+			if ((j & 7) == 7)
+				_mm_storeu_si128((__m128i *) (dec + (j >> 3) * LANES + h), acc);
+		}
 	}
-	if (v->metrics[currptr][0] < INT_MIN / 2) {
-		for (i = 0; i < PATHMEM; i++)
-			for (j = 0; j < v->nstates; j++)
-				v->metrics[i][j] += INT_MIN / 2;
+}
+
+#define	LOAD256(p)	_mm256_loadu_si256((__m256i *) (p))
+
+__attribute__ ((target("avx2")))
+static void bank_acs_avx2(struct viterbi_bank *b, const gint16 *prev,
+			  gint16 *curr, guint16 *dec,
+			  const gint16 *met, const gint16 *mask)
+{
+	const __m256i bit14 = _mm256_set1_epi16(0x4000);
+	const __m256i bit15 = _mm256_set1_epi16(0x8000);
+	gint half = b->nstates / 2;
+	gint *out = b->output;
+	__m256i base, act, lo, hi, m0, m1, ev, od, ce, co, acc;
+	gint j, n;
+
+	base = LOAD256(prev);
+	act = LOAD256(mask);
+	acc = _mm256_setzero_si256();
+
+	for (j = 0; j < half; j++) {
+		n = 2 * j;
+
+		lo = _mm256_subs_epi16(LOAD256(prev + j * LANES), base);
+		hi = _mm256_subs_epi16(LOAD256(prev + (j + half) * LANES), base);
+
+		m0 = _mm256_adds_epi16(lo, LOAD256(met + out[n] * LANES));
+		m1 = _mm256_adds_epi16(hi, LOAD256(met + out[n + b->nstates] * LANES));
+		ev = _mm256_max_epi16(m0, m1);
+		ce = _mm256_cmpgt_epi16(m0, m1);
+
+		m0 = _mm256_adds_epi16(lo, LOAD256(met + out[n + 1] * LANES));
+		m1 = _mm256_adds_epi16(hi, LOAD256(met + out[n + 1 + b->nstates] * LANES));
+		od = _mm256_max_epi16(m0, m1);
+		co = _mm256_cmpgt_epi16(m0, m1);
+
+		ev = _mm256_blendv_epi8(LOAD256(prev + n * LANES), ev, act);
+		od = _mm256_blendv_epi8(LOAD256(prev + (n + 1) * LANES), od, act);
+
+		_mm256_storeu_si256((__m256i *) (curr + n * LANES), ev);
+		_mm256_storeu_si256((__m256i *) (curr + (n + 1) * LANES), od);
+
+		acc = _mm256_or_si256(_mm256_srli_epi16(acc, 2),
+				      _mm256_or_si256(_mm256_andnot_si256(ce, bit14),
+						      _mm256_andnot_si256(co, bit15)));
+
+		if ((j & 7) == 7)
+			_mm256_storeu_si256((__m256i *) (dec + (j >> 3) * LANES), acc);
 	}
+}
 
-	return -1;
+#endif				/* HAVE_X86_SIMD */
+
+/* ---------------------------------------------------------------------- */
+
+struct viterbi_bank *viterbi_bank_init(gint k, gint poly1, gint poly2)
+{
+	struct viterbi_bank *b;
+	gint i;
+
+	b = g_new0(struct viterbi_bank, 1);
+
+	b->nstates = 1 << (k - 1);
+
+	b->output = g_new0(int, 1 << k);
+
+	for (i = 0; i < (1 << k); i++)
+		b->output[i] = parity(poly1 & i) | (parity(poly2 & i) << 1);
+
+	b->metrics[0] = g_new0(gint16, b->nstates * LANES);
+	b->metrics[1] = g_new0(gint16, b->nstates * LANES);
+	b->curr = 0;
+
+	b->decisions = g_new0(guint16, DECROWS(b) * LANES);
+
+	b->acs = bank_acs_generic;
+#ifdef HAVE_X86_SIMD
+	if ((cpu_features() & CPU_AVX2) && (b->nstates / 2) % 8 == 0)
+		b->acs = bank_acs_avx2;
+	else if ((cpu_features() & CPU_SSE2) && (b->nstates / 2) % 8 == 0)
+		b->acs = bank_acs_sse2;
+#endif
+
+	return b;
 }
 
-static gint traceback(struct viterbi *v, gint *metric)
+/*
+ * The streams are not freed with the bank.
+ */
+void viterbi_bank_free(struct viterbi_bank *b)
 {
-	gint i, bestmetric, beststate;
-	guint p, c;
+	if (b) {
+		g_free(b->output);
+		g_free(b->metrics[0]);
+		g_free(b->metrics[1]);
+		g_free(b->decisions);
+		g_free(b);
+	}
+}
 
-	p = (v->ptr - 1) % PATHMEM;
+/*
+ * Copy the latest metrics of stream 'id' into the bank.
+ */
+static void bank_load(struct viterbi_bank *b, gint id)
+{
+	struct viterbi *v = b->stream[id];
+	gint16 *m = v->metrics[(v->ptr - 1) % PATHMEM];
+	gint n;
 
-	/*
-	 * Find the state with the best metric
-	 */
-	bestmetric = INT_MIN;
-	beststate = 0;
+	for (n = 0; n < b->nstates; n++)
+		b->metrics[b->curr][n * LANES + id] = m[n];
+}
+
+/*
+ * Add a decoder to the bank. It has to be for the same code and it
+ * carries on from where it is. Returns the stream id or -1 if the
+ * bank is full.
+ */
+gint viterbi_bank_add(struct viterbi_bank *b, struct viterbi *v)
+{
+	gint id;
 
-	for (i = 0; i < v->nstates; i++) {
-		if (v->metrics[p][i] > bestmetric) {
-			bestmetric = v->metrics[p][i];
-			beststate = i;
+	if (v->nstates != b->nstates ||
+	    memcmp(v->output, b->output, 2 * b->nstates * sizeof(gint)) != 0) {
+		g_warning("viterbi_bank_add: code mismatch\n");
+		return -1;
+	}
+
+	for (id = 0; id < LANES; id++)
+		if (b->stream[id] == NULL)
+			break;
+
+	if (id == LANES)
+		return -1;
+
+	b->stream[id] = v;
+
+	bank_load(b, id);
+
+	return id;
+}
+
+/*
+ * Take a stream out of the bank. Its latest metrics are written back
+ * so it can carry on with viterbi_decode().
+ */
+void viterbi_bank_remove(struct viterbi_bank *b, gint id)
+{
+	struct viterbi *v;
+	gint16 *m;
+	gint n;
+
+	if (id < 0 || id >= LANES || b->stream[id] == NULL)
+		return;
+
+	v = b->stream[id];
+	m = v->metrics[(v->ptr - 1) % PATHMEM];
+
+	for (n = 0; n < b->nstates; n++)
+		m[n] = b->metrics[b->curr][n * LANES + id];
+
+	b->stream[id] = NULL;
+}
+
+void viterbi_bank_reset(struct viterbi_bank *b, gint id)
+{
+	if (id >= 0 && id < LANES && b->stream[id]) {
+		viterbi_reset(b->stream[id]);
+		bank_load(b, id);
+	}
+}
+
+/*
+ * Only state 0 of a row is needed for the norm. The whole row is
+ * needed where a traceback starts and at the two rows its metric is
+ * taken from, 'traceback' and 'traceback - chunksize' steps before
+ * that, whether or not this call asks for the metric. After a reset
+ * or a change of the traceback or chunk size all the rows are kept
+ * until the path memory has turned over once.
+ */
+static gboolean bank_fullrow(struct viterbi *v, guint row)
+{
+	guint t;
+
+	if (v->fullrows > 0) {
+		v->fullrows--;
+		return TRUE;
+	}
+
+	t = (row + 1) % PATHMEM;
+	if (t % v->chunksize == 0)
+		return TRUE;
+
+	t = (row + v->traceback + 1) % PATHMEM;
+	if (t % v->chunksize == 0)
+		return TRUE;
+
+	t = (row + v->traceback - v->chunksize + 1) % PATHMEM;
+	if (t % v->chunksize == 0)
+		return TRUE;
+
+	return FALSE;
+}
+
+/*
+ * Step the streams whose bit is set in 'mask' by one symbol pair,
+ * sym[id] for stream 'id'. out[id] and metric[id] (which may be NULL)
+ * get what viterbi_decode() would have returned for that stream.
+ */
+void viterbi_bank_decode(struct viterbi_bank *b, guint mask,
+			 guchar (*sym)[2], gint *out, gint *metric)
+{
+	gint16 met[4 * LANES], act[LANES];
+	gint16 *prev, *curr;
+	guint16 *dec = b->decisions;
+	struct viterbi *v;
+	guint currptr, p[LANES];
+	gint s[LANES], steps[LANES], due[LANES];
+	guint32 **hist[LANES];
+	gint *seq[LANES];
+	gint half = b->nstates / 2;
+	gint id, n, o, m[4], i, j, ndue = 0, maxsteps = 0;
+
+	for (id = 0; id < LANES; id++) {
+		v = b->stream[id];
+
+		if (v == NULL || !(mask & (1U << id))) {
+			act[id] = 0;
+
+			for (o = 0; o < 4; o++)
+				met[o * LANES + id] = 0;
+
+			continue;
 		}
+
+		act[id] = -1;
+
+		m[0] = v->mettab[0][sym[id][0]];
+		m[1] = v->mettab[1][sym[id][0]];
+		m[2] = v->mettab[0][sym[id][1]];
+		m[3] = v->mettab[1][sym[id][1]];
+
+		for (o = 0; o < 4; o++)
+			met[o * LANES + id] = branchmetric(m, o);
 	}
 
-	/*
-	 * Trace back 'traceback' steps, starting from the best state
-	 */
-	v->sequence[p] = beststate;
+	prev = b->metrics[b->curr];
+	curr = b->metrics[b->curr ^ 1];
+
+	b->acs(b, prev, curr, dec, met, act);
+
+	b->curr ^= 1;
+
+	/* hand each stream its row and finish the step */
+	for (id = 0; id < LANES; id++) {
+		if (!act[id])
+			continue;
+
+		v = b->stream[id];
+		currptr = v->ptr;
 
-	for (i = 0; i < v->traceback; i++) {
-		unsigned int prev = (p - 1) % PATHMEM;
+		if (bank_fullrow(v, currptr)) {
+			for (n = 0; n < b->nstates; n++)
+				v->metrics[currptr][n] = curr[n * LANES + id];
+		} else
+			v->metrics[currptr][0] = curr[id];
 
-		v->sequence[prev] = v->history[p][v->sequence[p]];
-		p = prev;
+		for (n = 0; n < HISTWORDS(v); n++) {
+			v->history[currptr][n] = dec[2 * n * LANES + id];
+
+			if (2 * n + 1 < DECROWS(b))
+				v->history[currptr][n] |= (guint32) dec[(2 * n + 1) * LANES + id] << 16;
+		}
+
+		out[id] = -1;
+
+		if (advance(v, currptr))
+			due[ndue++] = id;
 	}
 
-	if (metric)
-		*metric = v->metrics[p][v->sequence[p]];
+	if (ndue == 0)
+		return;
 
 	/*
-	 * Decode 'chunksize' bits
+	 * The traceback is a chain of dependent loads, so run the chains
+	 * of all the streams due together rather than one after another.
 	 */
-	for (c = i = 0; i < v->chunksize; i++) {
-		/*
-		 * low bit of state is the previous input bit
-		 */
-		c = (c << 1) | (v->sequence[p] & 1);
-		p = (p + 1) % PATHMEM;
+	for (i = 0; i < ndue; i++) {
+		v = b->stream[due[i]];
+		steps[i] = traceback_start(v, &currptr, &n);
+		p[i] = currptr;
+		s[i] = n;
+		hist[i] = v->history;
+		seq[i] = v->sequence;
+		maxsteps = MAX(maxsteps, steps[i]);
 	}
 
-	if (metric)
-		*metric = v->metrics[p][v->sequence[p]] - *metric;
+	for (j = 0; j < maxsteps; j++) {
+		for (i = 0; i < ndue; i++) {
+			if (j >= steps[i])
+				continue;
 
-	return c;
+			n = s[i];
+			n = (n >> 1) | ((hist[i][p[i]][n >> 5] >> (n & 31)) & 1) * half;
+			p[i] = (p[i] - 1) % PATHMEM;
+			s[i] = n;
+			seq[i][p[i]] = n;
+		}
+	}
+
+	for (i = 0; i < ndue; i++) {
+		id = due[i];
+		out[id] = traceback_end(b->stream[id], p[i], steps[i],
+					metric ? &metric[id] : NULL);
+	}
 }
 
 /* ---------------------------------------------------------------------- */
@@ -31,6 +31,14 @@
 
 #define PATHMEM 64
 
+/*
+ * The path metrics are 16 bit and kept relative to the metric of
+ * state 0 of the step before, norm[] holds the offset taken out at
+ * each step. The spread of the metrics is bounded by the constraint
+ * length so they never saturate. history[] holds one decision bit
+ * per state, set when the survivor came from the upper half of the
+ * previous states.
+ */
 struct viterbi {
 	gint traceback;
 	gint chunksize;
@@ -38,14 +46,25 @@ struct viterbi {
 
 	gint *output;
 
-	gint *metrics[PATHMEM];
-	gint *history[PATHMEM];
+	gint16 *metrics[PATHMEM];
+	guint32 *history[PATHMEM];
+	guint norm[PATHMEM];
+
+	gint16 *bmsel;
 
 	gint sequence[PATHMEM];
 
 	gint mettab[2][256];
 
 	guint ptr;
+	gint valid;
+
+	/* steps the bank has to keep whole metric rows for, see viterbi.c */
+	gint fullrows;
+
+	void (*acs) (struct viterbi *v, const gint16 *prev, gint16 *curr,
+		     guint32 *dec, const gint *met);
+	gint (*best) (const gint16 *metrics, gint nstates);
 };
 
 extern struct viterbi *viterbi_init(gint k, gint poly1, gint poly2);
@@ -58,6 +77,47 @@ extern void viterbi_free(struct viterbi *v);
 
 /* ---------------------------------------------------------------------- */
 
+#define	VITERBI_BANK_STREAMS	16
+
+/*
+ * Runs the add-compare-select of up to VITERBI_BANK_STREAMS decoders
+ * of the same code in one pass, one stream per SIMD lane. The current
+ * metrics of all the streams are kept interleaved in the bank, the
+ * path memory and traceback stay in each struct viterbi so every
+ * stream keeps its own traceback and chunk size, but the tracebacks
+ * falling due on the same step are run together. Any subset of the
+ * streams may be stepped at a time and the results are exactly what
+ * viterbi_decode() would give, also when a stream switches between
+ * asking for the metric and not. A stream in a bank must only be run
+ * through the bank.
+ */
+struct viterbi_bank {
+	gint nstates;
+	gint *output;
+
+	struct viterbi *stream[VITERBI_BANK_STREAMS];
+
+	gint16 *metrics[2];
+	gint curr;
+
+	guint16 *decisions;
+
+	void (*acs) (struct viterbi_bank *b, const gint16 *prev, gint16 *curr,
+		     guint16 *dec, const gint16 *met, const gint16 *mask);
+};
+
+extern struct viterbi_bank *viterbi_bank_init(gint k, gint poly1, gint poly2);
+extern void viterbi_bank_free(struct viterbi_bank *b);
+
+extern gint viterbi_bank_add(struct viterbi_bank *b, struct viterbi *v);
+extern void viterbi_bank_remove(struct viterbi_bank *b, gint id);
+extern void viterbi_bank_reset(struct viterbi_bank *b, gint id);
+
+extern void viterbi_bank_decode(struct viterbi_bank *b, guint mask,
+				guchar (*sym)[2], gint *out, gint *metric);
+
+/* ---------------------------------------------------------------------- */
+
 struct encoder {
 	gint *output;
 	guint shreg;
@@ -0,0 +1,198 @@
+/*
+ *    modem.c  --  Modem instance setup
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <string.h>
+#include <glib.h>
+
+#include "trx.h"
+
+/*
+ * Nothing in here may depend on the GUI. This is shared by gmfsk
+ * itself and the offline decoder.
+ */
+
+extern void mfsk_init(struct trx *trx);
+extern void olivia_init(struct trx *trx);
+extern void rtty_init(struct trx *trx);
+extern void throb_init(struct trx *trx);
+extern void psk31_init(struct trx *trx);
+extern void mt63_init(struct trx *trx);
+extern void feld_init(struct trx *trx);
+extern void cw_init(struct trx *trx);
+
+/* ---------------------------------------------------------------------- */
+
+char *trx_mode_names[] = {
+	"MFSK16",
+	"MFSK8",
+	"OLIVIA",
+	"RTTY",
+	"THROB1",
+	"THROB2",
+	"THROB4",
+	"BPSK31",
+	"QPSK31",
+	"PSK63",
+	"MT63",
+	"FELDHELL",
+	"FMHELL",
+	"CW"
+};
+
+char *trx_state_names[] = {
+	"PAUSED",
+	"RECEIVE",
+	"TRANSMIT",
+	"TUNING",
+	"ABORTED",
+	"FLUSHING"
+};
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Fill in the modem parameters with the same defaults gmfsk uses
+ * when there is no configuration.
+ */
+void trx_modem_defaults(struct trx *t, trx_mode_t mode)
+{
+	memset(t, 0, sizeof(struct trx));
+
+	t->mode = mode;
+	t->state = TRX_STATE_PAUSE;
+	t->samplerate = 8000;
+	t->frequency = 1000.0;
+
+	t->afcon = FALSE;
+	t->squelchon = TRUE;
+	t->reverse = FALSE;
+
+	t->mfsk_squelch = 15.0;
+
+	t->olivia_squelch = 4.0;
+	t->olivia_tones = 3;
+	t->olivia_bw = 3;
+	t->olivia_smargin = 8;
+	t->olivia_sinteg = 4;
+	t->olivia_esc = TRUE;
+
+	t->rtty_squelch = 15.0;
+	t->rtty_shift = 170.0;
+	t->rtty_baud = 45.45;
+	t->rtty_bits = 0;
+	t->rtty_parity = 0;
+	t->rtty_stop = 1;
+	t->rtty_reverse = TRUE;
+	t->rtty_msbfirst = FALSE;
+
+	t->throb_squelch = 15.0;
+
+	t->psk31_squelch = 15.0;
+
+	t->mt63_squelch = 15.0;
+	t->mt63_bandwidth = 1;
+	t->mt63_interleave = 1;
+	t->mt63_cwid = FALSE;
+	t->mt63_esc = TRUE;
+
+	t->hell_font = NULL;
+	t->hell_upper = TRUE;
+	t->hell_bandwidth = 245.0;
+	t->hell_agcattack = 5.0;
+	t->hell_agcdecay = 500.0;
+
+	t->cw_squelch = 15.0;
+	t->cw_speed = 18.0;
+	t->cw_bandwidth = 75.0;
+}
+
+/*
+ * Return the mode whose name matches 'name' (case insensitive), or -1.
+ */
+gint trx_mode_from_name(const gchar *name)
+{
+	gint i;
+
+	for (i = 0; i <= MODE_CW; i++)
+		if (g_ascii_strcasecmp(name, trx_mode_names[i]) == 0)
+			return i;
+
+	return -1;
+}
+
+/*
+ * Build the modem selected by 't->mode' into 't'. The parameters are
+ * taken from 't' itself so this works for the main trx as well as for
+ * the receive-only channels of the channel bank.
+ */
+gint trx_modem_init(struct trx *t)
+{
+	switch (t->mode) {
+	case MODE_MFSK16:
+	case MODE_MFSK8:
+		mfsk_init(t);
+		break;
+
+	case MODE_OLIVIA:
+		olivia_init(t);
+		break;
+
+	case MODE_RTTY:
+		rtty_init(t);
+		break;
+
+	case MODE_THROB1:
+	case MODE_THROB2:
+	case MODE_THROB4:
+		throb_init(t);
+		break;
+
+	case MODE_BPSK31:
+	case MODE_QPSK31:
+	case MODE_PSK63:
+		psk31_init(t);
+		break;
+
+	case MODE_MT63:
+		mt63_init(t);
+		break;
+
+	case MODE_FELDHELL:
+	case MODE_FMHELL:
+		feld_init(t);
+		break;
+
+	case MODE_CW:
+		cw_init(t);
+		break;
+	}
+
+	return (t->modem == NULL) ? -1 : 0;
+}
+
+/* ---------------------------------------------------------------------- */
@@ -1367,28 +1367,19 @@ short unsigned int AX25CRC(char *Data, int Len)
 // radix-2 FFT
 
 // constructor
-r2FFT::r2FFT() { BitRevIdx=NULL; Twiddle=NULL; /* Window=NULL; */ }
+r2FFT::r2FFT() { BitRevIdx=NULL; Twiddle=NULL; Engine=NULL; /* Window=NULL; */ }
 
 // destructor: free twiddles, bit-reverse lookup and window tables
-r2FFT::~r2FFT() { free(BitRevIdx); free(Twiddle); /* free(Window); */ }
+r2FFT::~r2FFT() { fftf_free(Engine); free(Twiddle); /* free(Window); */ }
 
+// the bit-reverse table belongs to the Engine
 void r2FFT::Free(void)
-{ free(BitRevIdx); BitRevIdx=NULL;
+{ fftf_free(Engine); Engine=NULL; BitRevIdx=NULL;
   free(Twiddle); Twiddle=NULL; }
 
 // ..........................................................................
 
 // a radix-2 FFT bufferfly
-inline void r2FFT::FFTbf(fcmpx &x0, fcmpx &x1, dcmpx &W)
-{ fcmpx x1W;
-  x1W.re=x1.re*W.re+x1.im*W.im;    // x1W.re=x1.re*W.re-x1.im*W.im;
-  x1W.im=(-x1.re*W.im)+x1.im*W.re; // x1W.im=x1.re*W.im+x1.im*W.re;
-  x1.re=x0.re-x1W.re;
-  x1.im=x0.im-x1W.im;
-  x0.re=x0.re+x1W.re;
-  x0.im=x0.im+x1W.im;
-}
-
 inline void r2FFT::FFTbf(dcmpx &x0, dcmpx &x1, dcmpx &W)
 { dcmpx x1W;
   x1W.re=x1.re*W.re+x1.im*W.im;    // x1W.re=x1.re*W.re-x1.im*W.im;
@@ -1410,34 +1401,8 @@ inline void r2FFT::FFT2(dcmpx &x0, dcmpx &x1)
   x0.im+=x1W.im;
 }
 
-inline void r2FFT::FFT2(fcmpx &x0, fcmpx &x1)
-{ fcmpx x1W;
-  x1W.re=x1.re;
-  x1W.im=x1.im;
-  x1.re=x0.re-x1.re;
-  x1.im=x0.im-x1.im;
-  x0.re+=x1W.re;
-  x0.im+=x1W.im;
-}
-
 // 4-point FFT
 // beware: these depend on the convention for the twiddle factors !
-inline void r2FFT::FFT4(fcmpx &x0, fcmpx &x1, fcmpx &x2, fcmpx &x3)
-{ dcmpx x1W;
-  x1W.re=x2.re;
-  x1W.im=x2.im;
-  x2.re=x0.re-x1W.re;
-  x2.im=x0.im-x1W.im;
-  x0.re=x0.re+x1W.re;
-  x0.im=x0.im+x1W.im;
-  x1W.re=x3.im;
-  x1W.im=(-x3.re);
-  x3.re=x1.re-x1W.re;
-  x3.im=x1.im-x1W.im;
-  x1.re=x1.re+x1W.re;
-  x1.im=x1.im+x1W.im;
-}
-
 inline void r2FFT::FFT4(dcmpx &x0, dcmpx &x1, dcmpx &x2, dcmpx &x3)
 { dcmpx x1W;
   x1W.re=x2.re;
@@ -1457,12 +1422,7 @@ inline void r2FFT::FFT4(dcmpx &x0, dcmpx &x1, dcmpx &x2, dcmpx &x3)
 
 // bit reverse (in place) the sequence (before the actuall FTT)
 void r2FFT::Scramble(fcmpx x[])
-{ int idx,ridx; fcmpx tmp;
-  for(idx=0; idx<Size; idx++)
-   if((ridx=BitRevIdx[idx])>idx)
-    { tmp=x[idx]; x[idx]=x[ridx]; x[ridx]=tmp;
-      /* printf("%d <=> %d\n",idx,ridx); */ }
-}
+{ fftf_scramble(Engine,(fcomplex *)x); }
 
 // bit reverse the sequence - double precision
 void r2FFT::Scramble(dcmpx x[])
@@ -1475,20 +1435,18 @@ void r2FFT::Scramble(dcmpx x[])
 
 // Preset for given processing size
 int r2FFT::Preset(int size)
-{ int err,idx,ridx,mask,rmask; double phase;
+{ int err,idx; double phase;
   if(!PowerOf2(size)) goto Error;
   Size=size;
-  err=ReallocArray(&BitRevIdx,Size); if(err) goto Error;
+  fftf_free(Engine);
+  Engine=fftf_init(Size); if(Engine==NULL) goto Error;
+  BitRevIdx=Engine->bitrev;
   err=ReallocArray(&Twiddle,Size); if(err) goto Error;
   for(idx=0; idx<Size; idx++)
   { phase=(2*M_PI*idx)/Size;
     Twiddle[idx].re=cos(phase); Twiddle[idx].im=sin(phase);
     /* printf("%2d => %6.4f => %6.4f %6.4f\n",
 	idx,phase,Twiddle[idx].re,Twiddle[idx].im); */ }
-  for(ridx=0,idx=0; idx<Size; idx++)
-  { for(ridx=0,mask=Size/2,rmask=1; mask; mask>>=1,rmask<<=1)
-    { if(idx&mask) ridx|=rmask; }
-    BitRevIdx[idx]=ridx; /* printf("%04x %04x\n",idx,ridx); */ }
 //  free(Window); Window=NULL; WinInpScale=1.0/Size; WinOutScale=0.5;
   return 0;
 
@@ -1603,16 +1561,11 @@ void r2FFT::OutWin(dcmpx Buff[], double Out0[], double Out1[])
 // looks like there is no gain by separating the second pass
 // and even the first pass is in question ?
 void r2FFT::CoreProc(fcmpx x[])
-{ int Groups,GroupHalfSize,Group,Bf,TwidIdx;
-  int HalfSize=Size/2;
-  for(Bf=0; Bf<Size; Bf+=2) FFT2(x[Bf],x[Bf+1]); // first pass
-  // for(Bf=0; Bf<Size; Bf+=4) FFT4(x[Bf],x[Bf+1],x[Bf+2],x[Bf+3]); // second
-  for(Groups=HalfSize/2,GroupHalfSize=2; Groups; Groups>>=1, GroupHalfSize<<=1)
-    for(Group=0,Bf=0; Group<Groups; Group++,Bf+=GroupHalfSize)
-      for(TwidIdx=0; TwidIdx<HalfSize; TwidIdx+=Groups,Bf++)
-      { FFTbf(x[Bf],x[Bf+GroupHalfSize],Twiddle[TwidIdx]);
-	/* printf("%2d %2d %2d\n",Bf,Bf+GroupHalfSize,TwidIdx); */ }
-}
+{ fftf_core(Engine,(fcomplex *)x); }
+
+// window, scramble and FFT
+void r2FFT::WinProc(fcmpx Inp[], float Window[], fcmpx Out[])
+{ fftf_run_window(Engine,(fcomplex *)Inp,Window,(fcomplex *)Out); }
 
 // radix-2 FFT with double precision
 void r2FFT::CoreProc(dcmpx x[])
@@ -1630,20 +1583,7 @@ void r2FFT::CoreProc(dcmpx x[])
 
 // separate the result of "two reals at one time" processing
 void r2FFT::SeparTwoReals(fcmpx Buff[], fcmpx Out0[], fcmpx Out1[])
-{ int idx,HalfSize=Size/2;
-//  for(idx=0; idx<Size; idx++)
-//    printf("%2d %9.5f %9.5f\n",idx,Buff[idx].re,Buff[idx].im);
-  Out0[0].re=Buff[0].re; Out1[0].re=Buff[0].im;
-  for(idx=1; idx<HalfSize; idx++)
-  { Out0[idx].re=  Buff[idx].re +Buff[Size-idx].re;
-    Out0[idx].im=  Buff[idx].im -Buff[Size-idx].im;
-    Out1[idx].re=  Buff[idx].im +Buff[Size-idx].im;
-    Out1[idx].im=(-Buff[idx].re)+Buff[Size-idx].re;
-  } Out0[0].im=Buff[HalfSize].re; Out1[0].im=Buff[HalfSize].im;
-//  for(idx=0; idx<HalfSize; idx++)
-//    printf("%2d  %9.5f %9.5f  %9.5f %9.5f\n",
-//      idx,Out0[idx].re,Out0[idx].im,Out1[idx].re,Out1[idx].im);
-}
+{ fftf_separ_two_reals(Engine,(fcomplex *)Buff,(fcomplex *)Out0,(fcomplex *)Out1); }
 
 // separate with double precision
 void r2FFT::SeparTwoReals(dcmpx Buff[], dcmpx Out0[], dcmpx Out1[])
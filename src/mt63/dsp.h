@@ -25,6 +25,8 @@
 #include <string.h>
 #include <math.h>
 
+#include "fftf.h"
+
 // ----------------------------------------------------------------------------
 // float/double/other-complex type
 
@@ -1043,8 +1045,11 @@ template <class type> int PowerOf2(type I)
 
 // ----------------------------------------------------------------------------
 
+// The single precision (fcmpx) transforms are done by the shared
+// FFT in misc/fftf.c, only the double precision ones are done here.
+
 class r2FFT // radix-2 FFT
-{ public:   // size must a power of 2: 2,4,8,16,32,64,128,256,...
+{ public:   // size must a power of 2: 4,8,16,32,64,128,256,...
    r2FFT();
    ~r2FFT();
    void Free(void);
@@ -1075,6 +1080,8 @@ class r2FFT // radix-2 FFT
   // complex FFT process in place, includes unscrambling
    inline void ProcInPlace(fcmpx x[]) { Scramble(x); CoreProc(x); }
    inline void ProcInPlace(dcmpx x[]) { Scramble(x); CoreProc(x); }
+  // multiply by the window, scramble and FFT in one go (Inp!=Out)
+   void WinProc(fcmpx Inp[], float Window[], fcmpx Out[]);
   // define the FFT window and input/output scales (NULL => rectangular window)
 //   int SetWindow(double (*NewWindow)(double phase),
 //	       double InpScale, double OutScale);
@@ -1106,17 +1113,15 @@ class r2FFT // radix-2 FFT
    int *BitRevIdx;	// Bit-reverse indexing table for data (un)scrambling
    dcmpx *Twiddle;	// Twiddle factors (sine/cos values)
   private:
+   struct fftf *Engine;	// the single precision FFT
 //   double *Window;	// window shape (NULL => rectangular window
 //   double WinInpScale, WinOutScale; // window scales on input/output
   private:
   // classic radix-2 butterflies
-   inline void FFTbf(fcmpx &x0, fcmpx &x1, dcmpx &W);
    inline void FFTbf(dcmpx &x0, dcmpx &x1, dcmpx &W);
   // special 2-elem. FFT for the first pass
-   inline void FFT2(fcmpx &x0, fcmpx &x1);
    inline void FFT2(dcmpx &x0, dcmpx &x1);
   // special 2-elem. FFT for the second pass
-   inline void FFT4(fcmpx &x0, fcmpx &x1, fcmpx &x2, fcmpx &x3);
    inline void FFT4(dcmpx &x0, dcmpx &x1, dcmpx &x2, dcmpx &x3);
 } ;
 
@@ -915,11 +915,7 @@ void MT63rx::SyncProcess(fcmpx *Slice)
 
   SyncPtr=(SyncPtr+1)&(SymbolDiv-1); // increment the correlators pointer
 
-  for(i=0; i<WindowLen; i++)
-  { r=FFT.BitRevIdx[i];
-    FFTbuff[r].re=Slice[i].re*RxWindow[i];
-    FFTbuff[r].im=Slice[i].im*RxWindow[i]; }
-  FFT.CoreProc(FFTbuff);
+  FFT.WinProc(Slice,RxWindow,FFTbuff);
 
   if(SpectraDisplay)
   { for(i=0,j=FirstDataCarr+(DataCarriers/2)*DataCarrSepar-WindowLen/2;
@@ -1052,9 +1052,7 @@ template <class Type=float>
    r2FFT< Cmpx<Type> > FFT;             // FFT engine
    Cmpx<Type> *FFT_Buff;                // FFT buffer
 
-   size_t  SpectraLen;                    // number of spectra points per FFT
-   Cmpx<Type> *Spectra[SpectraPerSymbol]; // two buffers for FFT spectra
-   Type       *Energy[SpectraPerSymbol];
+   Type       *Energy[SpectraPerSymbol]; // energies of the two FFT slices
 
    CircularBuffer<Type> EnergyBuffer;
    LowPass3_Filter<Type> *AverageEnergy;
@@ -1073,8 +1071,6 @@ template <class Type=float>
      { InpTap=0;
 	   SymbolShape=0;
 	   FFT_Buff=0;
-       Spectra[0]=0;
-	   Spectra[1]=0;
        Energy[0]=0;
 	   Energy[1]=0;
        AverageEnergy=0; }
@@ -1083,8 +1079,6 @@ template <class Type=float>
      { free(InpTap); InpTap=0;
 	   free(SymbolShape); SymbolShape=0;
 	   free(FFT_Buff); FFT_Buff=0;
-	   free(Spectra[0]); Spectra[0]=0;
-       free(Spectra[1]); Spectra[1]=0;
 	   free(Energy[0]); Energy[0]=0;
        free(Energy[1]); Energy[1]=0;
        free(AverageEnergy); AverageEnergy=0;
@@ -1139,10 +1133,6 @@ template <class Type=float>
 	       SymbolShape[Time]*=ShapeScale;
 	   }
 
-       SpectraLen=SymbolLen/2;
-       if(ReallocArray(&Spectra[0],SpectraLen)<0) goto Error;
-       if(ReallocArray(&Spectra[1],SpectraLen)<0) goto Error;
-
        if(DecodeMargin>FirstCarrier) DecodeMargin=FirstCarrier;
        DecodeWidth=(Carriers*CarrierSepar-1)+2*DecodeMargin;
 
@@ -1178,8 +1168,11 @@ template <class Type=float>
        { InpTap[InpTapPtr]=Input[InpIdx];
          InpTapPtr+=1; InpTapPtr&=WrapMask; }
 
+       // window straight into the bit-reversed order for the FFT
+       int *BitRevIdx=FFT.BitRevIdx;
+
        for(Time=0; Time<SymbolLen; Time++)
-       { FFT_Buff[Time].Re=InpTap[InpTapPtr]*SymbolShape[Time];
+       { FFT_Buff[BitRevIdx[Time]].Re=InpTap[InpTapPtr]*SymbolShape[Time];
          InpTapPtr+=1; InpTapPtr&=WrapMask; }
 
        for(        ; InpIdx<SymbolSepar ; InpIdx++)
@@ -1187,14 +1180,13 @@ template <class Type=float>
          InpTapPtr+=1; InpTapPtr&=WrapMask; }
 
        for(Time=0; Time<SymbolLen; Time++)
-       { FFT_Buff[Time].Im=InpTap[InpTapPtr]*SymbolShape[Time];
+       { FFT_Buff[BitRevIdx[Time]].Im=InpTap[InpTapPtr]*SymbolShape[Time];
          InpTapPtr+=1; InpTapPtr&=WrapMask; }
 
-       FFT.Process(FFT_Buff);
-       FFT.SeparTwoReals(FFT_Buff, Spectra[0], Spectra[1]);
+       FFT.CoreProc(FFT_Buff);
 
        if(EqualizerDepth)
-       { size_t Idx,Freq;
+       { size_t Idx;
          Type *Data0 = EnergyBuffer.OffsetPtr(0);
          Type *Data1 = EnergyBuffer.OffsetPtr(1);
 
@@ -1202,14 +1194,10 @@ template <class Type=float>
          { Energy[0][Idx]=Data0[Idx];
            Energy[1][Idx]=Data1[Idx]; }
 
-         Freq=FirstCarrier-DecodeMargin;
-         for(Idx=0; Idx<DecodeWidth; Idx++, Freq++)
-         { Type Energy0=Spectra[0][Freq].Energy();
-           Data0[Idx]=Energy0;
-           AverageEnergy[Idx].Process(Energy0,FilterWeight);
-           Type Energy1=Spectra[1][Freq].Energy();
-           Data1[Idx]=Energy1;
-           AverageEnergy[Idx].Process(Energy1,FilterWeight); }
+         FFT.SeparEnergy(FFT_Buff, FirstCarrier-DecodeMargin, DecodeWidth, Data0, Data1);
+         for(Idx=0; Idx<DecodeWidth; Idx++)
+         { AverageEnergy[Idx].Process(Data0[Idx],FilterWeight);
+           AverageEnergy[Idx].Process(Data1[Idx],FilterWeight); }
 /*
          for(Idx=0; Idx<DecodeWidth; Idx++, Freq++)
          { Type RefEnergy=AverageEnergy[Idx].Output;
@@ -1224,12 +1212,7 @@ template <class Type=float>
          EnergyBuffer+=2;
        }
        else
-       { size_t Idx;
-         size_t Freq=FirstCarrier-DecodeMargin;
-         for(Idx=0; Idx<DecodeWidth; Idx++, Freq++)
-         { Energy[0][Idx]=Spectra[0][Freq].Energy(); 
-           Energy[1][Idx]=Spectra[1][Freq].Energy(); }
-       }
+         FFT.SeparEnergy(FFT_Buff, FirstCarrier-DecodeMargin, DecodeWidth, Energy[0], Energy[1]);
      }
 
      uint8_t HardDecode(size_t Slice=0, int FreqOffset=0)
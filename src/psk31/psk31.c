@@ -26,7 +26,7 @@
 #include <stdio.h>
 
 #include "psk31.h"
-#include "filter.h"
+#include "decimator.h"
 #include "coeff.h"
 
 #define	K	5
@@ -51,7 +51,7 @@ static void psk31_rxinit(struct trx *trx)
 {
 	struct psk31 *s = (struct psk31 *) trx->modem;
 
-	s->phaseacc = 0;
+	nco_init(&s->rxnco, 0.0);
 
 	c_re(s->prevsymbol) = 1.0;
 	c_im(s->prevsymbol) = 0.0;
@@ -69,8 +69,8 @@ static void psk31_rxinit(struct trx *trx)
 static void psk31_free(struct psk31 *s)
 {
 	if (s) {
-		filter_free(s->fir1);
-		filter_free(s->fir2);
+		decimator_free(s->fir1);
+		decimator_free(s->fir2);
 
 		encoder_free(s->enc);
 		viterbi_free(s->dec);
@@ -119,8 +119,8 @@ void psk31_init(struct trx *trx)
 		return;
 	}
 
-	s->fir1 = filter_init(FIRLEN, s->symbollen / 16, fir1c, fir1c);
-	s->fir2 = filter_init(FIRLEN, 1, fir2c, fir2c);
+	s->fir1 = decimator_init(FIRLEN, s->symbollen / 16, fir1c);
+	s->fir2 = decimator_init(FIRLEN, 1, fir2c);
 
 	if (!s->fir1 || !s->fir2) {
 		psk31_free(s);
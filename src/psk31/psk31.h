@@ -26,6 +26,7 @@
 #define _PSK31_H
 
 #include "cmplx.h"
+#include "nco.h"
 #include "trx.h"
 #include "viterbi.h"
 
@@ -40,14 +41,15 @@ struct psk31 {
 	int qpsk;
 
 	double phaseacc;
+	struct nco rxnco;
 	complex prevsymbol;
 	unsigned int shreg;
 
 	/*
 	 * RX related stuff
 	 */
-	struct filter *fir1;
-	struct filter *fir2;
+	struct decimator *fir1;
+	struct decimator *fir2;
 
 	struct encoder *enc;
 	struct viterbi *dec;
@@ -26,6 +26,8 @@
 
 #include "psk31.h"
 #include "filter.h"
+#include "decimator.h"
+#include "cvec.h"
 #include "varicode.h"
 #include "coeff.h"
 
@@ -160,37 +162,44 @@ static void update_syncscope(struct trx *trx)
 int psk31_rxprocess(struct trx *trx, float *buf, int len)
 {
 	struct psk31 *s = (struct psk31 *) trx->modem;
-	double delta;
-	complex z;
-	int i;
+	complex zbuf[FILTER_BLOCKLEN], z;
+	double re[FILTER_BLOCKLEN], im[FILTER_BLOCKLEN];
+	double mag[FILTER_BLOCKLEN];
+	int i, j, n;
 
-	delta = 2.0 * M_PI * trx->frequency / SampleRate;
+	nco_set_freq(&s->rxnco, trx->frequency / SampleRate);
 
-	while (len-- > 0) {
-		/* Mix with the internal NCO */
-		c_re(z) = *buf * cos(s->phaseacc);
-		c_im(z) = *buf * sin(s->phaseacc);
-		buf++;
+	while (len > 0) {
+		n = MIN(len, FILTER_BLOCKLEN);
 
-		s->phaseacc += delta;
+		/* Mix with the internal NCO */
+		nco_mix_real(&s->rxnco, buf, zbuf, n);
 
-		if (s->phaseacc > M_PI)
-			s->phaseacc -= 2.0 * M_PI;
+		buf += n;
+		len -= n;
 
 		/* Filter and downsample by 16 or 8 */
-		if (filter_run(s->fir1, z, &z)) {
+		n = decimator_run(s->fir1, zbuf, n, zbuf);
+
+		/* Do the second filtering */
+		decimator_run(s->fir2, zbuf, n, zbuf);
+
+		/* amplitudes for the sync */
+		cvec_split(zbuf, re, im, n);
+		cvec_mag(re, im, mag, n);
+
+		for (j = 0; j < n; j++) {
 			double sum;
 			int idx;
 
-			/* Do the second filtering */
-			filter_run(s->fir2, z, &z);
+			z = zbuf[j];
 
 			/* save amplitude value for the sync scope */
-			s->pipe[s->pipeptr] = cmod(z);
+			s->pipe[s->pipeptr] = mag[j];
 
 			/* Now the sync correction routine... */
 			idx = (int) s->bitclk;
-			s->syncbuf[idx] = cmod(z);
+			s->syncbuf[idx] = mag[j];
 
 			sum = 0.0;
 			for (i = 0; i < 8; i++)
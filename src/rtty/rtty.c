@@ -28,8 +28,8 @@
 #include "trx.h"
 #include "rtty.h"
 #include "baudot.h"
-#include "filter.h"
-#include "fftfilt.h"
+#include "hilbert.h"
+#include "firfilt.h"
 
 static void rtty_txinit(struct trx *trx)
 {
@@ -45,7 +45,8 @@ static void rtty_txinit(struct trx *trx)
 static void rtty_free(struct rtty *s)
 {
 	if (s) {
-		filter_free(s->hilbert);
+		hilbert_free(s->hilbert);
+		firfilt_free(s->filt);
 		g_free(s);
 	}
 }
@@ -56,6 +57,8 @@ static void rtty_rxinit(struct trx *trx)
 
 	r->rxmode = BAUDOT_LETS;
 	r->txmode = BAUDOT_LETS;
+
+	nco_init(&r->rxnco, 0.0);
 }
 
 static void rtty_destructor(struct trx *trx)
@@ -140,14 +143,14 @@ void rtty_init(struct trx *trx)
 //	fhi = 0.25;
 //	fprintf(stderr, "flo=%f fhi=%f\n", flo * SampleRate, fhi * SampleRate);
 
-	if ((s->hilbert = filter_init_hilbert(37, 1)) == NULL) {
+	if ((s->hilbert = hilbert_init(37)) == NULL) {
 		g_warning("rtty_init: init_hilbert failed\n");
 		rtty_free(s);
 		return;
 	}
 
-	if ((s->fftfilt = fftfilt_init(flo, fhi, 2048)) == NULL) {
-		g_warning("rtty_init: init_fftfilt failed\n");
+	if ((s->filt = firfilt_init(flo, fhi, 1025, 1)) == NULL) {
+		g_warning("rtty_init: firfilt_init failed\n");
 		rtty_free(s);
 		return;
 	}
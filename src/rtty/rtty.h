@@ -26,6 +26,7 @@
 #define _RTTY_H
 
 #include "cmplx.h"
+#include "nco.h"
 #include "trx.h"
 
 #define	SampleRate	8000
@@ -61,12 +62,13 @@ struct rtty {
 	int msb;
 
 	double phaseacc;
+	struct nco rxnco;
 
 	/*
 	 * RX related stuff
 	 */
-	struct filter *hilbert;
-	struct fftfilt *fftfilt;
+	struct hilbert *hilbert;
+	struct firfilt *filt;
 
 	double pipe[MaxSymLen];
 	unsigned int pipeptr;
@@ -81,6 +83,7 @@ struct rtty {
 	int rxdata;
 
 	double prevsymbol;
+	complex prevz;
 
 	int rxmode;
 
@@ -27,7 +27,8 @@
 #include "trx.h"
 #include "rtty.h"
 #include "filter.h"
-#include "fftfilt.h"
+#include "hilbert.h"
+#include "firfilt.h"
 #include "misc.h"
 #include "baudot.h"
 #include "rttypar.h"
@@ -61,26 +62,6 @@ static void update_syncscope(struct rtty *s)
 	trx_set_scope(data, s->symbollen, FALSE);
 }
 
-static inline complex mixer(struct trx *trx, complex in)
-{
-	struct rtty *s = (struct rtty *) trx->modem;
-	complex z;
-
-	c_re(z) = cos(s->phaseacc);
-	c_im(z) = sin(s->phaseacc);
-
-	z = cmul(z, in);
-
-	s->phaseacc -= 2.0 * M_PI * trx->frequency / SampleRate;
-
-	if (s->phaseacc > M_PI)
-		s->phaseacc -= 2.0 * M_PI;
-	else if (s->phaseacc < M_PI)
-		s->phaseacc += 2.0 * M_PI;
-
-	return z;
-}
-
 static unsigned char bitreverse(unsigned char in, int n)
 {
 	unsigned char out = 0;
@@ -191,28 +172,30 @@ static int rttyrx(struct rtty *s, int bit)
 int rtty_rxprocess(struct trx *trx, float *buf, int len)
 {
 	struct rtty *s = (struct rtty *) trx->modem;
-	complex z, *zp;
-	int n, i, bit, rev;
+	complex zbuf[FILTER_BLOCKLEN], *zp;
+	int num, n, i, bit, rev;
 	double f;
 
 	rev = (trx->reverse != 0) ^ (s->reverse != 0);
 
-	while (len-- > 0) {
+	while (len > 0) {
+		num = MIN(len, FILTER_BLOCKLEN);
+
 		/* create analytic signal... */
-		c_re(z) = c_im(z) = *buf++;
+		hilbert_run(s->hilbert, buf, num, zbuf);
 
-		filter_run(s->hilbert, z, &z);
+		buf += num;
+		len -= num;
 
 		/* ...so it can be shifted in frequency */
-		z = mixer(trx, z);
+		nco_set_freq(&s->rxnco, -trx->frequency / SampleRate);
+		nco_mix(&s->rxnco, zbuf, zbuf, num);
 
-		n = fftfilt_run(s->fftfilt, z, &zp);
+		n = firfilt_run_block(s->filt, zbuf, num, &zp);
 
 		for (i = 0; i < n; i++) {
-			static complex prev;
-
-			f = carg(ccor(prev, zp[i])) * SampleRate / (2 * M_PI);
-			prev = zp[i];
+			f = carg(ccor(s->prevz, zp[i])) * SampleRate / (2 * M_PI);
+			s->prevz = zp[i];
 
 			f = bbfilt(s, f);
 			s->pipe[s->pipeptr] = f;
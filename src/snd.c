@@ -43,6 +43,7 @@
 #include "misc.h"
 #include "cwirc.h"
 #include "samplerate.h"
+#include "stats.h"
 
 #include <alsa/asoundlib.h>
 
@@ -645,6 +646,7 @@ char *sound_error(void)
 
 gint sound_write(gfloat *buf, gint cnt)
 {
+	guint64 t;
 	gint n;
 
 #if SND_DEBUG > 1
@@ -671,11 +673,16 @@ gint sound_write(gfloat *buf, gint cnt)
 	tx_src_data->output_frames = SRC_BUF_LEN;
 	tx_src_data->end_of_input = 0;
 
+	t = stats_time();
+
 	if ((n = src_process(tx_src_state, tx_src_data)) != 0) {
 		snderr(_("sound_write: src_process: %s"), src_strerror(n));
 		return -1;
 	}
 
+	stats_add(STATS_RESAMPLE, t, tx_src_data->output_frames_gen,
+		  config.samplerate);
+
 	write_samples(src_buffer, tx_src_data->output_frames_gen);
 	//write_samples(src_buffer, cnt); //FIXME
 //
@@ -685,6 +692,7 @@ gint sound_write(gfloat *buf, gint cnt)
 static gint write_samples(gfloat *buf, gint count)
 {
 	void *p;
+	guint64 t;
 	gint i, j, err;
 //
 #if SND_DEBUG > 1
@@ -704,6 +712,8 @@ static gint write_samples(gfloat *buf, gint count)
 	if (cwirc_extension_mode)
 		return cwirc_sound_write(buf, count);
 
+	t = stats_time();
+
 	if (config.flags & SND_FLAG_8BIT) {
 		for (i = j = 0; i < count; i++) {
 			snd_b_buffer[j++] = (buf[i] * 127.0 * SND_VOL) + 128.0;
@@ -731,10 +741,15 @@ static gint write_samples(gfloat *buf, gint count)
 //		snderr(_("write_samples: write: %m"));
 //
 //	return i;
+	stats_add(STATS_SOUND_WRITE, t, count, config.samplerate);
+
+	t = stats_time();
 	err = snd_pcm_writei(alsa_dev_tx, p, count);
+	stats_wait(t);
 
 	if (err == -EPIPE) {
 		snderr(_("Underrun"));
+		stats_xrun(STATS_SOUND_WRITE);
 		snd_pcm_prepare(alsa_dev_tx);
 	} else if (err < 0) {
 		snderr(_("Read error"));
@@ -753,6 +768,7 @@ static gint write_samples(gfloat *buf, gint count)
 gint sound_read(gfloat **buffer, gint *count)
 {
 	struct timespec ts;
+	guint64 t;
 	gint n;
 
 #if SND_DEBUG > 1
@@ -766,7 +782,9 @@ gint sound_read(gfloat **buffer, gint *count)
 		ts.tv_sec = 0;
 		ts.tv_nsec = *count * (1000000000L / 8000);
 
+		t = stats_time();
 		nanosleep(&ts, NULL);
+		stats_wait(t);
 
 		for (n = 0; n < *count; n++)
 			snd_buffer[n] = (g_random_double() - 0.5) / 100.0;
@@ -798,10 +816,15 @@ gint sound_read(gfloat **buffer, gint *count)
 	rx_src_data->output_frames = SND_BUF_LEN;
 	rx_src_data->end_of_input = 0;
 
+	t = stats_time();
+
 	if ((n = src_process(rx_src_state, rx_src_data)) != 0) {
 		snderr(_("sound_read: src_process: %s"), src_strerror(n));
 		return -1;
 	}
+
+	stats_add(STATS_RESAMPLE, t, rx_src_data->input_frames,
+		  config.samplerate);
 //
 	*count = rx_src_data->output_frames_gen;
 //	*count = n; //FIXME
@@ -813,6 +836,7 @@ gint sound_read(gfloat **buffer, gint *count)
 
 static gint read_samples(gfloat *buf, gint count)
 {
+	guint64 t;
 	gint len, i, j, err;
 
 #if SND_DEBUG > 1
@@ -839,11 +863,14 @@ static gint read_samples(gfloat *buf, gint count)
 
 	if (config.flags & SND_FLAG_8BIT) {
 
+		t = stats_time();
 		err = snd_pcm_readi(alsa_dev_rx, snd_b_buffer, count);
+		stats_wait(t);
 		len = count;
 
 		if (err == -EPIPE) {
 			snderr(_("Overrun"));
+			stats_xrun(STATS_SOUND_READ);
 			snd_pcm_prepare(alsa_dev_rx);
 		} else if (err < 0) {
 			snderr(_("Read error"));
@@ -862,17 +889,22 @@ static gint read_samples(gfloat *buf, gint count)
 //		if (config.flags & SND_FLAG_STEREO)
 //			len /= 2;
 //
+		t = stats_time();
+
 		for (i = j = 0; i < len; i++) {
 			buf[i] = (snd_b_buffer[j++] - 128) / 128.0;
 			if (config.flags & SND_FLAG_STEREO)
 				j++;
 		}
 	} else {
+		t = stats_time();
 		err = snd_pcm_readi(alsa_dev_rx, snd_w_buffer, count);
+		stats_wait(t);
 		len = count;
 
 		if (err == -EPIPE) {
 			snderr(_("Overrun"));
+			stats_xrun(STATS_SOUND_READ);
 			snd_pcm_prepare(alsa_dev_rx);
 		} else if (err < 0) {
 			snderr(_("Read error"));
@@ -893,6 +925,8 @@ static gint read_samples(gfloat *buf, gint count)
 //		if (config.flags & SND_FLAG_STEREO)
 //			len /= 2;
 
+		t = stats_time();
+
 		for (i = j = 0; i < len; i++) {
 			buf[i] = snd_w_buffer[j++] / 32768.0;
 			if (config.flags & SND_FLAG_STEREO)
@@ -900,6 +934,8 @@ static gint read_samples(gfloat *buf, gint count)
 		}
 	}
 
+	stats_add(STATS_SOUND_READ, t, len, config.samplerate);
+
 	return len;
 
 error:
@@ -0,0 +1,517 @@
+/*
+ *    stats.c  --  DSP timing statistics
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "stats.h"
+
+/*
+ * Every processing stage of interest is wrapped like this:
+ *
+ *	t = stats_time();
+ *	trx.rxprocess(&trx, buf, len);
+ *	stats_add(STATS_RXPROCESS, t, len, trx.samplerate);
+ *
+ * For each stage we keep the call count, the total and maximum time,
+ * a histogram of the call durations in power of two microsecond bins
+ * and the number of samples processed, so that the realtime factor of
+ * every stage can be computed. The last STATS_TRACE_LEN calls are also
+ * kept as individual events and can be saved as a Chrome trace file
+ * (load it in chrome://tracing or Perfetto).
+ *
+ * The sound stages only cover the sample conversion. The time spent
+ * blocked in the sound card is no DSP cost, it is wrapped with
+ * stats_wait() instead and reported on a line of its own.
+ *
+ * All of this is kept per thread, so the receive, transmit and
+ * capture threads each only ever take their own, uncontended lock.
+ * The report and the trace file add the threads up.
+ */
+
+#define	STATS_HIST_BINS		24
+#define	STATS_TRACE_LEN		65536
+
+struct stage {
+	guint64 calls;
+	guint64 total;
+	guint64 max;
+	guint64 samples;
+	gint samplerate;
+	guint xruns;
+	guint hist[STATS_HIST_BINS];
+};
+
+struct event {
+	guint64 start;
+	guint32 dur;
+	guint16 stage;
+	guint16 tid;
+};
+
+struct thread_stats {
+	pthread_mutex_t mutex;
+	guint16 tid;
+	gboolean inuse;
+
+	/* time spent blocked in the sound card, see stats_waited() */
+	guint64 waited;
+	struct stage wait;
+
+	struct stage stages[STATS_NUM_STAGES];
+
+	struct event *trace;
+	guint tracepos;
+	guint tracelen;
+
+	struct thread_stats *next;
+};
+
+char *stats_stage_names[] = {
+	"sound_read",
+	"sound_write",
+	"resample",
+	"waterfall",
+	"rxprocess",
+	"txprocess",
+	"main_loop"
+};
+
+/* protects the list of threads, not their contents */
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct thread_stats *threads = NULL;
+static gint tid_next = 1;
+
+/* off until asked for, the clock calls are not free */
+static volatile gboolean enabled = FALSE;
+
+static struct timespec epoch;
+static pthread_key_t thread_key;
+static pthread_once_t stats_once = PTHREAD_ONCE_INIT;
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * A thread that exits leaves its numbers in the list, and the next
+ * new thread carries on with the record.
+ */
+static void thread_exit(gpointer data)
+{
+	struct thread_stats *ts = data;
+
+	pthread_mutex_lock(&stats_mutex);
+	ts->inuse = FALSE;
+	pthread_mutex_unlock(&stats_mutex);
+}
+
+static void stats_init(void)
+{
+	clock_gettime(CLOCK_MONOTONIC, &epoch);
+	pthread_key_create(&thread_key, thread_exit);
+}
+
+static struct thread_stats *thread_stats(void)
+{
+	struct thread_stats *ts;
+
+	pthread_once(&stats_once, stats_init);
+
+	if ((ts = pthread_getspecific(thread_key)) != NULL)
+		return ts;
+
+	pthread_mutex_lock(&stats_mutex);
+
+	for (ts = threads; ts; ts = ts->next)
+		if (!ts->inuse)
+			break;
+
+	if (ts == NULL) {
+		ts = g_new0(struct thread_stats, 1);
+		pthread_mutex_init(&ts->mutex, NULL);
+		ts->tid = tid_next++;
+		ts->trace = g_new(struct event, STATS_TRACE_LEN);
+		ts->next = threads;
+		threads = ts;
+	}
+
+	ts->inuse = TRUE;
+
+	pthread_mutex_unlock(&stats_mutex);
+
+	pthread_setspecific(thread_key, ts);
+
+	return ts;
+}
+
+static inline gint hist_bin(guint64 us)
+{
+	gint i = 0;
+
+	while (us > 0 && i < STATS_HIST_BINS - 1) {
+		us >>= 1;
+		i++;
+	}
+
+	return i;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void stats_enable(gboolean on)
+{
+	enabled = on;
+}
+
+gboolean stats_enabled(void)
+{
+	return enabled;
+}
+
+/*
+ * Microseconds on the monotonic clock since the first call, plus one.
+ * Returns 0 when disabled so that the instrumented code does not pay
+ * for the clock, and a stage started while disabled is not counted
+ * when stats are turned on meanwhile.
+ */
+guint64 stats_time(void)
+{
+	struct timespec ts;
+
+	if (!enabled)
+		return 0;
+
+	pthread_once(&stats_once, stats_init);
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (guint64) (ts.tv_sec - epoch.tv_sec) * 1000000 +
+		(ts.tv_nsec - epoch.tv_nsec) / 1000 + 1;
+}
+
+/*
+ * Total time this thread has spent waiting for the sound card, see
+ * stats_wait(). The modems write their output from within txprocess,
+ * so the transmit loop takes the difference of two calls out of its
+ * own figure.
+ */
+guint64 stats_waited(void)
+{
+	if (!enabled)
+		return 0;
+
+	return thread_stats()->waited;
+}
+
+void stats_add(stats_stage_t stage, guint64 start,
+	       gint samples, gint samplerate)
+{
+	struct thread_stats *ts;
+	struct stage *s;
+	struct event *e;
+	guint64 now, dur;
+
+	if (!enabled || start == 0 || stage >= STATS_NUM_STAGES)
+		return;
+
+	now = stats_time();
+	dur = (now > start) ? now - start : 0;
+
+	ts = thread_stats();
+
+	pthread_mutex_lock(&ts->mutex);
+
+	s = &ts->stages[stage];
+
+	s->calls++;
+	s->total += dur;
+	s->max = MAX(s->max, dur);
+	s->hist[hist_bin(dur)]++;
+
+	if (samples > 0 && samplerate > 0) {
+		s->samples += samples;
+		s->samplerate = samplerate;
+	}
+
+	e = &ts->trace[ts->tracepos];
+
+	e->start = start;
+	e->dur = MIN(dur, G_MAXUINT);
+	e->stage = stage;
+	e->tid = ts->tid;
+
+	ts->tracepos = (ts->tracepos + 1) % STATS_TRACE_LEN;
+	ts->tracelen = MIN(ts->tracelen + 1, STATS_TRACE_LEN);
+
+	pthread_mutex_unlock(&ts->mutex);
+}
+
+/*
+ * Count the time since 'start' as spent blocked in the sound card.
+ */
+void stats_wait(guint64 start)
+{
+	struct thread_stats *ts;
+	guint64 now, dur;
+
+	if (!enabled || start == 0)
+		return;
+
+	now = stats_time();
+	dur = (now > start) ? now - start : 0;
+
+	ts = thread_stats();
+
+	pthread_mutex_lock(&ts->mutex);
+
+	ts->waited += dur;
+	ts->wait.calls++;
+	ts->wait.total += dur;
+	ts->wait.max = MAX(ts->wait.max, dur);
+
+	pthread_mutex_unlock(&ts->mutex);
+}
+
+/*
+ * Count a sound card overrun/underrun or a ring overflow.
+ */
+void stats_xrun(stats_stage_t stage)
+{
+	struct thread_stats *ts;
+
+	if (stage >= STATS_NUM_STAGES)
+		return;
+
+	ts = thread_stats();
+
+	pthread_mutex_lock(&ts->mutex);
+	ts->stages[stage].xruns++;
+	pthread_mutex_unlock(&ts->mutex);
+}
+
+void stats_reset(void)
+{
+	struct thread_stats *ts;
+
+	pthread_mutex_lock(&stats_mutex);
+
+	for (ts = threads; ts; ts = ts->next) {
+		pthread_mutex_lock(&ts->mutex);
+		memset(ts->stages, 0, sizeof(ts->stages));
+		memset(&ts->wait, 0, sizeof(ts->wait));
+		ts->tracepos = 0;
+		ts->tracelen = 0;
+		pthread_mutex_unlock(&ts->mutex);
+	}
+
+	pthread_mutex_unlock(&stats_mutex);
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Upper bound in microseconds of the histogram bin below which the
+ * fraction 'q' of the calls fall, but no more than the maximum seen.
+ */
+static guint64 hist_quantile(struct stage *s, gdouble q)
+{
+	guint64 n = 0;
+	gint i;
+
+	for (i = 0; i < STATS_HIST_BINS; i++) {
+		n += s->hist[i];
+
+		if (n >= q * s->calls)
+			break;
+	}
+
+	return MIN((guint64) 1 << i, s->max);
+}
+
+gchar *stats_report(gboolean histograms)
+{
+	struct stage copy[STATS_NUM_STAGES], wait;
+	struct thread_stats *ts;
+	struct stage *s, *t;
+	GString *str;
+	gdouble secs;
+	gint i, j;
+
+	memset(copy, 0, sizeof(copy));
+	memset(&wait, 0, sizeof(wait));
+
+	pthread_mutex_lock(&stats_mutex);
+
+	for (ts = threads; ts; ts = ts->next) {
+		pthread_mutex_lock(&ts->mutex);
+
+		for (i = 0; i < STATS_NUM_STAGES; i++) {
+			s = &copy[i];
+			t = &ts->stages[i];
+
+			s->calls += t->calls;
+			s->total += t->total;
+			s->max = MAX(s->max, t->max);
+			s->samples += t->samples;
+			if (t->samplerate)
+				s->samplerate = t->samplerate;
+			s->xruns += t->xruns;
+
+			for (j = 0; j < STATS_HIST_BINS; j++)
+				s->hist[j] += t->hist[j];
+		}
+
+		wait.calls += ts->wait.calls;
+		wait.total += ts->wait.total;
+		wait.max = MAX(wait.max, ts->wait.max);
+
+		pthread_mutex_unlock(&ts->mutex);
+	}
+
+	pthread_mutex_unlock(&stats_mutex);
+
+	str = g_string_new(NULL);
+
+	g_string_append_printf(str, "%-12s %9s %8s %8s %8s %8s %9s %6s\n",
+			       "stage", "calls", "avg us", "p50 us",
+			       "p99 us", "max us", "realtime", "xruns");
+
+	for (i = 0; i < STATS_NUM_STAGES; i++) {
+		s = &copy[i];
+
+		if (s->calls == 0 && s->xruns == 0)
+			continue;
+
+		g_string_append_printf(str, "%-12s %9llu %8llu %8llu %8llu %8llu ",
+				       stats_stage_names[i],
+				       (unsigned long long) s->calls,
+				       (unsigned long long) (s->calls ? s->total / s->calls : 0),
+				       (unsigned long long) hist_quantile(s, 0.50),
+				       (unsigned long long) hist_quantile(s, 0.99),
+				       (unsigned long long) s->max);
+
+		/* audio seconds processed per second spent */
+		if (s->samples && s->total) {
+			secs = (gdouble) s->samples / s->samplerate;
+			g_string_append_printf(str, "%8.1fx ",
+					       secs / (s->total / 1e6));
+		} else
+			g_string_append_printf(str, "%9s ", "-");
+
+		g_string_append_printf(str, "%6u\n", s->xruns);
+
+		if (!histograms || s->calls == 0)
+			continue;
+
+		for (j = 0; j < STATS_HIST_BINS; j++) {
+			if (s->hist[j] == 0)
+				continue;
+
+			g_string_append_printf(str, "    < %8llu us  %9u\n",
+					       (unsigned long long) ((guint64) 1 << j),
+					       s->hist[j]);
+		}
+	}
+
+	if (wait.calls)
+		g_string_append_printf(str, "sound card wait: %llu calls, "
+				       "avg %llu us, max %llu us\n",
+				       (unsigned long long) wait.calls,
+				       (unsigned long long) (wait.total / wait.calls),
+				       (unsigned long long) wait.max);
+
+	return g_string_free(str, FALSE);
+}
+
+/*
+ * Write the recorded events in the Chrome trace event format. The
+ * events are copied out first, so the DSP threads are not held up
+ * while the file is written.
+ */
+gint stats_write_trace(const gchar *filename)
+{
+	struct thread_stats *ts;
+	struct event *events, *e;
+	guint i, n, len, first;
+	FILE *fp;
+
+	pthread_mutex_lock(&stats_mutex);
+
+	len = 0;
+	for (ts = threads; ts; ts = ts->next)
+		len += STATS_TRACE_LEN;
+
+	events = g_new(struct event, MAX(len, 1));
+	n = 0;
+
+	for (ts = threads; ts; ts = ts->next) {
+		pthread_mutex_lock(&ts->mutex);
+
+		first = (ts->tracepos + STATS_TRACE_LEN - ts->tracelen) %
+			STATS_TRACE_LEN;
+
+		for (i = 0; i < ts->tracelen; i++)
+			events[n++] = ts->trace[(first + i) % STATS_TRACE_LEN];
+
+		pthread_mutex_unlock(&ts->mutex);
+	}
+
+	pthread_mutex_unlock(&stats_mutex);
+
+	if ((fp = fopen(filename, "w")) == NULL) {
+		g_free(events);
+		return -1;
+	}
+
+	fprintf(fp, "{\"traceEvents\":[\n");
+
+	for (i = 0; i < n; i++) {
+		e = &events[i];
+
+		fprintf(fp, "{\"name\":\"%s\",\"cat\":\"dsp\",\"ph\":\"X\","
+			"\"ts\":%llu,\"dur\":%u,\"pid\":1,\"tid\":%u}%s\n",
+			stats_stage_names[e->stage],
+			(unsigned long long) e->start,
+			e->dur,
+			e->tid,
+			(i + 1 < n) ? "," : "");
+	}
+
+	fprintf(fp, "],\"displayTimeUnit\":\"ms\"}\n");
+
+	g_free(events);
+
+	if (fclose(fp) != 0)
+		return -1;
+
+	return 0;
+}
+
+/* ---------------------------------------------------------------------- */
@@ -0,0 +1,73 @@
+/*
+ *    stats.h  --  DSP timing statistics
+ *
+ *    Copyright (C) 2005
+ *      Tomi Manninen (oh2bns@sral.fi)
+ *
+ *    This file is part of gMFSK.
+ *
+ *    gMFSK is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    gMFSK is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with gMFSK; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef _STATS_H
+#define _STATS_H
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ---------------------------------------------------------------------- */
+
+typedef enum {
+	STATS_SOUND_READ = 0,
+	STATS_SOUND_WRITE,
+	STATS_RESAMPLE,
+	STATS_WATERFALL,
+	STATS_RXPROCESS,
+	STATS_TXPROCESS,
+	STATS_MAIN_LOOP,
+	STATS_NUM_STAGES
+} stats_stage_t;
+
+extern char *stats_stage_names[];
+
+/* ---------------------------------------------------------------------- */
+
+extern void stats_enable(gboolean on);
+extern gboolean stats_enabled(void);
+
+extern guint64 stats_time(void);
+extern guint64 stats_waited(void);
+extern void stats_wait(guint64 start);
+
+extern void stats_add(stats_stage_t stage, guint64 start,
+		      gint samples, gint samplerate);
+extern void stats_xrun(stats_stage_t stage);
+
+extern void stats_reset(void);
+
+extern gchar *stats_report(gboolean histograms);
+extern gint stats_write_trace(const gchar *filename);
+
+/* ---------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
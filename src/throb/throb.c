@@ -28,10 +28,11 @@
 #include "trx.h"
 #include "throb.h"
 #include "filter.h"
+#include "hilbert.h"
 #include "fft.h"
 #include "tab.h"
 #include "misc.h"
-#include "fftfilt.h"
+#include "firfilt.h"
 
 static void throb_txinit(struct trx *trx)
 {
@@ -46,9 +47,10 @@ static void throb_rxinit(struct trx *trx)
 	s->rxcntr = s->rxsymlen;
 
 	s->waitsync = 1;
-	s->deccntr = 0;
 	s->symptr = 0;
 	s->shift = 0;
+
+	nco_init(&s->rxnco, 0.0);
 }
 
 static void throb_free(struct throb *s)
@@ -58,12 +60,18 @@ static void throb_free(struct throb *s)
 	if (s) {
 		g_free(s->txpulse);
 
-		filter_free(s->hilbert);
+		hilbert_free(s->hilbert);
 		filter_free(s->syncfilt);
-		fftfilt_free(s->fftfilt);
+		firfilt_free(s->filt);
 
-		for (i = 0; i < NumTones; i++)
-			g_free(s->rxtone[i]);
+		mirror_free(s->symrmirror);
+		mirror_free(s->symimirror);
+		mirror_free(s->syncmirror);
+
+		for (i = 0; i < NumTones; i++) {
+			g_free(s->rxtoner[i]);
+			g_free(s->rxtonei[i]);
+		}
 
 		g_free(s);
 	}
@@ -129,21 +137,20 @@ static float *mk_full_pulse(int len)
 /*
  * Make a 32 times downsampled complex prototype tone for rx.
  */
-static complex *mk_rxtone(double freq, float *pulse, int len)
+static void mk_rxtone(double freq, float *pulse, int len,
+		      double **re, double **im)
 {
-	complex *tone;
 	double x;
 	int i;
 
-	tone = g_new0(complex, len / DownSample);
+	*re = g_new0(double, len / DownSample);
+	*im = g_new0(double, len / DownSample);
 
 	for (i = 0; i < len; i += DownSample) {
 		x = -2.0 * M_PI * freq * i / SampleRate;
-		c_re(tone[i / DownSample]) = pulse[i] * cos(x);
-		c_im(tone[i / DownSample]) = pulse[i] * sin(x);
+		(*re)[i / DownSample] = pulse[i] * cos(x);
+		(*im)[i / DownSample] = pulse[i] * sin(x);
 	}
-
-	return tone;
 }
 
 void throb_init(struct trx *trx)
@@ -190,12 +197,23 @@ void throb_init(struct trx *trx)
 
 	s->rxsymlen = s->symlen / DownSample;
 
-	if ((s->hilbert = filter_init_hilbert(37, 1)) == NULL) {
+	s->symrmirror = mirror_new(s->rxsymlen * sizeof(double));
+	s->symimirror = mirror_new(s->rxsymlen * sizeof(double));
+	s->syncmirror = mirror_new(s->rxsymlen * sizeof(float));
+
+	s->symr = (double *) s->symrmirror->data;
+	s->symi = (double *) s->symimirror->data;
+	s->syncbuf = (float *) s->syncmirror->data;
+
+	s->symmask = s->symrmirror->size / sizeof(double) - 1;
+	s->syncmask = s->syncmirror->size / sizeof(float) - 1;
+
+	if ((s->hilbert = hilbert_init(37)) == NULL) {
 		throb_free(s);
 		return;
 	}
 
-	if ((s->fftfilt = fftfilt_init(0, bw, FilterFFTLen)) == NULL) {
+	if ((s->filt = firfilt_init(0, bw, FilterLen, DownSample)) == NULL) {
 		throb_free(s);
 		return;
 	}
@@ -205,14 +223,9 @@ void throb_init(struct trx *trx)
 		return;
 	}
 
-	for (i = 0; i < NumTones; i++) {
-		s->rxtone[i] = mk_rxtone(s->freqs[i], s->txpulse, s->symlen);
-
-		if (!s->rxtone[i]) {
-			throb_free(s);
-			return;
-		}
-	}
+	for (i = 0; i < NumTones; i++)
+		mk_rxtone(s->freqs[i], s->txpulse, s->symlen,
+			  &s->rxtoner[i], &s->rxtonei[i]);
 
 	trx->modem = s;
 
@@ -26,6 +26,8 @@
 #define _THROB_H
 
 #include "cmplx.h"
+#include "nco.h"
+#include "mirror.h"
 #include "trx.h"
 
 #define	SampleRate	8000
@@ -40,34 +42,43 @@
 
 #define	MaxRxSymLen	(SymbolLen1 / DownSample)
 
-#define	FilterFFTLen	8192
+#define	FilterLen	4097
 
 struct throb {
 	/*
 	 * Common stuff
 	 */
 	int symlen;
-	double phaseacc;
+	struct nco rxnco;
 	double freqs[NumTones];
 
 	/*
 	 * RX related stuff
 	 */
-	struct filter *hilbert;
-	struct fftfilt *fftfilt;
+	struct hilbert *hilbert;
+	struct firfilt *filt;
 	struct filter *syncfilt;
 
-	complex *rxtone[NumTones];
-	complex symbol[MaxRxSymLen];
+	/* real and imaginary parts of the tones */
+	double *rxtoner[NumTones];
+	double *rxtonei[NumTones];
+
+	/* rings in mirrored memory, indexed by symptr & mask */
+	struct mirror *symrmirror;
+	struct mirror *symimirror;
+	struct mirror *syncmirror;
+	double *symr;
+	double *symi;
+	float *syncbuf;
+	int symmask;
+	int syncmask;
 
-	float syncbuf[MaxRxSymLen];
 	float dispbuf[MaxRxSymLen];
 
 	float rxcntr;
 
 	int rxsymlen;
-	int symptr;
-	int deccntr;
+	unsigned int symptr;
 	int shift;
 	int waitsync;
 
@@ -29,34 +29,13 @@
 #include "throb.h"
 #include "tab.h"
 #include "filter.h"
+#include "hilbert.h"
 #include "misc.h"
 #include "fft.h"
-#include "fftfilt.h"
+#include "firfilt.h"
+#include "cvec.h"
 
-static inline complex mixer(struct trx *trx, complex in)
-{
-	struct throb *s = (struct throb *) trx->modem;
-	complex z;
-	float f;
-
-	c_re(z) = cos(s->phaseacc);
-	c_im(z) = sin(s->phaseacc);
-
-	z = cmul(z, in);
-
-	f = trx->frequency;
-
-	s->phaseacc -= 2.0 * M_PI * f / SampleRate;
-
-	if (s->phaseacc < -M_PI)
-		s->phaseacc += 2.0 * M_PI;
-	if (s->phaseacc >  M_PI)
-		s->phaseacc -= 2.0 * M_PI;
-
-	return z;
-}
-
-static int findtones(complex *word, int *tone1, int *tone2)
+static int findtones(double *mag, int *tone1, int *tone2)
 {
 	double max1, max2;
 	int maxtone, i;
@@ -64,8 +43,8 @@ static int findtones(complex *word, int *tone1, int *tone2)
 	max1 = 0;
 	*tone1 = 0;
 	for (i = 0; i < NumTones; i++) {
-		if (cmod(word[i]) > max1) {
-			max1 = cmod(word[i]);
+		if (mag[i] > max1) {
+			max1 = mag[i];
 			*tone1 = i;
 		}
 	}
@@ -77,8 +56,8 @@ static int findtones(complex *word, int *tone1, int *tone2)
 	for (i = 0; i < NumTones; i++) {
 		if (i == *tone1)
 			continue;
-		if (cmod(word[i]) > max2) {
-			max2 = cmod(word[i]);
+		if (mag[i] > max2) {
+			max2 = mag[i];
 			*tone2 = i;
 		}
 	}
@@ -137,21 +116,39 @@ static void throb_rx(struct trx *trx, complex in)
 {
 	struct throb *s = (struct throb *) trx->modem;
 	complex rxword[NumTones];
+	double wordr[NumTones], wordi[NumTones], mag[NumTones];
+	double *wr, *wi;
+	unsigned int p;
 	int i, tone1, tone2, maxtone;
 
 	/* store input */
-	s->symbol[s->symptr] = in;
+	p = s->symptr & s->symmask;
+	s->symr[p] = c_re(in);
+	s->symi[p] = c_im(in);
+	mirror_sync(s->symrmirror, p * sizeof(double), sizeof(double));
+	mirror_sync(s->symimirror, p * sizeof(double), sizeof(double));
 
 	/* check counter */
 	if (s->rxcntr > 0.0)
 		return;
 
+	/* the last symbol, oldest sample first */
+	p = (s->symptr + 1 - s->rxsymlen) & s->symmask;
+	wr = s->symr + p;
+	wi = s->symi + p;
+
 	/* correlate against all tones */
-	for (i = 0; i < NumTones; i++)
-		rxword[i] = cmac(s->rxtone[i], s->symbol, s->symptr + 1, s->rxsymlen);
+	for (i = 0; i < NumTones; i++) {
+		rxword[i] = cvec_dot(s->rxtoner[i], s->rxtonei[i],
+				     wr, wi, s->rxsymlen);
+		wordr[i] = c_re(rxword[i]);
+		wordi[i] = c_im(rxword[i]);
+	}
+
+	cvec_mag(wordr, wordi, mag, NumTones);
 
 	/* find the strongest tones */
-	maxtone = findtones(rxword, &tone1, &tone2);
+	maxtone = findtones(mag, &tone1, &tone2);
 
 	/* decode */
 	decodechar(trx, tone1, tone2);
@@ -161,7 +158,15 @@ static void throb_rx(struct trx *trx, complex in)
 		double f;
 
 		z1 = rxword[maxtone];
-		z2 = cmac(s->rxtone[maxtone], s->symbol, s->symptr + 2, s->rxsymlen);
+
+		/* one sample on, wrapping round to the oldest one */
+		i = s->rxsymlen - 1;
+		z2 = cvec_dot(s->rxtoner[maxtone], s->rxtonei[maxtone],
+			      wr + 1, wi + 1, i);
+		c_re(z2) += s->rxtoner[maxtone][i] * wr[0] -
+			    s->rxtonei[maxtone][i] * wi[0];
+		c_im(z2) += s->rxtoner[maxtone][i] * wi[0] +
+			    s->rxtonei[maxtone][i] * wr[0];
 
 		f = carg(ccor(z1, z2)) / (2 * DownSample * M_PI / SampleRate);
 		f -= s->freqs[maxtone];
@@ -182,16 +187,17 @@ static void throb_sync(struct trx *trx, complex in)
 
 	/* "rectify", filter and store input */
 	filter_I_run(s->syncfilt, cmod(in), &f);
-	s->syncbuf[s->symptr] = f;
+	s->syncbuf[s->symptr & s->syncmask] = f;
+	mirror_sync(s->syncmirror, (s->symptr & s->syncmask) * sizeof(float),
+		    sizeof(float));
 
 	/* check counter if we are waiting for sync */
 	if (s->waitsync == 0 || s->rxcntr > (s->rxsymlen / 2.0))
 		return;
 
-	for (i = 0; i < s->rxsymlen; i++) {
-		f = s->syncbuf[(i + s->symptr + 1) % s->rxsymlen];
-		s->dispbuf[i] = f;
-	}
+	memcpy(s->dispbuf,
+	       s->syncbuf + ((s->symptr + 1 - s->rxsymlen) & s->syncmask),
+	       s->rxsymlen * sizeof(float));
 
 	for (i = 0; i < s->rxsymlen; i++) {
 		if (s->dispbuf[i] > maxval) {
@@ -210,35 +216,36 @@ static void throb_sync(struct trx *trx, complex in)
 int throb_rxprocess(struct trx *trx, float *buf, int len)
 {
 	struct throb *s = (struct throb *) trx->modem;
-	complex z, *zp;
-	int i, n;
+	complex zbuf[FILTER_BLOCKLEN], *zp;
+	int num, i, n;
+
+	while (len > 0) {
+		num = MIN(len, FILTER_BLOCKLEN);
 
-	while (len-- > 0) {
 		/* create analytic signal */
-		c_re(z) = c_im(z) = *buf++;
+		hilbert_run(s->hilbert, buf, num, zbuf);
 
-		filter_run(s->hilbert, z, &z);
+		buf += num;
+		len -= num;
 
 		/* shift down to 0 +- 32 (64) Hz */
-		z = mixer(trx, z);
+		nco_set_freq(&s->rxnco, -trx->frequency / SampleRate);
+		nco_mix(&s->rxnco, zbuf, zbuf, num);
 
-		/* low pass filter */
-		n = fftfilt_run(s->fftfilt, z, &zp);
+		/* low pass filter and downsample by 32 */
+		n = firfilt_run_block(s->filt, zbuf, num, &zp);
 
-		/* downsample by 32 and push to the receiver */
+		/* push to the receiver */
 		for (i = 0; i < n; i++) {
-			if (++s->deccntr >= DownSample) {
-				s->rxcntr -= 1.0;
+			s->rxcntr -= 1.0;
 
-				/* do symbol sync */
-				throb_sync(trx, zp[i]);
+			/* do symbol sync */
+			throb_sync(trx, zp[i]);
 
-				/* decode */
-				throb_rx(trx, zp[i]);
+			/* decode */
+			throb_rx(trx, zp[i]);
 
-				s->symptr = (s->symptr + 1) % s->rxsymlen;
-				s->deccntr = 0;
-			}
+			s->symptr++;
 		}
 	}
 
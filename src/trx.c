@@ -28,6 +28,7 @@
 
 #include <gnome.h>
 #include <pthread.h>
+#include <sched.h>
 
 #include "main.h"
 #include "trx.h"
@@ -35,6 +36,9 @@
 #include "ptt.h"
 #include "misc.h"
 #include "picture.h"
+#include "chanbank.h"
+#include "ringbuf.h"
+#include "stats.h"
 
 #include "waterfall.h"
 #include "miniscope.h"
@@ -43,43 +47,6 @@
 
 #define	TRX_DEBUG	0
 
-extern void mfsk_init(struct trx *trx);
-extern void olivia_init(struct trx *trx);
-extern void rtty_init(struct trx *trx);
-extern void throb_init(struct trx *trx);
-extern void psk31_init(struct trx *trx);
-extern void mt63_init(struct trx *trx);
-extern void feld_init(struct trx *trx);
-extern void cw_init(struct trx *trx);
-
-/* ---------------------------------------------------------------------- */
-
-char *trx_mode_names[] = {
-	"MFSK16",
-	"MFSK8",
-	"OLIVIA",
-	"RTTY",
-	"THROB1",
-	"THROB2",
-	"THROB4",
-	"BPSK31",
-	"QPSK31",
-	"PSK63",
-	"MT63",
-	"FELDHELL",
-	"FMHELL",
-	"CW"
-};
-
-char *trx_state_names[] = {
-	"PAUSED",
-	"RECEIVE",
-	"TRANSMIT",
-	"TUNING",
-	"ABORTED",
-	"FLUSHING"
-};
-
 /* ---------------------------------------------------------------------- */
 
 static pthread_mutex_t trx_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -91,9 +58,350 @@ static struct trx trx;
 
 #define BLOCKLEN	512
 
-static void receive_loop(void)
+/*
+ * The sound card is read by a separate capture thread into a ring
+ * buffer. That way a slow DSP block only eats into the ring instead
+ * of making the sound card overrun.
+ */
+#define	CAPTURE_RING_SIZE	(32 * BLOCKLEN)
+
+static struct ringbuf *capture_ring = NULL;
+static pthread_t capture_thread;
+static pthread_mutex_t capture_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t capture_cond = PTHREAD_COND_INITIALIZER;
+static gboolean capture_quit = FALSE;
+static gboolean capture_error = FALSE;
+
+static volatile gint capture_highwater = 0;
+static volatile gint capture_overruns = 0;
+
+static void *capture_loop(void *args)
 {
+	struct sched_param param;
 	gfloat *buf;
+	gint len, fill;
+
+	/* this needs privileges, so just try */
+	param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+	pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+
+	for (;;) {
+		pthread_mutex_lock(&capture_mutex);
+
+		if (capture_quit) {
+			pthread_mutex_unlock(&capture_mutex);
+			break;
+		}
+
+		pthread_mutex_unlock(&capture_mutex);
+
+		len = BLOCKLEN;
+
+		if (sound_read(&buf, &len) < 0) {
+			pthread_mutex_lock(&capture_mutex);
+			capture_error = TRUE;
+			pthread_cond_signal(&capture_cond);
+			pthread_mutex_unlock(&capture_mutex);
+			break;
+		}
+
+		if ((gint) ringbuf_write(capture_ring, buf, len) < len) {
+			g_atomic_int_inc(&capture_overruns);
+			stats_xrun(STATS_SOUND_READ);
+		}
+
+		fill = ringbuf_read_space(capture_ring);
+
+		if (fill > capture_highwater)
+			capture_highwater = fill;
+
+		pthread_mutex_lock(&capture_mutex);
+		pthread_cond_signal(&capture_cond);
+		pthread_mutex_unlock(&capture_mutex);
+	}
+
+	return NULL;
+}
+
+static gint capture_start(void)
+{
+	if (capture_ring == NULL)
+		capture_ring = ringbuf_new(sizeof(gfloat), CAPTURE_RING_SIZE);
+
+	ringbuf_reset(capture_ring);
+
+	capture_quit = FALSE;
+	capture_error = FALSE;
+	capture_highwater = 0;
+
+	if (pthread_create(&capture_thread, NULL, capture_loop, NULL) != 0)
+		return -1;
+
+	return 0;
+}
+
+static void capture_stop(void)
+{
+	pthread_mutex_lock(&capture_mutex);
+	capture_quit = TRUE;
+	pthread_mutex_unlock(&capture_mutex);
+
+	pthread_join(capture_thread, NULL);
+}
+
+/*
+ * Wait until a full block is available in the capture ring. Returns
+ * FALSE if the capture thread has failed.
+ */
+static gboolean capture_wait(void)
+{
+	gboolean ret = TRUE;
+
+	pthread_mutex_lock(&capture_mutex);
+
+	while (ringbuf_read_space(capture_ring) < BLOCKLEN) {
+		if (capture_error) {
+			ret = FALSE;
+			break;
+		}
+
+		pthread_cond_wait(&capture_cond, &capture_mutex);
+	}
+
+	pthread_mutex_unlock(&capture_mutex);
+
+	return ret;
+}
+
+void trx_get_capture_stats(gint *fill, gint *highwater, gint *overruns)
+{
+	*fill = capture_ring ? ringbuf_read_space(capture_ring) : 0;
+	*highwater = capture_highwater;
+	*overruns = g_atomic_int_get(&capture_overruns);
+}
+
+/* ---------------------------------------------------------------------- */
+
+/*
+ * Modem instances that are not in use are kept in a cache, one per
+ * mode, so that switching modes while receiving does not have to
+ * rebuild the filters, FFT plans and decoder tables every time. The
+ * cache is only ever touched from the GUI thread; the trx thread just
+ * swaps the prepared instance in at the next block boundary.
+ */
+#define	MODE_CACHE_SIZE		(MODE_CW + 1)
+
+struct modem_slot {
+	void *modem;
+
+	gint samplerate;
+	gint fragmentsize;
+	gfloat bandwidth;
+	gfloat frequency;
+	gboolean setfreq;
+
+	void (*txinit) (struct trx *trx);
+	void (*rxinit) (struct trx *trx);
+
+	gint (*txprocess) (struct trx *trx);
+	gint (*rxprocess) (struct trx *trx, gfloat *buf, gint len);
+
+	void (*destructor) (struct trx *trx);
+};
+
+static struct modem_slot modem_cache[MODE_CACHE_SIZE];
+
+/* scratch trx for building and destroying instances off the main trx */
+static struct trx modem_scratch;
+
+static struct modem_slot *switch_pending = NULL;
+static trx_mode_t switch_mode;
+static struct modem_slot switch_old;
+static pthread_cond_t switch_cond = PTHREAD_COND_INITIALIZER;
+
+static void slot_load(struct trx *t, struct modem_slot *slot)
+{
+	t->modem = slot->modem;
+	t->samplerate = slot->samplerate;
+	t->fragmentsize = slot->fragmentsize;
+	t->bandwidth = slot->bandwidth;
+
+	if (slot->setfreq)
+		t->frequency = slot->frequency;
+
+	t->txinit = slot->txinit;
+	t->rxinit = slot->rxinit;
+	t->txprocess = slot->txprocess;
+	t->rxprocess = slot->rxprocess;
+	t->destructor = slot->destructor;
+}
+
+static void slot_save(struct modem_slot *slot, struct trx *t)
+{
+	slot->modem = t->modem;
+	slot->samplerate = t->samplerate;
+	slot->fragmentsize = t->fragmentsize;
+	slot->bandwidth = t->bandwidth;
+	slot->frequency = t->frequency;
+	slot->setfreq = FALSE;
+
+	slot->txinit = t->txinit;
+	slot->rxinit = t->rxinit;
+	slot->txprocess = t->txprocess;
+	slot->rxprocess = t->rxprocess;
+	slot->destructor = t->destructor;
+}
+
+static void slot_destroy(struct modem_slot *slot)
+{
+	if (slot->modem == NULL)
+		return;
+
+	modem_scratch.modem = slot->modem;
+	modem_scratch.destructor = slot->destructor;
+	modem_scratch.destructor(&modem_scratch);
+
+	memset(slot, 0, sizeof(struct modem_slot));
+}
+
+/*
+ * Build a new instance for 'mode' with the current parameters.
+ */
+static gint slot_build(struct modem_slot *slot, trx_mode_t mode)
+{
+	gfloat freq;
+
+	trx_copy_parms(&modem_scratch);
+	modem_scratch.mode = mode;
+
+	freq = modem_scratch.frequency;
+
+	if (trx_modem_init(&modem_scratch) < 0)
+		return -1;
+
+	slot_save(slot, &modem_scratch);
+
+	/* some modems (Olivia, MT63) pick their own frequency */
+	slot->setfreq = (modem_scratch.frequency != freq);
+
+	return 0;
+}
+
+/*
+ * Drop the cached instances of the given modes. Called whenever their
+ * parameters change so that the next switch builds a fresh one.
+ */
+static void modem_cache_invalidate(trx_mode_t first, trx_mode_t last)
+{
+	gint i;
+
+	for (i = first; i <= last; i++)
+		slot_destroy(&modem_cache[i]);
+}
+
+static void restart_mode(trx_mode_t mode)
+{
+	gint state = trx_get_state();
+
+	trx_set_state_wait(TRX_STATE_ABORT);
+	trx_set_mode(mode);
+	trx_set_state_wait(state);
+}
+
+/*
+ * Switch modes. While receiving this keeps the trx thread, the capture
+ * thread and the sound device running and only swaps the modem
+ * instance between two blocks. Otherwise (transmitting, paused) it
+ * falls back to tearing down and restarting the trx.
+ */
+void trx_switch_mode(trx_mode_t mode)
+{
+	struct modem_slot slot;
+	trx_mode_t oldmode;
+
+	pthread_mutex_lock(&trx_mutex);
+
+	if (trx.mode == mode) {
+		pthread_mutex_unlock(&trx_mutex);
+		return;
+	}
+
+	if (trx.state != TRX_STATE_RX || trx.modem == NULL) {
+		pthread_mutex_unlock(&trx_mutex);
+		restart_mode(mode);
+		return;
+	}
+
+	oldmode = trx.mode;
+
+	pthread_mutex_unlock(&trx_mutex);
+
+	if (modem_cache[mode].modem) {
+		slot = modem_cache[mode];
+		memset(&modem_cache[mode], 0, sizeof(struct modem_slot));
+	} else if (slot_build(&slot, mode) < 0) {
+		restart_mode(mode);
+		return;
+	}
+
+	pthread_mutex_lock(&trx_mutex);
+
+	/* a different sample rate needs the sound device reopened */
+	if (slot.samplerate != trx.samplerate) {
+		pthread_mutex_unlock(&trx_mutex);
+		modem_cache[mode] = slot;
+		restart_mode(mode);
+		return;
+	}
+
+	switch_mode = mode;
+	switch_pending = &slot;
+
+	while (switch_pending && trx.state == TRX_STATE_RX && trx.modem)
+		pthread_cond_wait(&switch_cond, &trx_mutex);
+
+	if (switch_pending) {
+		/* the trx stopped before picking the new modem up */
+		switch_pending = NULL;
+		pthread_mutex_unlock(&trx_mutex);
+
+		modem_cache[mode] = slot;
+		restart_mode(mode);
+		return;
+	}
+
+	pthread_mutex_unlock(&trx_mutex);
+
+	slot_destroy(&modem_cache[oldmode]);
+	modem_cache[oldmode] = switch_old;
+}
+
+/*
+ * Called by the trx thread with trx_mutex held, between two blocks.
+ */
+static gboolean switch_apply(void)
+{
+	if (switch_pending == NULL)
+		return FALSE;
+
+	slot_save(&switch_old, &trx);
+	slot_load(&trx, switch_pending);
+	trx.mode = switch_mode;
+	trx.metric = 0.0;
+
+	switch_pending = NULL;
+	pthread_cond_signal(&switch_cond);
+
+	return TRUE;
+}
+
+/* ---------------------------------------------------------------------- */
+
+static void receive_loop(void)
+{
+	gfloat buf[BLOCKLEN];
+	gboolean switched;
+	guint64 t;
 	gint len;
 
 	if (sound_open_for_read(trx.samplerate) < 0) {
@@ -105,6 +413,13 @@ static void receive_loop(void)
 	trx.rxinit(&trx);
 	statusbar_set_trxstate(TRX_STATE_RX);
 
+	if (capture_start() < 0) {
+		errmsg(_("Failed to start the capture thread"));
+		trx_set_state(TRX_STATE_ABORT);
+		sound_close();
+		return;
+	}
+
 	for (;;) {
 		pthread_mutex_lock(&trx_mutex);
 
@@ -113,26 +428,48 @@ static void receive_loop(void)
 			break;
 		}
 
+		switched = switch_apply();
+
 		pthread_mutex_unlock(&trx_mutex);
 
-		len = BLOCKLEN;
+		if (switched)
+			trx.rxinit(&trx);
 
-		if (sound_read(&buf, &len) < 0) {
+		if (capture_wait() == FALSE) {
 			errmsg(_("%s"), sound_error());
 			trx_set_state(TRX_STATE_ABORT);
 			break;
 		}
 
+		len = ringbuf_read(capture_ring, buf, BLOCKLEN);
+
+		t = stats_time();
 		waterfall_set_data(waterfall, buf, len);
+		stats_add(STATS_WATERFALL, t, len, trx.samplerate);
+
+		t = stats_time();
 		trx.rxprocess(&trx, buf, len);
+		stats_add(STATS_RXPROCESS, t, len, trx.samplerate);
+
+		/* the extra receive channels share the same block */
+		chanbank_process(buf, len);
 	}
 
+	capture_stop();
 	sound_close();
 }
 
+/* characters the GUI still has to queue, see trx_tx_set_backlog() */
+static volatile gint tx_backlog = 0;
+
+static void tx_queue_start(void);
+static void tx_queue_stop(void);
+
 static void transmit_loop(void)
 {
 	gfloat f = 0.0;
+	guint64 t, w;
+	gint ret;
 
 	if (sound_open_for_write(trx.samplerate) < 0) {
 		errmsg(_("sound_open_for_write: %s"), sound_error());
@@ -144,6 +481,8 @@ static void transmit_loop(void)
 	trx_set_phase(0.0, FALSE);
 	trx.metric = 0.0;
 
+	tx_queue_start();
+
 	trx.txinit(&trx);
 	ptt_set(1);
 
@@ -155,9 +494,10 @@ static void transmit_loop(void)
 			break;
 		}
 
+		/* not before the GUI has handed over all the text */
 		if (trx.state == TRX_STATE_RX || trx.state == TRX_STATE_PAUSE) {
 			statusbar_set_trxstate(TRX_STATE_FLUSH);
-			trx.stopflag = 1;
+			trx.stopflag = (g_atomic_int_get(&tx_backlog) == 0);
 		}
 
 		if (trx.state == TRX_STATE_TUNE) {
@@ -171,7 +511,14 @@ static void transmit_loop(void)
 
 		pthread_mutex_unlock(&trx_mutex);
 
-		if (trx.txprocess(&trx) < 0)
+		/* leave the blocking sound writes out of the modem time */
+		w = stats_waited();
+		t = stats_time();
+		ret = trx.txprocess(&trx);
+		if (t)
+			stats_add(STATS_TXPROCESS, t + stats_waited() - w, 0, 0);
+
+		if (ret < 0)
 			break;
 	}
 
@@ -187,6 +534,8 @@ static void transmit_loop(void)
 	trx.tune = 0;
 	pthread_mutex_unlock(&trx_mutex);
 
+	tx_queue_stop();
+
 	clear_tx_text();
 }
 
@@ -244,6 +593,32 @@ static void *trx_loop(void *args)
 
 /* ---------------------------------------------------------------------- */
 
+/*
+ * Copy the current modem parameters into 't' so that a new modem
+ * instance can be built with the same settings as the main trx.
+ */
+void trx_copy_parms(struct trx *t)
+{
+	pthread_mutex_lock(&trx_mutex);
+	memcpy(t, &trx, sizeof(struct trx));
+	pthread_mutex_unlock(&trx_mutex);
+
+	t->state = TRX_STATE_PAUSE;
+	t->metric = 0.0;
+	t->stopflag = 0;
+	t->tune = 0;
+	t->backspaces = 0;
+	t->txstr = NULL;
+	t->txptr = NULL;
+
+	t->modem = NULL;
+	t->txinit = NULL;
+	t->rxinit = NULL;
+	t->txprocess = NULL;
+	t->rxprocess = NULL;
+	t->destructor = NULL;
+}
+
 gint trx_init(void)
 {
 	pthread_mutex_lock(&trx_mutex);
@@ -253,47 +628,7 @@ gint trx_init(void)
 		return -1;
 	}
 
-	switch (trx.mode) {
-	case MODE_MFSK16:
-	case MODE_MFSK8:
-		mfsk_init(&trx);
-		break;
-
-	case MODE_OLIVIA:
-		olivia_init(&trx);
-		break;
-
-	case MODE_RTTY:
-		rtty_init(&trx);
-		break;
-
-	case MODE_THROB1:
-	case MODE_THROB2:
-	case MODE_THROB4:
-		throb_init(&trx);
-		break;
-
-	case MODE_BPSK31:
-	case MODE_QPSK31:
-	case MODE_PSK63:
-		psk31_init(&trx);
-		break;
-
-	case MODE_MT63:
-		mt63_init(&trx);
-		break;
-
-	case MODE_FELDHELL:
-	case MODE_FMHELL:
-		feld_init(&trx);
-		break;
-
-	case MODE_CW:
-		cw_init(&trx);
-		break;
-	}
-
-	if (trx.modem == NULL) {
+	if (trx_modem_init(&trx) < 0) {
 		errmsg(_("Modem initialization failed!"));
 		pthread_mutex_unlock(&trx_mutex);
 		return -1;
@@ -399,9 +734,20 @@ trx_state_t trx_get_state(void)
 	return trx.state;
 }
 
+/*
+ * The modems report frequency and metric through these. When called
+ * from a channel bank worker they apply to that channel instead.
+ */
+static inline struct trx *trx_current(void)
+{
+	struct trx *t = chanbank_get_current();
+
+	return t ? t : &trx;
+}
+
 void trx_set_freq(gfloat freq)
 {
-	trx.frequency = freq;
+	trx_current()->frequency = freq;
 }
 
 gfloat trx_get_freq(void)
@@ -431,7 +777,7 @@ void trx_set_reverse(gboolean on)
 
 void trx_set_metric(gfloat metric)
 {
-	trx.metric = metric;
+	trx_current()->metric = metric;
 }
 
 gfloat trx_get_metric(void)
@@ -473,6 +819,8 @@ gfloat trx_get_txoffset(void)
 void trx_set_mfsk_parms(gfloat squelch)
 {
 	trx.mfsk_squelch = squelch;
+
+	modem_cache_invalidate(MODE_MFSK16, MODE_MFSK8);
 }
 
 void trx_set_olivia_parms(gfloat squelch,
@@ -486,6 +834,8 @@ void trx_set_olivia_parms(gfloat squelch,
 	trx.olivia_smargin = smargin;
 	trx.olivia_sinteg = sinteg;
 	trx.olivia_esc = esc;
+
+	modem_cache_invalidate(MODE_OLIVIA, MODE_OLIVIA);
 }
 
 void trx_set_rtty_parms(gfloat squelch, gfloat shift, gfloat baud,
@@ -499,16 +849,22 @@ void trx_set_rtty_parms(gfloat squelch, gfloat shift, gfloat baud,
 	trx.rtty_stop = stop;
 	trx.rtty_reverse = reverse;
 	trx.rtty_msbfirst = msbfirst;
+
+	modem_cache_invalidate(MODE_RTTY, MODE_RTTY);
 }
 
 void trx_set_throb_parms(gfloat squelch)
 {
 	trx.throb_squelch = squelch;
+
+	modem_cache_invalidate(MODE_THROB1, MODE_THROB4);
 }
 
 void trx_set_psk31_parms(gfloat squelch)
 {
 	trx.psk31_squelch = squelch;
+
+	modem_cache_invalidate(MODE_BPSK31, MODE_PSK63);
 }
 
 void trx_set_mt63_parms(gfloat squelch,
@@ -520,6 +876,8 @@ void trx_set_mt63_parms(gfloat squelch,
 	trx.mt63_interleave = interleave;
 	trx.mt63_cwid = cwid;
 	trx.mt63_esc = esc;
+
+	modem_cache_invalidate(MODE_MT63, MODE_MT63);
 }
 
 void trx_set_hell_parms(gchar *font,
@@ -531,6 +889,8 @@ void trx_set_hell_parms(gchar *font,
 	trx.hell_bandwidth = bandwidth;
 	trx.hell_agcattack = agcattack;
 	trx.hell_agcdecay = agcdecay;
+
+	modem_cache_invalidate(MODE_FELDHELL, MODE_FMHELL);
 }
 
 void trx_set_cw_parms(gfloat squelch, gfloat speed, gfloat bandwidth)
@@ -538,23 +898,40 @@ void trx_set_cw_parms(gfloat squelch, gfloat speed, gfloat bandwidth)
 	trx.cw_squelch = squelch;
 	trx.cw_speed = speed;
 	trx.cw_bandwidth = bandwidth;
+
+	modem_cache_invalidate(MODE_CW, MODE_CW);
 }
 
 void trx_set_scope(gfloat *data, gint len, gboolean autoscale)
 {
-	Miniscope *m = MINISCOPE(lookup_widget(appwindow, "miniscope"));
+	Miniscope *m;
+
+	if (chanbank_get_current())
+		return;
+
+	m = MINISCOPE(lookup_widget(appwindow, "miniscope"));
 	miniscope_set_data(m, data, len, autoscale);
 }
 
 void trx_set_phase(gfloat phase, gboolean highlight)
 {
-	Miniscope *m = MINISCOPE(lookup_widget(appwindow, "miniscope"));
+	Miniscope *m;
+
+	if (chanbank_get_current())
+		return;
+
+	m = MINISCOPE(lookup_widget(appwindow, "miniscope"));
 	miniscope_set_phase(m, phase, highlight);
 }
 
 void trx_set_highlight(gboolean highlight)
 {
-	Miniscope *m = MINISCOPE(lookup_widget(appwindow, "miniscope"));
+	Miniscope *m;
+
+	if (chanbank_get_current())
+		return;
+
+	m = MINISCOPE(lookup_widget(appwindow, "miniscope"));
 	miniscope_set_highlight(m, highlight);
 }
 
@@ -565,92 +942,166 @@ gint trx_get_samplerate(void)
 
 /* ---------------------------------------------------------------------- */
 
-static GAsyncQueue *rx_queue 			= NULL;
-static GAsyncQueue *rx_hell_data_queue 		= NULL;
-static GAsyncQueue *rx_picture_data_queue 	= NULL;
-static GAsyncQueue *echo_queue 			= NULL;
+/*
+ * Received and echoed characters and the Hell and picture pixels travel
+ * from the trx thread to the GUI through lock free rings. The trx
+ * thread is the only writer and the GUI main loop the only reader.
+ */
+#define	RX_RING_SIZE		4096
+#define	ECHO_RING_SIZE		4096
+#define	HELL_RING_SIZE		65536
+#define	PICTURE_RING_SIZE	65536
+#define	TX_RING_SIZE		256
+
+static struct ringbuf *rx_ring			= NULL;
+static struct ringbuf *echo_ring		= NULL;
+static struct ringbuf *rx_hell_data_ring	= NULL;
+static struct ringbuf *rx_picture_data_ring	= NULL;
+
+static struct ringbuf *tx_ring			= NULL;
+
 static GAsyncQueue *tx_picture_queue 		= NULL;
 
+static volatile gint rx_pending = 0;
+
 void trx_init_queues(void)
 {
-	rx_queue 		= g_async_queue_new();
-	rx_hell_data_queue 	= g_async_queue_new();
-	rx_picture_data_queue 	= g_async_queue_new();
-	echo_queue 		= g_async_queue_new();
+	rx_ring			= ringbuf_new(sizeof(guint), RX_RING_SIZE);
+	echo_ring		= ringbuf_new(sizeof(guint), ECHO_RING_SIZE);
+	rx_hell_data_ring	= ringbuf_new(sizeof(guchar), HELL_RING_SIZE);
+	rx_picture_data_ring	= ringbuf_new(sizeof(guint), PICTURE_RING_SIZE);
+
+	tx_ring			= ringbuf_new(sizeof(guint), TX_RING_SIZE);
+
 	tx_picture_queue 	= g_async_queue_new();
 }
 
 /*
- * A very ugly hack. You can not g_async_queue_push() a 0 ...
+ * Wake up the GUI main loop, but only once per batch: the flag stays
+ * set until the GUI has called trx_rx_ack() and started to drain.
  */
-static inline gpointer gint_to_pointer(gint data)
+static inline void trx_rx_notify(void)
+{
+	if (g_atomic_int_compare_and_exchange(&rx_pending, 0, 1))
+		g_main_context_wakeup(NULL);
+}
+
+gboolean trx_rx_pending(void)
 {
-	return (data == 0) ? GINT_TO_POINTER(-1) : GINT_TO_POINTER(data);
+	return g_atomic_int_get(&rx_pending) != 0;
 }
 
-static inline gint gpointer_to_int(gpointer data)
+void trx_rx_ack(void)
 {
-	return (GPOINTER_TO_INT(data) == -1) ? 0 : GPOINTER_TO_INT(data);
+	g_atomic_int_compare_and_exchange(&rx_pending, 1, 0);
+}
+
+static inline gint ring_get_one(struct ringbuf *rb)
+{
+	guint c;
+
+	g_return_val_if_fail(rb, -1);
+	return ringbuf_read(rb, &c, 1) ? (gint) c : -1;
 }
 
 void trx_put_rx_char(guint data)
 {
-	g_return_if_fail(rx_queue);
-	g_async_queue_push(rx_queue, gint_to_pointer(data));
+	if (chanbank_put_rx_char(data)) {
+		trx_rx_notify();
+		return;
+	}
+
+	g_return_if_fail(rx_ring);
+	ringbuf_write(rx_ring, &data, 1);
+	trx_rx_notify();
 }
 
 gint trx_get_rx_char(void)
 {
-	gpointer data;
+	return ring_get_one(rx_ring);
+}
 
-	g_return_val_if_fail(rx_queue, -1);
-	data = g_async_queue_try_pop(rx_queue);
-	return data ? gpointer_to_int(data) : -1;
+gint trx_get_rx_chars(guint *buf, gint len)
+{
+	g_return_val_if_fail(rx_ring, 0);
+	return ringbuf_read(rx_ring, buf, len);
 }
 
 void trx_put_rx_data(guint data)
 {
-	g_return_if_fail(rx_hell_data_queue);
-	g_async_queue_push(rx_hell_data_queue, gint_to_pointer(data));
+	guchar c = data;
+
+	trx_put_rx_data_block(&c, 1);
+}
+
+void trx_put_rx_data_block(const guchar *data, gint len)
+{
+	/* papertape data of the extra channels is not displayed */
+	if (chanbank_get_current())
+		return;
+
+	g_return_if_fail(rx_hell_data_ring);
+	ringbuf_write(rx_hell_data_ring, data, len);
+	trx_rx_notify();
 }
 
 gint trx_get_rx_data(void)
 {
-	gpointer data;
+	guchar c;
 
-	g_return_val_if_fail(rx_hell_data_queue, -1);
-	data = g_async_queue_try_pop(rx_hell_data_queue);
-	return data ? gpointer_to_int(data) : -1;
+	g_return_val_if_fail(rx_hell_data_ring, -1);
+	return ringbuf_read(rx_hell_data_ring, &c, 1) ? c : -1;
+}
+
+gint trx_get_rx_data_block(guchar *buf, gint len)
+{
+	g_return_val_if_fail(rx_hell_data_ring, 0);
+	return ringbuf_read(rx_hell_data_ring, buf, len);
 }
 
 void trx_put_rx_picdata(guint data)
 {
-	g_return_if_fail(rx_picture_data_queue);
-	g_async_queue_push(rx_picture_data_queue, gint_to_pointer(data));
+	trx_put_rx_picdata_block(&data, 1);
+}
+
+void trx_put_rx_picdata_block(const guint *data, gint len)
+{
+	/* neither are the pictures */
+	if (chanbank_get_current())
+		return;
+
+	g_return_if_fail(rx_picture_data_ring);
+	ringbuf_write(rx_picture_data_ring, data, len);
+	trx_rx_notify();
 }
 
 gint trx_get_rx_picdata(void)
 {
-	gpointer data;
+	return ring_get_one(rx_picture_data_ring);
+}
 
-	g_return_val_if_fail(rx_picture_data_queue, -1);
-	data = g_async_queue_try_pop(rx_picture_data_queue);
-	return data ? gpointer_to_int(data) : -1;
+gint trx_get_rx_picdata_block(guint *buf, gint len)
+{
+	g_return_val_if_fail(rx_picture_data_ring, 0);
+	return ringbuf_read(rx_picture_data_ring, buf, len);
 }
 
 void trx_put_echo_char(guint data)
 {
-	g_return_if_fail(echo_queue);
-	g_async_queue_push(echo_queue, gint_to_pointer(data));
+	g_return_if_fail(echo_ring);
+	ringbuf_write(echo_ring, &data, 1);
+	trx_rx_notify();
 }
 
 gint trx_get_echo_char(void)
 {
-	gpointer data;
+	return ring_get_one(echo_ring);
+}
 
-	g_return_val_if_fail(echo_queue, -1);
-	data = g_async_queue_try_pop(echo_queue);
-	return data ? gpointer_to_int(data) : -1;
+gint trx_get_echo_chars(guint *buf, gint len)
+{
+	g_return_val_if_fail(echo_ring, 0);
+	return ringbuf_read(echo_ring, buf, len);
 }
 
 void trx_put_tx_picture(gpointer picbuf)
@@ -668,121 +1119,199 @@ gpointer trx_get_tx_picture(void)
 
 /* ---------------------------------------------------------------------- */
 
-void trx_queue_backspace(void)
+/*
+ * Characters to transmit go the other way through a ring of their own.
+ * The GUI moves typed text into it and the modems drain it, so the TX
+ * thread never has to look at the text widgets. Only a few characters
+ * are handed over at a time and the TX thread wakes the GUI up as it
+ * takes them.
+ *
+ * The characters stay editable in the GUI until the modem has taken
+ * them. For that the TX thread counts the characters taken in tx_state,
+ * together with an epoch that every queued character is tagged with.
+ * Bumping the epoch takes back everything still in the ring in one
+ * atomic step: the TX thread skips characters of an old epoch, and the
+ * count at the bump tells the GUI exactly which characters went out.
+ */
+#define	TX_QUEUE_DEPTH		8
+
+#define	TX_SENT_MASK		0xFFFFFF
+#define	TX_EPOCH_SHIFT		24
+
+static volatile gint tx_pending = 0;
+static volatile gint tx_active = 0;
+static volatile gint tx_state = 0;
+
+static void tx_queue_flush(void)
+{
+	ringbuf_read_commit(tx_ring, ringbuf_read_space(tx_ring));
+}
+
+static inline void trx_tx_notify(void)
 {
-	trx.backspaces++;
+	if (g_atomic_int_compare_and_exchange(&tx_pending, 0, 1))
+		g_main_context_wakeup(NULL);
+}
+
+static guint tx_bump_epoch(void)
+{
+	guint s, n;
+
+	do {
+		s = g_atomic_int_get(&tx_state);
+		n = s + (1 << TX_EPOCH_SHIFT);
+	} while (!g_atomic_int_compare_and_exchange(&tx_state, s, n));
+
+	return n;
 }
 
 /*
- * Check if 'str' contains any space characters or the RX_CMD character.
+ * Count a character of the ring as taken, unless it has been taken
+ * back. Called by the TX thread only.
  */
-static gboolean check_for_spaces(gchar *str)
+static gboolean tx_take(guint data)
 {
-	gunichar chr;
+	guint s, n;
 
-	while (*str) {
-		chr = g_utf8_get_char(str);
+	do {
+		s = g_atomic_int_get(&tx_state);
 
-		if (g_unichar_isspace(chr) || chr == TRX_RX_CMD)
-			return TRUE;
+		if ((data >> TX_EPOCH_SHIFT) != (s >> TX_EPOCH_SHIFT))
+			return FALSE;
 
-		str = g_utf8_next_char(str);
-	}
+		n = (s & ~TX_SENT_MASK) | ((s + 1) & TX_SENT_MASK);
+	} while (!g_atomic_int_compare_and_exchange(&tx_state, s, n));
 
-	return FALSE;
+	return TRUE;
 }
 
-gunichar trx_get_hell_tx_char(void)
+static void tx_queue_start(void)
 {
-	GtkEditable *editable;
-	gunichar chr;
-	gchar *str;
-	gint pos;
-	gboolean spc;
+	tx_queue_flush();
+	g_atomic_int_set(&tx_active, 1);
+}
 
-	gdk_threads_enter();
+/*
+ * What is left in the ring is not lost, the GUI gets it back as
+ * unsent text.
+ */
+static void tx_queue_stop(void)
+{
+	g_atomic_int_set(&tx_active, 0);
+	tx_bump_epoch();
+	trx_tx_notify();
+}
 
-	editable = GTK_EDITABLE(lookup_widget(appwindow, "txentry"));
-	str = gtk_editable_get_chars(editable, 0, -1);
+gboolean trx_tx_pending(void)
+{
+	return g_atomic_int_get(&tx_pending) != 0;
+}
 
-	chr = g_utf8_get_char(str);
-	spc = check_for_spaces(str);
+void trx_tx_ack(void)
+{
+	g_atomic_int_compare_and_exchange(&tx_pending, 1, 0);
+}
 
-	g_free(str);
+/*
+ * How many characters the GUI should queue now.
+ */
+gint trx_tx_wanted(void)
+{
+	gint n;
 
-	/*
-	 * If there are no spaces in the text, then send idle.
-	 */
-	if ((chr == 0) || (spc == FALSE && trx.state == TRX_STATE_TX)) {
-		gdk_threads_leave();
-		return -1;
-	}
+	if (!g_atomic_int_get(&tx_active))
+		return 0;
 
-	/*
-	 * Delete the first character and move cursor one step
-	 * backwards.
-	 */
-	pos = gtk_editable_get_position(editable);
-	gtk_editable_delete_text(editable, 0, 1);
-	gtk_editable_set_position(editable, pos - 1);
-
-	if (chr == TRX_RX_CMD) {
-		push_button("rxbutton");
-		chr = -1;
-	}
+	n = TX_QUEUE_DEPTH - (gint) ringbuf_read_space(tx_ring);
 
-	gdk_threads_leave();
+	return MAX(n, 0);
+}
 
-	return chr;
+/*
+ * The GUI tells how much text it has left to queue after the ring,
+ * the transmitter does not stop on an empty ring while there is some.
+ */
+void trx_tx_set_backlog(gint n)
+{
+	g_atomic_int_set(&tx_backlog, n);
 }
 
-gunichar trx_get_normal_tx_char(void)
+guint trx_tx_state(void)
 {
-	GtkTextView *view;
-	GtkTextBuffer *buffer;
-	GtkTextIter iter1, iter2;
-	GtkTextMark *mark1, *mark2;
-	gunichar chr;
+	return g_atomic_int_get(&tx_state);
+}
 
-	gdk_threads_enter();
+/*
+ * Take back the characters not yet sent. Returns the state after, its
+ * count includes every character that will ever be sent of the ones
+ * queued so far.
+ */
+guint trx_tx_retract(void)
+{
+	guint s;
 
-	view = GTK_TEXT_VIEW(lookup_widget(appwindow, "txtext"));
-	buffer = gtk_text_view_get_buffer(view);
+	s = tx_bump_epoch();
+	trx_tx_notify();
 
-	/* get the iterator at TX mark */
-	mark1 = gtk_text_buffer_get_mark(buffer, "editablemark");
-	gtk_text_buffer_get_iter_at_mark(buffer, &iter1, mark1);
+	return s;
+}
 
-	/* get the iterator at the insert mark */
-	mark2 = gtk_text_buffer_get_insert(buffer);
-	gtk_text_buffer_get_iter_at_mark(buffer, &iter2, mark2);
+/*
+ * Queue a character of the epoch the GUI last saw. If the epoch has
+ * changed since, the character is skipped.
+ */
+void trx_put_tx_char(gunichar c, guint epoch)
+{
+	guint data;
 
-	if (gtk_text_iter_equal(&iter1, &iter2)) {
-		gdk_threads_leave();
-		return -1;
-	}
+	data = (c & TX_SENT_MASK) | (epoch << TX_EPOCH_SHIFT);
 
-	chr = gtk_text_iter_get_char(&iter1);
+	g_return_if_fail(tx_ring);
+	ringbuf_write(tx_ring, &data, 1);
+}
 
-	if (chr == 0) {
-		gdk_threads_leave();
-		return -1;
-	}
+/*
+ * Backspace over text that is already on air. It goes out ahead of
+ * anything queued.
+ */
+void trx_queue_backspace(void)
+{
+	g_atomic_int_inc(&trx.backspaces);
+	trx_tx_notify();
+}
+
+static gboolean rx_cmd_idle_func(gpointer data)
+{
+	gdk_threads_enter();
+	push_button("rxbutton");
+	gdk_threads_leave();
 
-	gtk_text_iter_forward_char(&iter1);
-	gtk_text_buffer_get_start_iter(buffer, &iter2);
-	gtk_text_buffer_apply_tag_by_name(buffer, "editabletag",
-					  &iter2, &iter1);
-	gtk_text_buffer_move_mark_by_name(buffer, "editablemark", &iter1);
+	return FALSE;
+}
+
+static gint tx_queue_get(void)
+{
+	guint data;
+	gint c = -1;
+
+	g_return_val_if_fail(tx_ring, -1);
 
-	if (chr == TRX_RX_CMD) {
-		push_button("rxbutton");
-		chr = -1;
+	while (ringbuf_read(tx_ring, &data, 1)) {
+		if (tx_take(data)) {
+			c = data & TX_SENT_MASK;
+			break;
+		}
 	}
 
-	gdk_threads_leave();
+	/* the GUI moves its TX mark and refills the ring */
+	trx_tx_notify();
+
+	if (c == TRX_RX_CMD) {
+		g_idle_add(rx_cmd_idle_func, NULL);
+		c = -1;
+	}
 
-	return chr;
+	return c;
 }
 
 gunichar trx_get_tx_char(void)
@@ -796,7 +1325,7 @@ gunichar trx_get_tx_char(void)
 	gchar *fb = ".";
 
 	if (trx.mode == MODE_FELDHELL || trx.mode == MODE_FMHELL)
-		return trx_get_hell_tx_char();
+		return tx_queue_get();
 
 	if (trx.txstr && trx.txptr && *trx.txptr)
 		return *trx.txptr++;
@@ -805,12 +1334,12 @@ gunichar trx_get_tx_char(void)
 	trx.txptr = NULL;
 	trx.txstr = NULL;
 
-	if (trx.backspaces > 0) {
-		trx.backspaces--;
+	if (g_atomic_int_get(&trx.backspaces) > 0) {
+		g_atomic_int_add(&trx.backspaces, -1);
 		return 8;
 	}
 
-	chr = trx_get_normal_tx_char();
+	chr = tx_queue_get();
 
 	if (chr == -1 || 0xFFFC)
 		return chr;
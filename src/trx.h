@@ -89,9 +89,9 @@ struct trx {
 	gfloat syncpos;
 	gfloat txoffset;
 
-	gint backspaces;
 	guchar *txstr;
 	guchar *txptr;
+	gint backspaces;
 
 	gfloat outbuf[OUTBUFSIZE];
 
@@ -148,7 +148,13 @@ struct trx {
 
 extern gint trx_init(void);
 
+extern void trx_modem_defaults(struct trx *t, trx_mode_t mode);
+extern gint trx_mode_from_name(const gchar *name);
+extern gint trx_modem_init(struct trx *t);
+extern void trx_copy_parms(struct trx *t);
+
 extern void trx_set_mode(trx_mode_t);
+extern void trx_switch_mode(trx_mode_t);
 extern trx_mode_t trx_get_mode(void);
 extern char *trx_get_mode_name(void);
 
@@ -198,27 +204,54 @@ extern void trx_set_highlight(gboolean highlight);
 
 extern gint trx_get_samplerate(void);
 
+extern void trx_get_capture_stats(gint *fill, gint *highwater, gint *overruns);
+
 /* ---------------------------------------------------------------------- */
 
 extern void trx_init_queues(void);
 
+extern gboolean trx_rx_pending(void);
+extern void trx_rx_ack(void);
+
 extern void trx_put_echo_char(guint c);
 extern gint trx_get_echo_char(void);
+extern gint trx_get_echo_chars(guint *buf, gint len);
 
 extern void trx_put_rx_char(guint c);
 extern gint trx_get_rx_char(void);
+extern gint trx_get_rx_chars(guint *buf, gint len);
 
 extern void trx_put_rx_data(guint c);
+extern void trx_put_rx_data_block(const guchar *data, gint len);
 extern gint trx_get_rx_data(void);
+extern gint trx_get_rx_data_block(guchar *buf, gint len);
 
 extern void trx_put_rx_picdata(guint c);
+extern void trx_put_rx_picdata_block(const guint *data, gint len);
 extern gint trx_get_rx_picdata(void);
+extern gint trx_get_rx_picdata_block(guint *buf, gint len);
 
 extern void trx_put_tx_picture(gpointer picbuf);
 extern gpointer trx_get_tx_picture(void);
 
 /* ---------------------------------------------------------------------- */
 
+/*
+ * trx_tx_state() and trx_tx_retract() return the count of characters
+ * the modem has taken from the TX queue and the queue epoch, packed.
+ */
+#define	TRX_TX_SENT(s)		((s) & 0xFFFFFF)
+#define	TRX_TX_EPOCH(s)		((s) >> 24)
+
+extern gboolean trx_tx_pending(void);
+extern void trx_tx_ack(void);
+extern gint trx_tx_wanted(void);
+extern void trx_tx_set_backlog(gint n);
+
+extern guint trx_tx_state(void);
+extern guint trx_tx_retract(void);
+
+extern void trx_put_tx_char(gunichar c, guint epoch);
 extern void trx_queue_backspace(void);
 extern gunichar trx_get_tx_char(void);
 
@@ -29,6 +29,7 @@
 #include <gtk/gtkgc.h>
 #include <gtk/gtkmain.h>
 #include <gtk/gtksignal.h>
+#include <stdlib.h>
 #include <math.h>
 
 #include <stdio.h>
@@ -39,8 +40,6 @@
 #define gettext_noop(String) String
 #define N_(String) gettext_noop (String)
 
-#define fftw_new(type, n)	((type *) fftw_malloc(sizeof(type) * (n)))
-
 #define	RULER_HEIGHT	20
 
 static void waterfall_class_init(WaterfallClass *klass);
@@ -59,7 +58,7 @@ static void waterfall_send_configure (Waterfall *wf);
 static void set_idle_callback(Waterfall *wf);
 static gint idle_callback(gpointer data);
 
-static void setwindow(gdouble *window, gint len, wf_window_t type);
+static void setwindow(gfloat *window, gint len, wf_window_t type);
 static void calculate_frequencies(Waterfall *wf);
 
 /* ---------------------------------------------------------------------- */
@@ -234,32 +233,22 @@ static void waterfall_init(Waterfall *wf)
 	wf->ruler_ref_f = 0.0;
 	wf->ruler_ref_x = 0;
 
-	wf->fft_plan = fftw_create_plan(wf->fftlen,
-					FFTW_FORWARD,
-					FFTW_MEASURE | \
-					FFTW_OUT_OF_PLACE | \
-					FFTW_USE_WISDOM);
+	/* the input is real so a half length FFT does */
+	wf->fft = fftf_init(wf->fftlen / 2);
 
 	wf->specbuf = g_new(gdouble, WATERFALL_FFTLEN_MAX);
 	wf->peakbuf = g_new(gdouble, WATERFALL_FFTLEN_MAX);
 
-	wf->fft_ibuf = fftw_new(fftw_complex, WATERFALL_FFTLEN_MAX);
-	wf->fft_obuf = fftw_new(fftw_complex, WATERFALL_FFTLEN_MAX);
+	wf->fft_obuf = fftf_malloc(WATERFALL_FFTLEN_MAX / 2);
 
-	wf->fft_window = g_new(gdouble, WATERFALL_FFTLEN_MAX);
+	wf->fft_window = g_new(gfloat, WATERFALL_FFTLEN_MAX);
 
-	wf->inbuf = g_new(gdouble, WATERFALL_FFTLEN_MAX);
+	wf->inbuf = g_new(gfloat, WATERFALL_FFTLEN_MAX);
 
 	for (i = 0; i < WATERFALL_FFTLEN_MAX; i++) {
 		wf->specbuf[i] = -1.0;
 		wf->peakbuf[i] = -1.0;
 
-		c_re(wf->fft_ibuf[i]) = 0.0;
-		c_im(wf->fft_ibuf[i]) = 0.0;
-
-		c_re(wf->fft_obuf[i]) = 0.0;
-		c_im(wf->fft_obuf[i]) = 0.0;
-
 		wf->inbuf[i] = 0.0;
 	}
 	wf->inptr = 0;
@@ -457,17 +446,14 @@ static void waterfall_unrealize(GtkWidget *widget)
 	wf->specbuf = NULL;
 	wf->peakbuf = NULL;
 
-	fftw_free(wf->fft_ibuf);
-	fftw_free(wf->fft_obuf);
-	wf->fft_ibuf = NULL;
+	free(wf->fft_obuf);
 	wf->fft_obuf = NULL;
 
 	g_free(wf->inbuf);
 	wf->inbuf = NULL;
 
-	if (wf->fft_plan)
-		fftw_destroy_plan(wf->fft_plan);
-	wf->fft_plan = NULL;
+	fftf_free(wf->fft);
+	wf->fft = NULL;
 
 	if (wf->ruler_cursor)
 		gdk_cursor_unref(wf->ruler_cursor);
@@ -1108,7 +1094,7 @@ static gint idle_callback(gpointer data)
 /* ---------------------------------------------------------------------- */
 
 
-#define	cabs(z)		(sqrt(c_re(z) * c_re(z) + c_im(z) * c_im(z)))
+#define	cabs(z)		(sqrt((z).re * (z).re + (z).im * (z).im))
 
 static void setdata(Waterfall *wf)
 {
@@ -1117,12 +1103,7 @@ static void setdata(Waterfall *wf)
 	gfloat avgsig, avgsig0, avgsig1, avgsig3, avgsig4;
 	guchar *ptr;
 
-	for (i = 0; i < wf->fftlen; i++) {
-		c_re(wf->fft_ibuf[i]) = wf->inbuf[i] * wf->fft_window[i];
-		c_im(wf->fft_ibuf[i]) = 0.0;
-	}
-
-	fftw_one(wf->fft_plan, wf->fft_ibuf, wf->fft_obuf);
+	fftf_run_real(wf->fft, wf->inbuf, wf->fft_window, wf->fft_obuf);
 
 	width = wf->fftlen / 2;
 	size = wf->pixbufsize / 2;
@@ -1148,7 +1129,7 @@ static void setdata(Waterfall *wf)
 	}
 
 	for (i = 0; i < width; i++) {
-		fftw_complex z;
+		fcomplex z;
 		gdouble x;
 
 		z = wf->fft_obuf[i];
@@ -1176,7 +1157,7 @@ void waterfall_set_data(Waterfall *wf, gfloat *data, int len)
 	if (wf->paused == TRUE)
 		return;
 
-	g_return_if_fail(wf->fft_plan);
+	g_return_if_fail(wf->fft);
 
 	widget = GTK_WIDGET(wf);
 
@@ -1211,7 +1192,7 @@ static inline double hamming(double x)
 	return 0.54 - 0.46 * cos(2.0 * M_PI * x);
 }
 
-static void setwindow(gdouble *window, gint len, wf_window_t type)
+static void setwindow(gfloat *window, gint len, wf_window_t type)
 {
 	gdouble pwr = 0.0;
 	gint i;
@@ -1412,24 +1393,12 @@ void waterfall_set_magnification(Waterfall *wf, wf_mag_t mag)
 
 	alloc_pixbuf(wf, TRUE);
 
-	if (wf->fft_plan)
-		fftw_destroy_plan(wf->fft_plan);
-
-	wf->fft_plan = fftw_create_plan(wf->fftlen,
-					FFTW_FORWARD,
-					FFTW_ESTIMATE | \
-					FFTW_OUT_OF_PLACE | \
-					FFTW_USE_WISDOM);
+	fftf_free(wf->fft);
+	wf->fft = fftf_init(wf->fftlen / 2);
 
 	setwindow(wf->fft_window, wf->fftlen, WATERFALL_WINDOW_TRIA);
 
 	for (i = 0; i < WATERFALL_FFTLEN_MAX; i++) {
-		c_re(wf->fft_ibuf[i]) = 0.0;
-		c_im(wf->fft_ibuf[i]) = 0.0;
-
-		c_re(wf->fft_obuf[i]) = 0.0;
-		c_im(wf->fft_obuf[i]) = 0.0;
-
 		wf->specbuf[i] = -1.0;
 		wf->peakbuf[i] = -1.0;
 
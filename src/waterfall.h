@@ -30,12 +30,7 @@
 #include <gdk/gdk.h>
 #include <gtk/gtkwidget.h>
 
-#ifdef HAVE_DFFTW_H
-#  include <dfftw.h>
-#endif
-#ifdef HAVE_FFTW_H
-#  include <fftw.h>
-#endif
+#include "fftf.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -145,16 +140,15 @@ struct _Waterfall
 	guchar *pixbuf;
 	guchar *pixptr;
 
-	gdouble *inbuf;
+	gfloat *inbuf;
 	gint inptr;
 
 	gint fftlen;
-	gdouble *fft_window;
+	gfloat *fft_window;
 
-	fftw_complex *fft_ibuf;
-	fftw_complex *fft_obuf;
+	fcomplex *fft_obuf;
 
-	fftw_plan fft_plan;
+	struct fftf *fft;
 
 	gdouble *specbuf;
 	gdouble *peakbuf;